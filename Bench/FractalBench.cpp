@@ -0,0 +1,451 @@
+/*
+  ==============================================================================
+
+    FractalBench.cpp
+    Created: 20 Oct 2026 9:36:12am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+/*
+    Times the kernels and whole-frame renders over a matrix of views, sizes
+    and iteration limits and prints the results as JSON, so two commits can
+    be compared by diffing or plotting their output. Run with --help for the
+    options.
+
+    Iterations are counted from the loop counts the kernels report, which is
+    what the plain loop would have run. Shortcuts such as the interior checks
+    therefore show up as a higher iterations/s, which is the point.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Buddhabrot.h"
+#include "EscapeTime.h"
+#include "FrameRenderer.h"
+#include "IterationBuffer.h"
+#include "Palette.h"
+#include "Perturbation.h"
+#include "Symmetry.h"
+
+namespace
+{
+    struct View
+    {
+        const char* name;
+        FractalType type;
+        double centreX, centreY, zoom;
+        double cRe, cIm;
+    };
+
+    const View views[] =
+    {
+        { "full-set",       FractalType::mandelbrot, -0.5,     0.0,    1.0,    0.0,  0.0 },
+        { "seahorse",       FractalType::mandelbrot, -0.7436,  0.1318, 200.0,  0.0,  0.0 },
+        { "deep-interior",  FractalType::mandelbrot, -0.1,     0.1,    40.0,   0.0,  0.0 },
+        { "julia-dendrite", FractalType::julia,       0.0,     0.0,    1.0,   -0.8,  0.156 },
+    };
+
+    struct Size { int width, height; };
+
+    const char* getSimdLevelName (const SimdLevel level) {
+        switch (level)
+        {
+            case SimdLevel::sse2:   return "sse2";
+            case SimdLevel::avx2:   return "avx2";
+            case SimdLevel::avx512: return "avx512";
+            default:                return "scalar";
+        }
+    }
+
+    const char* getPrecisionName (const Precision precision) {
+        switch (precision)
+        {
+            case Precision::float32:      return "float";
+            case Precision::doubleDouble: return "double-double";
+            case Precision::perturbation: return "perturbation";
+            default:                      return "double";
+        }
+    }
+
+    std::string getFormulaName (const Formula& formula) {
+        switch (formula.variant)
+        {
+            case FormulaVariant::tricorn:     return "tricorn-" + std::to_string (formula.power);
+            case FormulaVariant::burningShip: return "burning-ship-" + std::to_string (formula.power);
+            default:                          return "power-" + std::to_string (formula.power);
+        }
+    }
+
+    void setPrecision (FractalParams& params, const Precision precision) {
+        params.precision = precision;
+        params.reference = precision == Precision::perturbation
+                         ? std::make_shared<const ReferenceOrbit> (params, FixedPoint (params.centreX), FixedPoint (params.centreY))
+                         : nullptr;
+    }
+
+    FractalParams makeParams (const View& view, const Size& size, const int maxIterations,
+                              const std::optional<Precision> forcedPrecision) {
+        FractalParams params;
+        params.type = view.type;
+        params.cRe = view.cRe;
+        params.cIm = view.cIm;
+        params.centreX = view.centreX;
+        params.centreY = view.centreY;
+        params.width = size.width;
+        params.height = size.height;
+        params.maxIterations = maxIterations;
+        params.fitToSpan (4.0 / view.zoom);
+        setPrecision (params, forcedPrecision.value_or (choosePrecision (params, true)));
+        return params;
+    }
+
+    double countIterations (const IterationBuffer& iterations, const int minIterations) {
+        double total = 0;
+        for (auto count : iterations.getAllCounts())
+            total += count - minIterations;
+        return total;
+    }
+
+    // Best of a few runs, which is the least disturbed by everything else on the machine
+    template <typename Function>
+    double timeBestOf (const int numRuns, Function&& function) {
+        double best = 1.0e30;
+        for (int run = 0; run < numRuns; run++)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            function();
+            best = std::min (best, std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count());
+        }
+        return best;
+    }
+
+    class JsonResults
+    {
+    public:
+        void add (const char* benchmark, const std::string& variant, const FractalParams& params,
+                  const char* viewName, const int numThreads, const double seconds,
+                  const double iterations, const double speedup)
+        {
+            const double pixels = static_cast<double> (params.width) * params.height;
+            char entry[704];
+            std::snprintf (entry, sizeof (entry),
+                           "    { \"benchmark\": \"%s\", \"variant\": \"%s\", \"view\": \"%s\", "
+                           "\"precision\": \"%s\", "
+                           "\"width\": %d, \"height\": %d, \"maxIterations\": %d, \"threads\": %d, "
+                           "\"seconds\": %.6f, \"mpixelsPerSecond\": %.3f, \"iterationsPerSecond\": %.4e, "
+                           "\"speedup\": %.3f }",
+                           benchmark, variant.c_str(), viewName, getPrecisionName (params.precision),
+                           params.width, params.height,
+                           params.maxIterations, numThreads, seconds, pixels / seconds * 1.0e-6,
+                           iterations / seconds, speedup);
+            m_entries.emplace_back (entry);
+
+            std::fprintf (stderr, "%-12s %-12s %-15s %5dx%-5d %6d iters %3d threads %9.2f ms %9.2f Mpix/s\n",
+                          benchmark, variant.c_str(), viewName, params.width, params.height,
+                          params.maxIterations, numThreads, seconds * 1000.0, pixels / seconds * 1.0e-6);
+        }
+
+        void addOrbit (const int numOrbits, const int maxSteps, const double seconds)
+        {
+            char entry[256];
+            std::snprintf (entry, sizeof (entry),
+                           "    { \"benchmark\": \"orbit\", \"variant\": \"scalar\", \"orbits\": %d, "
+                           "\"maxSteps\": %d, \"seconds\": %.6f, \"orbitsPerSecond\": %.4e }",
+                           numOrbits, maxSteps, seconds, numOrbits / seconds);
+            m_entries.emplace_back (entry);
+            std::fprintf (stderr, "orbit        %d orbits of up to %d steps %9.2f ms\n", numOrbits, maxSteps, seconds * 1000.0);
+        }
+
+        void addDensity (const char* variant, const FractalParams& params, const int numThreads,
+                         const double numSamples, const double seconds, const double speedup)
+        {
+            char entry[512];
+            std::snprintf (entry, sizeof (entry),
+                           "    { \"benchmark\": \"density\", \"variant\": \"%s\", \"width\": %d, \"height\": %d, "
+                           "\"maxIterations\": %d, \"threads\": %d, \"samples\": %.0f, \"seconds\": %.6f, "
+                           "\"samplesPerSecond\": %.4e, \"speedup\": %.3f }",
+                           variant, params.width, params.height, params.maxIterations, numThreads,
+                           numSamples, seconds, numSamples / seconds, speedup);
+            m_entries.emplace_back (entry);
+            std::fprintf (stderr, "%-12s %-15s %5dx%-5d %6d iters %3d threads %9.2f ms %9.3g orbits/s\n", "density", variant,
+                          params.width, params.height, params.maxIterations, numThreads, seconds * 1000.0, numSamples / seconds);
+        }
+
+        std::string toString (const std::string& label) const
+        {
+            std::string json = "{\n";
+            json += "  \"label\": \"" + label + "\",\n";
+            json += "  \"simdLevel\": \"" + std::string (getSimdLevelName (getSimdLevel())) + "\",\n";
+            json += "  \"hardwareThreads\": " + std::to_string (std::thread::hardware_concurrency()) + ",\n";
+            json += "  \"results\": [\n";
+            for (size_t i = 0; i < m_entries.size(); i++)
+                json += m_entries[i] + (i + 1 < m_entries.size() ? ",\n" : "\n");
+            json += "  ]\n}\n";
+            return json;
+        }
+
+    private:
+        std::vector<std::string> m_entries;
+    };
+
+    void printUsage() {
+        std::puts ("usage: fractal-bench [options]\n"
+                   "\n"
+                   "  -o, --output FILE   write the JSON here instead of stdout\n"
+                   "  --label TEXT        stored in the JSON, e.g. a commit hash\n"
+                   "  --runs N            runs per case, the best is kept (3)\n"
+                   "  --precision TIER    float, double, double-double or perturbation for every\n"
+                   "                      case instead of the one each view would pick\n"
+                   "  --quick             one small size and limit, for a smoke test");
+    }
+}
+
+int main (int argc, char* argv[]) {
+    std::string outputPath, label;
+    int numRuns = 3;
+    bool isQuick = false;
+    std::optional<Precision> forcedPrecision;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        } else if ((arg == "-o" || arg == "--output") && hasValue) {
+            outputPath = argv[++i];
+        } else if (arg == "--label" && hasValue) {
+            label = argv[++i];
+        } else if (arg == "--runs" && hasValue) {
+            numRuns = std::max (1, std::atoi (argv[++i]));
+        } else if (arg == "--quick") {
+            isQuick = true;
+        } else if (arg == "--precision" && hasValue) {
+            const char* value = argv[++i];
+            if (std::strcmp (value, "float") == 0) forcedPrecision = Precision::float32;
+            else if (std::strcmp (value, "double") == 0) forcedPrecision = Precision::float64;
+            else if (std::strcmp (value, "double-double") == 0) forcedPrecision = Precision::doubleDouble;
+            else if (std::strcmp (value, "perturbation") == 0) forcedPrecision = Precision::perturbation;
+            else {
+                std::fprintf (stderr, "fractal-bench: bad precision %s\n", value);
+                return 2;
+            }
+        } else {
+            std::fprintf (stderr, "fractal-bench: bad option %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    const std::vector<Size> sizes = isQuick ? std::vector<Size> { { 320, 240 } }
+                                            : std::vector<Size> { { 640, 480 }, { 1280, 720 } };
+    const std::vector<int> iterationLimits = isQuick ? std::vector<int> { 256 }
+                                                     : std::vector<int> { 256, 2048 };
+
+    const int hardwareThreads = std::max (1, static_cast<int> (std::thread::hardware_concurrency()));
+    std::vector<int> threadCounts;
+    for (int numThreads = 1; numThreads < hardwareThreads; numThreads *= 2)
+        threadCounts.push_back (numThreads);
+    threadCounts.push_back (hardwareThreads);
+
+    JsonResults results;
+
+    for (const auto& view : views)
+    {
+        for (const auto& size : sizes)
+        {
+            for (const int maxIterations : iterationLimits)
+            {
+                const auto params = makeParams (view, size, maxIterations, forcedPrecision);
+                IterationBuffer iterations (params.width, params.height);
+
+                // Each precision tier on one thread, against double. Only on
+                // the smallest size, as double-double is several times slower.
+                if (&size == &sizes.front())
+                {
+                    double doubleSeconds = 0;
+                    for (const auto precision : { Precision::float64, Precision::float32,
+                                                  Precision::doubleDouble, Precision::perturbation })
+                    {
+                        auto tierParams = params;
+                        setPrecision (tierParams, precision);
+                        FrameOptions options;
+                        options.numThreads = 1;
+                        options.useSymmetry = false;
+
+                        const double seconds = timeBestOf (numRuns, [&] { renderFrame (tierParams, iterations, options); });
+                        if (precision == Precision::float64)
+                            doubleSeconds = seconds;
+
+                        results.add ("precision", getPrecisionName (precision), tierParams, view.name, 1, seconds,
+                                     countIterations (iterations, params.minIterations), doubleSeconds / seconds);
+                    }
+                }
+
+                // Each kernel on one thread
+                double scalarSeconds = 0;
+                for (int level = 0; level <= static_cast<int> (getSimdLevel()); level++)
+                {
+                    FrameOptions options;
+                    options.numThreads = 1;
+                    options.simdLevel = static_cast<SimdLevel> (level);
+                    options.useSymmetry = false;
+
+                    const double seconds = timeBestOf (numRuns, [&] { renderFrame (params, iterations, options); });
+                    if (level == 0)
+                        scalarSeconds = seconds;
+
+                    results.add ("kernel", getSimdLevelName (options.simdLevel), params, view.name, 1, seconds,
+                                 countIterations (iterations, params.minIterations), scalarSeconds / seconds);
+                }
+
+                // The templated formula kernels, scalar against the best SIMD level, on one thread
+                if (&size == &sizes.front())
+                {
+                    for (const auto& formula : { Formula { 3, FormulaVariant::standard }, Formula { 4, FormulaVariant::standard },
+                                                 Formula { 2, FormulaVariant::tricorn }, Formula { 2, FormulaVariant::burningShip } })
+                    {
+                        auto formulaParams = params;
+                        formulaParams.formula = formula;
+                        setPrecision (formulaParams, forcedPrecision.value_or (choosePrecision (formulaParams, true)));
+
+                        FrameOptions options;
+                        options.numThreads = 1;
+                        options.useSymmetry = false;
+                        options.simdLevel = SimdLevel::scalar;
+                        const double formulaScalarSeconds = timeBestOf (numRuns, [&] { renderFrame (formulaParams, iterations, options); });
+
+                        options.simdLevel = getSimdLevel();
+                        const double seconds = timeBestOf (numRuns, [&] { renderFrame (formulaParams, iterations, options); });
+                        results.add ("formula", getFormulaName (formula) + "/" + getSimdLevelName (options.simdLevel),
+                                     formulaParams, view.name, 1, seconds,
+                                     countIterations (iterations, params.minIterations), formulaScalarSeconds / seconds);
+                    }
+                }
+
+                // Scaling of the best kernel with threads
+                double oneThreadSeconds = 0;
+                for (const int numThreads : threadCounts)
+                {
+                    FrameOptions options;
+                    options.numThreads = numThreads;
+                    options.useSymmetry = false;
+
+                    const double seconds = timeBestOf (numRuns, [&] { renderFrame (params, iterations, options); });
+                    if (numThreads == 1)
+                        oneThreadSeconds = seconds;
+
+                    results.add ("threaded", getSimdLevelName (options.simdLevel), params, view.name, numThreads,
+                                 seconds, countIterations (iterations, params.minIterations), oneThreadSeconds / seconds);
+                }
+
+                // Subdivision against the per-pixel render, both on every thread
+                {
+                    FrameOptions options;
+                    options.numThreads = hardwareThreads;
+                    const double perPixelSeconds = timeBestOf (numRuns, [&] { renderFrame (params, iterations, options); });
+
+                    options.subdivide = true;
+                    const double seconds = timeBestOf (numRuns, [&] { renderFrame (params, iterations, options); });
+                    results.add ("subdivision", "mariani-silver", params, view.name, hardwareThreads, seconds,
+                                 countIterations (iterations, params.minIterations), perPixelSeconds / seconds);
+                }
+
+                // Mirroring against iterating the whole frame, both on every thread
+                {
+                    FrameOptions options;
+                    options.numThreads = hardwareThreads;
+                    options.useSymmetry = false;
+                    const double fullSeconds = timeBestOf (numRuns, [&] { renderFrame (params, iterations, options); });
+
+                    options.useSymmetry = true;
+                    const double seconds = timeBestOf (numRuns, [&] { renderFrame (params, iterations, options); });
+                    results.add ("symmetry", planSymmetry (params).isSymmetric() ? "mirrored" : "none", params,
+                                 view.name, hardwareThreads, seconds,
+                                 countIterations (iterations, params.minIterations), fullSeconds / seconds);
+                }
+
+                // What a redraw costs: iterate, build the palette and colour every pixel
+                {
+                    FrameOptions options;
+                    options.numThreads = hardwareThreads;
+                    Palette palette;
+                    std::vector<uint32_t> pixels (static_cast<size_t> (params.width) * static_cast<size_t> (params.height));
+
+                    const double seconds = timeBestOf (numRuns, [&]
+                    {
+                        renderFrame (params, iterations, options);
+                        palette.build (params.minIterations, params.maxIterations, &iterations);
+                        palette.colourFrame (iterations, pixels.data());
+                    });
+                    results.add ("end-to-end", "classic", params, view.name, hardwareThreads, seconds,
+                                 countIterations (iterations, params.minIterations), 1.0);
+                }
+            }
+        }
+    }
+
+    // The orbit overlay is recomputed on every mouse drag
+    {
+        constexpr int numOrbits = 100000, maxSteps = 25;
+        volatile size_t numPoints = 0;
+        const double seconds = timeBestOf (numRuns, [&]
+        {
+            for (int i = 0; i < numOrbits; i++)
+                numPoints = numPoints + calcOrbit ({ -2.0 + 2.5 * i / numOrbits, 0.3 }, maxSteps).size();
+        });
+        results.addOrbit (numOrbits, maxSteps, seconds);
+    }
+
+    // Orbit density scaling with threads; each thread has its own histogram
+    {
+        const auto params = makeParams (views[0], sizes.front(), 256, std::nullopt);
+        const uint64_t numSamples = isQuick ? uint64_t { 1 } << 16 : uint64_t { 1 } << 20;
+
+        for (const bool anti : { false, true })
+        {
+            double oneThreadSeconds = 0;
+            for (const int numThreads : threadCounts)
+            {
+                BuddhabrotOptions options;
+                options.anti = anti;
+                options.numThreads = numThreads;
+                BuddhabrotSampler sampler (params, options);
+                sampler.sample (0);
+
+                const double seconds = timeBestOf (numRuns, [&] { sampler.sample (numSamples); });
+                if (numThreads == 1)
+                    oneThreadSeconds = seconds;
+
+                results.addDensity (anti ? "anti-buddhabrot" : "buddhabrot", params, numThreads,
+                                    static_cast<double> (numSamples), seconds, oneThreadSeconds / seconds);
+            }
+        }
+    }
+
+    const auto json = results.toString (label);
+
+    if (outputPath.empty()) {
+        std::fputs (json.c_str(), stdout);
+        return 0;
+    }
+
+    auto* file = std::fopen (outputPath.c_str(), "w");
+    if (file == nullptr || std::fputs (json.c_str(), file) < 0) {
+        std::fprintf (stderr, "fractal-bench: couldn't write %s\n", outputPath.c_str());
+        return 1;
+    }
+    std::fclose (file);
+    return 0;
+}
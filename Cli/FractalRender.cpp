@@ -0,0 +1,681 @@
+/*
+  ==============================================================================
+
+    FractalRender.cpp
+    Created: 19 Oct 2026 4:18:40pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+/*
+    Renders one Mandelbrot or Julia frame, or the orbit density of a view, to
+    a PNG without a window, using the same code as the app, or an animation
+    of Julia sets along a path of constants. Run with --help for the options.
+*/
+
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Antialiasing.h"
+#include "Buddhabrot.h"
+#include "DistributedRenderer.h"
+#include "EscapeTime.h"
+#include "FrameRenderer.h"
+#include "IterationBuffer.h"
+#include "IterationFile.h"
+#include "JuliaAnimation.h"
+#include "Palette.h"
+#include "Perturbation.h"
+#include "PngWriter.h"
+#include "PosterRenderer.h"
+#include "RenderStats.h"
+
+static void printUsage() {
+    std::puts ("usage: fractal-render [options] -o out.png\n"
+               "\n"
+               "  -o, --output FILE          PNG file to write\n"
+               "  --type TYPE                mandelbrot, julia, buddhabrot or anti-buddhabrot (mandelbrot)\n"
+               "  --size WxH                 image size in pixels (800x600)\n"
+               "  --centre X,Y               maths coordinate of the image centre, to any number of digits (0,0)\n"
+               "  --zoom Z                   magnification; 1 fits 4 units across the shorter side (1),\n"
+               "                             up to about 1e280 for deep zooms\n"
+               "  --c RE,IM                  Julia constant (0,0)\n"
+               "  --formula VARIANT          standard, tricorn or burning-ship (standard)\n"
+               "  --power N                  power z is raised to, 2 to 6 (2)\n"
+               "  --min-iterations N         first loop count (1)\n"
+               "  --max-iterations N         iteration limit (40)\n"
+               "  --colouring MODE           classic, smooth or histogram (classic)\n"
+               "  --cycle N                  palette cycle offset (0)\n"
+               "  --threads N                worker threads, 0 for one per core (0)\n"
+               "  --subdivide                Mariani-Silver subdivision\n"
+               "  --antialias N              N jittered samples, 4 to 64, across each pixel on an edge\n"
+               "  --edge-threshold N         counts further apart than N make neighbouring pixels an edge (2)\n"
+               "  --poster                   render in strips straight to the file, for sizes too big for\n"
+               "                             memory such as 32768x32768\n"
+               "  --workers N                iterate in N worker processes instead of threads, handing out\n"
+               "                             tiles again if a worker is slow or dies\n"
+               "  --worker-command CMD       start each worker with CMD through /bin/sh, such as\n"
+               "                             \"ssh host fractal-render --worker\" (this program with --worker)\n"
+               "  --tile-timeout S           seconds before a tile not back from its worker goes to another (60)\n"
+               "  --worker                   serve tiles to a coordinator on stdin and stdout, for --workers\n"
+               "  --checkpoint FILE          keep the iteration counts in FILE as tiles finish, carrying on\n"
+               "                             from where an earlier run stopped if FILE holds the same view;\n"
+               "                             -o is optional\n"
+               "  --open FILE                colour the iteration counts kept in FILE instead of rendering\n"
+               "  --path FILE                animate Julia sets along the constants in FILE, one per line as\n"
+               "                             RE,IM, such as a drag recorded with the app's p key\n"
+               "  --circle RE,IM,R           animate Julia sets once around a circle of constants\n"
+               "  --frames N                 frames to space evenly along the path (its own points for\n"
+               "                             --path, 120 for --circle)\n"
+               "  --fps N                    frame rate stored in a Y4M file (30)\n"
+               "                             An animation is written to -o as Y4M video, to stdout for -,\n"
+               "                             or as numbered PNGs for a name like frame-%05d.png\n"
+               "  --precision TIER           auto, float, double, double-double or perturbation (auto)\n"
+               "  --samples N                orbits to trace for the density types (1e7)\n"
+               "  --seed N                   random seed for the density types (1)\n"
+               "  --trace FILE               write a Chrome trace of the render's tiles and stages\n"
+               "  -q, --quiet                don't print timings");
+}
+
+static bool parsePair (const char* text, const char separator, double& first, double& second) {
+    char* end = nullptr;
+    first = std::strtod (text, &end);
+    if (end == text || *end != separator)
+        return false;
+
+    const char* rest = end + 1;
+    second = std::strtod (rest, &end);
+    return end != rest && *end == '\0';
+}
+
+// Deep zooms need the centre to more digits than a double holds, so the text is kept too
+static bool parseCentre (const char* text, FixedPoint& x, FixedPoint& y, std::string& xText, std::string& yText) {
+    const std::string pair (text);
+    const auto comma = pair.find (',');
+    if (comma == std::string::npos)
+        return false;
+
+    xText = pair.substr (0, comma);
+    yText = pair.substr (comma + 1);
+    return FixedPoint::parse (xText, x) && FixedPoint::parse (yText, y);
+}
+
+static bool parseCircle (const char* text, std::complex<double>& centre, double& radius) {
+    char* end = nullptr;
+    const double re = std::strtod (text, &end);
+    if (end == text || *end != ',')
+        return false;
+
+    double im = 0.0;
+    if (! parsePair (end + 1, ',', im, radius) || radius <= 0.0)
+        return false;
+    centre = { re, im };
+    return true;
+}
+
+static bool parseInt (const char* text, int& value) {
+    char* end = nullptr;
+    const long parsed = std::strtol (text, &end, 10);
+    if (end == text || *end != '\0')
+        return false;
+    value = static_cast<int> (parsed);
+    return true;
+}
+
+static int renderDensity (const FractalParams& params, BuddhabrotOptions options, const int numThreads,
+                          const uint64_t numSamples, const std::string& outputPath, const bool isQuiet) {
+    if (params.maxIterations > BuddhabrotSampler::maxIterationLimit) {
+        std::fprintf (stderr, "fractal-render: density images go up to %d iterations\n", BuddhabrotSampler::maxIterationLimit);
+        return 2;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    options.numThreads = numThreads;
+    BuddhabrotSampler sampler (params, options);
+    sampler.sample (numSamples);
+
+    const auto sampled = std::chrono::steady_clock::now();
+
+    std::vector<uint32_t> pixels (static_cast<size_t> (params.width) * static_cast<size_t> (params.height));
+    sampler.getDensity().colour (pixels.data());
+
+    if (! writePng (outputPath, params.width, params.height, pixels.data())) {
+        std::fprintf (stderr, "fractal-render: couldn't write %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    if (! isQuiet) {
+        const double seconds = std::chrono::duration<double> (sampled - start).count();
+        std::fprintf (stderr, "%s: %dx%d, %.3g orbits on %d threads in %.1f ms (%.3g orbits/s)\n", outputPath.c_str(),
+                      params.width, params.height, static_cast<double> (sampler.getDensity().numSamples),
+                      sampler.getNumThreads(), seconds * 1000.0, sampler.getDensity().numSamples / seconds);
+    }
+    return 0;
+}
+
+static int renderPosterFile (const FractalParams& params, const Palette& palette, const FrameOptions& frameOptions,
+                             const std::string& outputPath, const bool isQuiet) {
+    const auto start = std::chrono::steady_clock::now();
+
+    PosterOptions options;
+    options.numThreads = frameOptions.numThreads;
+    options.simdLevel = frameOptions.simdLevel;
+    int lastPercent = -1;
+    options.onProgress = [&] (const int rowsWritten) {
+        const int percent = static_cast<int> (100LL * rowsWritten / params.height);
+        if (! isQuiet && percent != lastPercent)
+            std::fprintf (stderr, "\r%s: %d%%", outputPath.c_str(), percent);
+        lastPercent = percent;
+        return true;
+    };
+
+    if (! renderPoster (params, palette, outputPath, options)) {
+        std::fprintf (stderr, "\nfractal-render: couldn't write %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    if (! isQuiet) {
+        const double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+        std::fprintf (stderr, "\r%s: %dx%d poster in %.1f s (%.3g pixels/s)\n", outputPath.c_str(),
+                      params.width, params.height, seconds,
+                      static_cast<double> (params.width) * params.height / seconds);
+    }
+    return 0;
+}
+
+static int renderAnimation (const FractalParams& params, const Palette& palette, const JuliaPath& path,
+                            AnimationOptions options, const std::string& outputPath, const bool isQuiet) {
+    const auto start = std::chrono::steady_clock::now();
+    const int numFrames = static_cast<int> (path.size());
+
+    options.onProgress = [&] (const int framesWritten) {
+        if (! isQuiet)
+            std::fprintf (stderr, "\r%s: frame %d of %d", outputPath.c_str(), framesWritten, numFrames);
+        return true;
+    };
+
+    if (! renderJuliaAnimation (params, palette, path, outputPath, options)) {
+        std::fprintf (stderr, "\nfractal-render: couldn't write %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    if (! isQuiet) {
+        const double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+        std::fprintf (stderr, "\r%s: %d frames of %dx%d in %.1f s (%.1f frames/s)\n", outputPath.c_str(),
+                      numFrames, params.width, params.height, seconds, numFrames / seconds);
+    }
+    return 0;
+}
+
+// Colours the file a band of rows at a time, so it is never all in memory
+static bool writeColouredPng (const IterationFile& file, Palette palette, const std::string& outputPath) {
+    const auto& params = file.getParams();
+    if (palette.needsWholeFrame())
+        palette.build (params.minIterations, params.maxIterations, file.getAllCounts(),
+                       static_cast<size_t> (params.width) * static_cast<size_t> (params.height));
+    else
+        palette.build (params.minIterations, params.maxIterations);
+
+    PngStreamWriter writer (outputPath, params.width, params.height);
+    if (! writer.isOpen())
+        return false;
+
+    constexpr int bandHeight = IterationFile::tileSize;
+    std::vector<uint32_t> pixels (static_cast<size_t> (params.width) * bandHeight);
+
+    for (int y = 0; y < params.height; y += bandHeight)
+    {
+        const int numRows = std::min (bandHeight, params.height - y);
+        file.colourRows (palette, y, numRows, pixels.data());
+        if (! writer.writeBand (PngStreamWriter::encodeBand (params.width, numRows, pixels.data(),
+                                                             y + numRows == params.height)))
+            return false;
+    }
+    return writer.finish();
+}
+
+static int colourIterationFile (const std::string& path, const Palette& palette, const std::string& outputPath,
+                                const bool isQuiet) {
+    const auto start = std::chrono::steady_clock::now();
+
+    const IterationFile file (path, false);
+    if (! file.isOpen()) {
+        std::fprintf (stderr, "fractal-render: %s isn't an iteration file\n", path.c_str());
+        return 1;
+    }
+
+    if (! writeColouredPng (file, palette, outputPath)) {
+        std::fprintf (stderr, "fractal-render: couldn't write %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    if (! isQuiet) {
+        const double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+        std::fprintf (stderr, "%s: %dx%d from %s, %d of %d tiles done, coloured in %.1f ms\n", outputPath.c_str(),
+                      file.getWidth(), file.getHeight(), path.c_str(), file.getNumTilesDone(), file.getNumTiles(),
+                      seconds * 1000.0);
+    }
+    return 0;
+}
+
+static int renderCheckpointed (const FractalParams& params, const Palette& palette, const FrameOptions& frameOptions,
+                               const std::string& checkpointPath, const std::string& centreXText,
+                               const std::string& centreYText, const std::string& outputPath, const bool isQuiet) {
+    const auto start = std::chrono::steady_clock::now();
+
+    auto file = std::make_unique<IterationFile> (checkpointPath, true);
+    if (file->isOpen() && ! file->matches (params)) {
+        std::fprintf (stderr, "fractal-render: %s holds a different view\n", checkpointPath.c_str());
+        return 2;
+    }
+
+    if (! file->isOpen()) {
+        // Only a file that isn't there is started again; anything else could be hours of someone's render
+        if (std::ifstream (checkpointPath).good()) {
+            std::fprintf (stderr, "fractal-render: %s isn't an iteration file\n", checkpointPath.c_str());
+            return 2;
+        }
+
+        file = std::make_unique<IterationFile> (checkpointPath, params, centreXText, centreYText);
+        if (! file->isOpen()) {
+            std::fprintf (stderr, "fractal-render: couldn't create %s\n", checkpointPath.c_str());
+            return 1;
+        }
+    }
+
+    const int numDamaged = file->unmarkDamagedTiles();
+    if (! isQuiet && numDamaged > 0)
+        std::fprintf (stderr, "%s: %d damaged tiles to iterate again\n", checkpointPath.c_str(), numDamaged);
+
+    const int numTiles = file->getNumTiles();
+    const int numAlreadyDone = file->getNumTilesDone();
+    if (! isQuiet && numAlreadyDone > 0)
+        std::fprintf (stderr, "%s: carrying on from %d of %d tiles\n", checkpointPath.c_str(), numAlreadyDone, numTiles);
+
+    int lastPercent = -1;
+    const bool isComplete = renderToFile (*file, params, frameOptions, [&] (const int numTilesDone) {
+        const int percent = static_cast<int> (100LL * numTilesDone / numTiles);
+        if (! isQuiet && percent != lastPercent)
+            std::fprintf (stderr, "\r%s: %d%%", checkpointPath.c_str(), percent);
+        lastPercent = percent;
+        return true;
+    });
+
+    if (! isComplete) {
+        std::fprintf (stderr, "\nfractal-render: couldn't write %s\n", checkpointPath.c_str());
+        return 1;
+    }
+
+    if (! isQuiet) {
+        const double seconds = std::chrono::duration<double> (std::chrono::steady_clock::now() - start).count();
+        std::fprintf (stderr, "\r%s: %dx%d, %d tiles iterated in %.1f s\n", checkpointPath.c_str(),
+                      params.width, params.height, numTiles - numAlreadyDone, seconds);
+    }
+
+    if (! outputPath.empty() && ! writeColouredPng (*file, palette, outputPath)) {
+        std::fprintf (stderr, "fractal-render: couldn't write %s\n", outputPath.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+int main (int argc, char* argv[]) {
+    FractalParams params;
+    params.width = 800;
+    params.height = 600;
+
+    double zoom = 1.0;
+    FixedPoint centreX, centreY;
+    std::string centreXText = "0", centreYText = "0";
+    std::string outputPath;
+    Palette palette;
+    int cycleOffset = 0;
+    FrameOptions options;
+    bool isQuiet = false;
+    bool choosesPrecision = true;
+    bool isDensity = false;
+    BuddhabrotOptions densityOptions;
+    double numSamples = 1.0e7;
+    std::string tracePath;
+    bool isPoster = false;
+    std::string checkpointPath, openPath;
+    std::string juliaPathFile;
+    std::complex<double> circleCentre;
+    double circleRadius = 0.0;
+    int numFrames = 0;
+    AnimationOptions animationOptions;
+    int samplesPerEdgePixel = 0;
+    int edgeThreshold = EdgeSamples::defaultThreshold;
+    DistributedOptions distributedOptions;
+    bool isDistributed = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        bool isValid = true;
+
+        auto takesValue = [&] { if (value == nullptr) isValid = false; else i++; return value != nullptr; };
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage();
+            return 0;
+        } else if (arg == DistributedOptions::workerArgument) {
+            // Everything about the frame comes from the coordinator
+            return runTileWorker (0, 1);
+        } else if (arg == "--workers") {
+            isValid = takesValue() && parseInt (value, distributedOptions.numWorkers) && distributedOptions.numWorkers >= 1;
+            isDistributed = true;
+        } else if (arg == "--worker-command") {
+            if (takesValue()) distributedOptions.workerCommand = value;
+        } else if (arg == "--tile-timeout") {
+            isValid = takesValue() && (distributedOptions.tileTimeoutSeconds = std::strtod (value, nullptr)) > 0;
+        } else if (arg == "-o" || arg == "--output") {
+            if (takesValue()) outputPath = value;
+        } else if (arg == "--type") {
+            if (takesValue()) {
+                if (std::strcmp (value, "mandelbrot") == 0) params.type = FractalType::mandelbrot;
+                else if (std::strcmp (value, "julia") == 0) params.type = FractalType::julia;
+                else if (std::strcmp (value, "buddhabrot") == 0) isDensity = true;
+                else if (std::strcmp (value, "anti-buddhabrot") == 0) isDensity = densityOptions.anti = true;
+                else isValid = false;
+            }
+        } else if (arg == "--size") {
+            double width = 0, height = 0;
+            isValid = takesValue() && parsePair (value, 'x', width, height) && width >= 1 && height >= 1;
+            params.width = static_cast<int> (width);
+            params.height = static_cast<int> (height);
+        } else if (arg == "--centre" || arg == "--center") {
+            isValid = takesValue() && parseCentre (value, centreX, centreY, centreXText, centreYText);
+        } else if (arg == "--zoom") {
+            isValid = takesValue() && (zoom = std::strtod (value, nullptr)) > 0;
+        } else if (arg == "--c") {
+            isValid = takesValue() && parsePair (value, ',', params.cRe, params.cIm);
+        } else if (arg == "--formula") {
+            if (takesValue()) {
+                if (std::strcmp (value, "standard") == 0) params.formula.variant = FormulaVariant::standard;
+                else if (std::strcmp (value, "tricorn") == 0) params.formula.variant = FormulaVariant::tricorn;
+                else if (std::strcmp (value, "burning-ship") == 0) params.formula.variant = FormulaVariant::burningShip;
+                else isValid = false;
+            }
+        } else if (arg == "--power") {
+            isValid = takesValue() && parseInt (value, params.formula.power)
+                   && params.formula.power >= Formula::minPower && params.formula.power <= Formula::maxPower;
+        } else if (arg == "--min-iterations") {
+            isValid = takesValue() && parseInt (value, params.minIterations) && params.minIterations >= 0;
+        } else if (arg == "--max-iterations") {
+            isValid = takesValue() && parseInt (value, params.maxIterations) && params.maxIterations >= 1;
+        } else if (arg == "--colouring" || arg == "--coloring") {
+            if (takesValue()) {
+                if (std::strcmp (value, "classic") == 0) palette.setMode (Palette::Mode::classic);
+                else if (std::strcmp (value, "smooth") == 0) palette.setMode (Palette::Mode::smooth);
+                else if (std::strcmp (value, "histogram") == 0) palette.setMode (Palette::Mode::histogram);
+                else isValid = false;
+            }
+        } else if (arg == "--cycle") {
+            isValid = takesValue() && parseInt (value, cycleOffset);
+        } else if (arg == "--threads") {
+            isValid = takesValue() && parseInt (value, options.numThreads) && options.numThreads >= 0;
+        } else if (arg == "--subdivide") {
+            options.subdivide = true;
+        } else if (arg == "--antialias") {
+            isValid = takesValue() && parseInt (value, samplesPerEdgePixel)
+                   && samplesPerEdgePixel >= 4 && samplesPerEdgePixel <= 64;
+        } else if (arg == "--edge-threshold") {
+            isValid = takesValue() && parseInt (value, edgeThreshold) && edgeThreshold >= 0;
+        } else if (arg == "--poster") {
+            isPoster = true;
+        } else if (arg == "--checkpoint") {
+            if (takesValue()) checkpointPath = value;
+        } else if (arg == "--open") {
+            if (takesValue()) openPath = value;
+        } else if (arg == "--path") {
+            if (takesValue()) juliaPathFile = value;
+        } else if (arg == "--circle") {
+            isValid = takesValue() && parseCircle (value, circleCentre, circleRadius);
+        } else if (arg == "--frames") {
+            isValid = takesValue() && parseInt (value, numFrames) && numFrames >= 1;
+        } else if (arg == "--fps") {
+            isValid = takesValue() && parseInt (value, animationOptions.framesPerSecond)
+                   && animationOptions.framesPerSecond >= 1;
+        } else if (arg == "--precision") {
+            if (takesValue()) {
+                choosesPrecision = std::strcmp (value, "auto") == 0;
+                if (std::strcmp (value, "float") == 0) params.precision = Precision::float32;
+                else if (std::strcmp (value, "double") == 0) params.precision = Precision::float64;
+                else if (std::strcmp (value, "double-double") == 0) params.precision = Precision::doubleDouble;
+                else if (std::strcmp (value, "perturbation") == 0) params.precision = Precision::perturbation;
+                else isValid = choosesPrecision;
+            }
+        } else if (arg == "--samples") {
+            isValid = takesValue() && (numSamples = std::strtod (value, nullptr)) >= 1 && numSamples < 1.0e19;
+        } else if (arg == "--seed") {
+            int seed = 0;
+            isValid = takesValue() && parseInt (value, seed);
+            densityOptions.seed = static_cast<uint64_t> (seed);
+        } else if (arg == "--trace") {
+            if (takesValue()) tracePath = value;
+        } else if (arg == "-q" || arg == "--quiet") {
+            isQuiet = true;
+        } else {
+            std::fprintf (stderr, "fractal-render: unknown option %s\n", arg.c_str());
+            return 2;
+        }
+
+        if (! isValid) {
+            std::fprintf (stderr, "fractal-render: bad or missing value for %s\n", arg.c_str());
+            return 2;
+        }
+    }
+
+    if (outputPath.empty() && checkpointPath.empty()) {
+        printUsage();
+        return 2;
+    }
+    if (params.minIterations > params.maxIterations) {
+        std::fprintf (stderr, "fractal-render: --min-iterations is above --max-iterations\n");
+        return 2;
+    }
+
+    params.centreX = centreX.toDouble();
+    params.centreY = centreY.toDouble();
+    params.centreXLow = (centreX - FixedPoint (params.centreX)).toDouble();
+    params.centreYLow = (centreY - FixedPoint (params.centreY)).toDouble();
+    params.fitToSpan (4.0 / zoom);
+    if (params.pixelSize < smallestPixelSize) {
+        std::fprintf (stderr, "fractal-render: --zoom is too deep for this size\n");
+        return 2;
+    }
+
+    if (isDensity && ! tracePath.empty()) {
+        std::fprintf (stderr, "fractal-render: --trace only covers escape-time renders\n");
+        return 2;
+    }
+    if (isPoster && (isDensity || options.subdivide || ! tracePath.empty())) {
+        std::fprintf (stderr, "fractal-render: --poster only renders escape times, every pixel, untraced\n");
+        return 2;
+    }
+    if ((! checkpointPath.empty() || ! openPath.empty())
+        && (isDensity || isPoster || options.subdivide || ! tracePath.empty())) {
+        std::fprintf (stderr, "fractal-render: --checkpoint and --open only keep escape times, every pixel, untraced\n");
+        return 2;
+    }
+    if (! openPath.empty() && (! checkpointPath.empty() || outputPath.empty())) {
+        std::fprintf (stderr, "fractal-render: --open needs -o and no --checkpoint\n");
+        return 2;
+    }
+    const bool isAnimation = ! juliaPathFile.empty() || circleRadius > 0.0;
+    if (! juliaPathFile.empty() && circleRadius > 0.0) {
+        std::fprintf (stderr, "fractal-render: give --path or --circle, not both\n");
+        return 2;
+    }
+    if (isAnimation && (isDensity || isPoster || ! checkpointPath.empty() || ! openPath.empty()
+                        || ! tracePath.empty() || outputPath.empty())) {
+        std::fprintf (stderr, "fractal-render: an animation is its own render, to -o, untraced\n");
+        return 2;
+    }
+    if (isAnimation && ! isImageSequencePath (outputPath) && outputPath != "-"
+        && (outputPath.size() < 4 || outputPath.compare (outputPath.size() - 4, 4, ".y4m") != 0)) {
+        std::fprintf (stderr, "fractal-render: write an animation to a .y4m file, - or a name like frame-%%05d.png\n");
+        return 2;
+    }
+    if (numFrames > 0 && ! isAnimation) {
+        std::fprintf (stderr, "fractal-render: --frames needs --path or --circle\n");
+        return 2;
+    }
+    if (samplesPerEdgePixel > 0 && (isDensity || isPoster || isAnimation || ! checkpointPath.empty()
+                                    || ! openPath.empty())) {
+        std::fprintf (stderr, "fractal-render: --antialias only covers single escape-time frames\n");
+        return 2;
+    }
+    if ((isDistributed || ! distributedOptions.workerCommand.empty())
+        && (isDensity || isPoster || isAnimation || ! checkpointPath.empty() || ! openPath.empty()
+            || options.subdivide || ! tracePath.empty())) {
+        std::fprintf (stderr, "fractal-render: --workers only iterates single escape-time frames, every pixel, untraced\n");
+        return 2;
+    }
+    if (! distributedOptions.workerCommand.empty() && ! isDistributed) {
+        std::fprintf (stderr, "fractal-render: --worker-command needs --workers\n");
+        return 2;
+    }
+    if (isDensity)
+        return renderDensity (params, densityOptions, options.numThreads, static_cast<uint64_t> (numSamples),
+                              outputPath, isQuiet);
+
+    palette.setCycleOffset (cycleOffset);
+    options.keepMagnitudes = palette.usesMagnitude();
+
+    if (! openPath.empty())
+        return colourIterationFile (openPath, palette, outputPath, isQuiet);
+
+    if (isAnimation) {
+        JuliaPath path;
+        if (circleRadius > 0.0) {
+            path = makeJuliaCircle (circleCentre, circleRadius, numFrames > 0 ? numFrames : 120);
+        } else if (! readJuliaPath (juliaPathFile, path) || path.empty()) {
+            std::fprintf (stderr, "fractal-render: couldn't read a path of constants from %s\n", juliaPathFile.c_str());
+            return 2;
+        } else if (numFrames > 0) {
+            path = resampleJuliaPath (path, numFrames);
+        }
+
+        // A reference orbit only holds for one constant, so deep frames go in double-double
+        params.type = FractalType::julia;
+        if (choosesPrecision)
+            params.precision = choosePrecision (params, false);
+        else if (params.precision == Precision::perturbation)
+            params.precision = Precision::doubleDouble;
+
+        animationOptions.numThreads = options.numThreads;
+        animationOptions.subdivide = options.subdivide;
+        animationOptions.simdLevel = options.simdLevel;
+        return renderAnimation (params, palette, path, animationOptions, outputPath, isQuiet);
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    if (choosesPrecision)
+        params.precision = choosePrecision (params, true);
+    if (params.precision == Precision::perturbation && params.formula.isQuadratic())
+        params.reference = std::make_shared<const ReferenceOrbit> (params, centreX, centreY);
+
+    if (isPoster)
+        return renderPosterFile (params, palette, options, outputPath, isQuiet);
+    if (! checkpointPath.empty())
+        return renderCheckpointed (params, palette, options, checkpointPath, centreXText, centreYText,
+                                   outputPath, isQuiet);
+
+    RenderStats stats ("fractal-render");
+    if (! tracePath.empty()) {
+        const int numThreads = options.numThreads > 0 ? options.numThreads
+                                                      : static_cast<int> (std::thread::hardware_concurrency());
+        options.stats = &stats;
+        options.statsFrame = stats.beginFrame ("render", numThreads);
+    }
+
+    IterationBuffer iterations (params.width, params.height);
+    if (isDistributed) {
+        DistributedReport report;
+        int lastPercent = -1;
+        distributedOptions.onProgress = [&] (const int tilesDone, const int numTiles) {
+            const int percent = static_cast<int> (100LL * tilesDone / numTiles);
+            if (! isQuiet && percent != lastPercent)
+                std::fprintf (stderr, "\r%s: %d%%", outputPath.c_str(), percent);
+            lastPercent = percent;
+            return true;
+        };
+
+        const bool isComplete = renderDistributed (params, centreXText, centreYText, iterations, distributedOptions, &report);
+        if (! isQuiet)
+            std::fprintf (stderr, "\r%s: %d tiles on %d workers, %d stolen, %d sent again, %d workers lost\n",
+                          outputPath.c_str(), report.numTiles, report.numWorkers, report.numStolen,
+                          report.numSentAgain, report.numWorkersLost);
+        if (! isComplete) {
+            std::fprintf (stderr, "fractal-render: the workers didn't finish the frame\n");
+            return 1;
+        }
+    } else {
+        renderFrame (params, iterations, options);
+    }
+
+    const auto rendered = std::chrono::steady_clock::now();
+
+    // Only the pixels on edges get more samples, once every pixel's neighbours are known
+    std::unique_ptr<EdgeSamples> edges;
+    if (samplesPerEdgePixel > 0)
+        edges = std::make_unique<EdgeSamples> (sampleEdges (params, iterations, samplesPerEdgePixel, edgeThreshold,
+                                                            options.numThreads, options.simdLevel));
+
+    const auto antialiased = std::chrono::steady_clock::now();
+
+    palette.build (params.minIterations, params.maxIterations, &iterations);
+    std::vector<uint32_t> pixels (static_cast<size_t> (params.width) * static_cast<size_t> (params.height));
+    palette.colourFrame (iterations, pixels.data());
+    if (edges != nullptr)
+        edges->colourFrame (palette, params.width, params.height, pixels.data());
+
+    const auto coloured = std::chrono::steady_clock::now();
+
+    if (! writePng (outputPath, params.width, params.height, pixels.data())) {
+        std::fprintf (stderr, "fractal-render: couldn't write %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    if (! tracePath.empty()) {
+        if (edges != nullptr)
+            stats.addEvent (options.statsFrame, RenderStage::antialias, -1, rendered, antialiased);
+        stats.addEvent (options.statsFrame, RenderStage::colour, -1, antialiased, coloured);
+        stats.addEvent (options.statsFrame, RenderStage::publish, -1, coloured, std::chrono::steady_clock::now());
+        stats.finishFrame (options.statsFrame);
+
+        std::ofstream trace (tracePath, std::ios::binary);
+        trace << RenderStats::toChromeTrace ({ &stats });
+        if (! trace) {
+            std::fprintf (stderr, "fractal-render: couldn't write %s\n", tracePath.c_str());
+            return 1;
+        }
+    }
+
+    if (! isQuiet) {
+        auto milliseconds = [] (auto from, auto to) { return std::chrono::duration<double, std::milli> (to - from).count(); };
+        if (edges != nullptr)
+            std::fprintf (stderr, "%s: %zu edge pixels (%.1f%%) antialiased in %.1f ms\n", outputPath.c_str(),
+                          edges->getNumPixels(), 100.0 * edges->getNumPixels() / (static_cast<double> (params.width) * params.height),
+                          milliseconds (rendered, antialiased));
+        std::fprintf (stderr, "%s: %dx%d, iterated in %.1f ms, total %.1f ms\n", outputPath.c_str(),
+                      params.width, params.height, milliseconds (start, rendered),
+                      milliseconds (start, std::chrono::steady_clock::now()));
+    }
+    return 0;
+}
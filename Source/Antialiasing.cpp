@@ -0,0 +1,237 @@
+/*
+  ==============================================================================
+
+    Antialiasing.cpp
+    Created: 25 Oct 2026 2:36:09pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "Antialiasing.h"
+#include "Palette.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+
+//==============================================================================
+// Sample positions inside a grid cell, in steps of 1 / jitterSteps of the cell
+static constexpr int jitterSteps = 16;
+static constexpr int maxGridSize = 8;
+
+// A well mixed 32 bits for each sample of each pixel
+static uint32_t hashSample (const int x, const int y, const int sample) noexcept {
+    uint32_t hash = static_cast<uint32_t> (x) * 0x9e3779b1u ^ static_cast<uint32_t> (y) * 0x85ebca77u
+                  ^ static_cast<uint32_t> (sample) * 0xc2b2ae3du;
+    hash ^= hash >> 15;
+    hash *= 0x2c1b3c6du;
+    hash ^= hash >> 12;
+    hash *= 0x297a2d39u;
+    hash ^= hash >> 15;
+    return hash;
+}
+
+EdgeSamples::EdgeSamples (const int samplesPerPixel, const int threshold, const int numRegions)
+    : m_gridSize (std::clamp (static_cast<int> (std::lround (std::sqrt (std::max (samplesPerPixel, 1)))), 2, maxGridSize)),
+      m_threshold (std::max (threshold, 0)),
+      m_regions (static_cast<size_t> (std::max (numRegions, 1))) {}
+
+/*  The frame at gridSize * jitterSteps times the resolution, so the pixel
+    sampled at (x, y) is fine pixel (x * scale - scale / 2, y * scale - scale / 2)
+    and every sample of it lands on a whole fine pixel within half a pixel of
+    it. Every precision tier works from these offsets as it does from pixels.
+*/
+static FractalParams makeFineParams (const FractalParams& params, const int scale) noexcept {
+    auto fine = params;
+    fine.width = params.width * scale;
+    fine.height = params.height * scale;
+    fine.pixelSize = params.pixelSize / scale;
+    return fine;
+}
+
+void EdgeSamples::samplePixel (const FractalParams& fine, const int x, const int y, int* counts, float* magnitudes,
+                               const SimdLevel simdLevel) const noexcept {
+    const int scale = m_gridSize * jitterSteps;
+    const int numSamples = getSamplesPerPixel();
+    int fineX[maxGridSize * maxGridSize], fineY[maxGridSize * maxGridSize];
+
+    for (int sample = 0; sample < numSamples; sample++)
+    {
+        const uint32_t jitter = hashSample (x, y, sample);
+        fineX[sample] = x * scale - scale / 2 + (sample % m_gridSize) * jitterSteps + static_cast<int> (jitter & 15);
+        fineY[sample] = y * scale - scale / 2 + (sample / m_gridSize) * jitterSteps + static_cast<int> ((jitter >> 4) & 15);
+    }
+
+    // The deep tiers have no batch kernels, see calcIterationsRow()
+    if (fine.precision != Precision::float32 && fine.precision != Precision::float64)
+    {
+        for (int sample = 0; sample < numSamples; sample++)
+            counts[sample] = calcIterations (fine, fineX[sample], fineY[sample], magnitudes + sample);
+        return;
+    }
+
+    // The whole pixel as one batch, as calcIterations() would run each sample
+    const bool isJulia = fine.type == FractalType::julia;
+    double pointRe[maxGridSize * maxGridSize], pointIm[maxGridSize * maxGridSize];
+    double fixedRe[maxGridSize * maxGridSize], fixedIm[maxGridSize * maxGridSize];
+
+    for (int sample = 0; sample < numSamples; sample++)
+    {
+        pointRe[sample] = fine.mathX (fineX[sample]);
+        pointIm[sample] = fine.mathY (fineY[sample]);
+        fixedRe[sample] = isJulia ? fine.cRe : 0.0;
+        fixedIm[sample] = isJulia ? fine.cIm : 0.0;
+    }
+
+    OrbitBatch batch;
+    batch.numOrbits = numSamples;
+    batch.firstIteration = fine.minIterations;
+    batch.formula = fine.formula;
+    batch.isMandelbrot = ! isJulia;
+    batch.useFloats = fine.precision == Precision::float32;
+    batch.zRe = isJulia ? pointRe : fixedRe;
+    batch.zIm = isJulia ? pointIm : fixedIm;
+    batch.cRe = isJulia ? fixedRe : pointRe;
+    batch.cIm = isJulia ? fixedIm : pointIm;
+    batch.results.nIterations = counts;
+    batch.results.finalMagnitudes = magnitudes;
+
+    iterateOrbits (batch, fine.maxIterations, simdLevel);
+}
+
+bool EdgeSamples::sampleArea (const FractalParams& params, const IterationBuffer& iterations, const PixelArea& area,
+                              const int region, const std::function<bool()>& shouldStop,
+                              const SimdLevel simdLevel) {
+    auto& lists = m_regions[static_cast<size_t> (region)];
+    lists.pixels.clear();
+    lists.counts.clear();
+    lists.magnitudes.clear();
+
+    const PixelArea buffer { iterations.getX(), iterations.getY(), iterations.getWidth(), iterations.getHeight() };
+    const auto clipped = area.getIntersection (buffer);
+    const auto fine = makeFineParams (params, m_gridSize * jitterSteps);
+    const int numSamples = getSamplesPerPixel();
+
+    for (int ptY = clipped.y; ptY < clipped.getBottom(); ptY++)
+    {
+        if (shouldStop != nullptr && shouldStop())
+        {
+            lists = {};
+            return false;
+        }
+
+        const int* row = iterations.getCounts (ptY);
+        for (int ptX = clipped.x; ptX < clipped.getRight(); ptX++)
+        {
+            const int count = row[ptX];
+            const bool isInside = count > params.maxIterations;
+            bool isEdge = false;
+
+            for (int neighbourY = std::max (ptY - 1, buffer.y); neighbourY <= std::min (ptY + 1, buffer.getBottom() - 1) && ! isEdge; neighbourY++)
+            {
+                const int* neighbours = iterations.getCounts (neighbourY);
+                for (int neighbourX = std::max (ptX - 1, buffer.x); neighbourX <= std::min (ptX + 1, buffer.getRight() - 1); neighbourX++)
+                {
+                    const int neighbour = neighbours[neighbourX];
+                    if ((neighbour > params.maxIterations) != isInside || std::abs (neighbour - count) > m_threshold)
+                    {
+                        isEdge = true;
+                        break;
+                    }
+                }
+            }
+
+            if (! isEdge)
+                continue;
+
+            lists.pixels.push_back ({ ptX, ptY });
+            lists.counts.resize (lists.counts.size() + static_cast<size_t> (numSamples));
+            lists.magnitudes.resize (lists.counts.size());
+            samplePixel (fine, ptX, ptY, lists.counts.data() + lists.counts.size() - static_cast<size_t> (numSamples),
+                         lists.magnitudes.data() + lists.magnitudes.size() - static_cast<size_t> (numSamples), simdLevel);
+        }
+    }
+    return true;
+}
+
+//==============================================================================
+uint32_t EdgeSamples::getColour (const Palette& palette, const int region, const size_t index) const noexcept {
+    const auto& lists = m_regions[static_cast<size_t> (region)];
+    const int numSamples = getSamplesPerPixel();
+    const size_t first = index * static_cast<size_t> (numSamples);
+
+    uint32_t red = 0, green = 0, blue = 0;
+    for (int sample = 0; sample < numSamples; sample++)
+    {
+        const uint32_t colour = palette.getColour (lists.counts[first + static_cast<size_t> (sample)],
+                                                   lists.magnitudes[first + static_cast<size_t> (sample)]);
+        red += (colour >> 16) & 0xff;
+        green += (colour >> 8) & 0xff;
+        blue += colour & 0xff;
+    }
+
+    const auto half = static_cast<uint32_t> (numSamples / 2), divisor = static_cast<uint32_t> (numSamples);
+    return 0xff000000u | (((red + half) / divisor) << 16) | (((green + half) / divisor) << 8) | ((blue + half) / divisor);
+}
+
+void EdgeSamples::colourFrame (const Palette& palette, const int width, const int height,
+                               uint32_t* pixels) const noexcept {
+    for (int region = 0; region < getNumRegions(); region++)
+    {
+        const auto& edgePixels = getPixels (region);
+        for (size_t index = 0; index < edgePixels.size(); index++)
+        {
+            const auto& pixel = edgePixels[index];
+            if (pixel.x >= 0 && pixel.y >= 0 && pixel.x < width && pixel.y < height)
+                pixels[static_cast<size_t> (pixel.y) * static_cast<size_t> (width) + static_cast<size_t> (pixel.x)]
+                    = getColour (palette, region, index);
+        }
+    }
+}
+
+size_t EdgeSamples::getNumPixels() const noexcept {
+    size_t numPixels = 0;
+    for (const auto& region : m_regions)
+        numPixels += region.pixels.size();
+    return numPixels;
+}
+
+size_t EdgeSamples::getNumBytes() const noexcept {
+    size_t numBytes = 0;
+    for (const auto& region : m_regions)
+        numBytes += region.pixels.size() * sizeof (Pixel) + region.counts.size() * (sizeof (int) + sizeof (float));
+    return numBytes;
+}
+
+//==============================================================================
+EdgeSamples sampleEdges (const FractalParams& params, const IterationBuffer& iterations,
+                         const int samplesPerPixel, const int threshold, const int numThreads,
+                         const SimdLevel simdLevel) {
+    constexpr int bandHeight = 16;
+    const int numBands = std::max (1, (params.height + bandHeight - 1) / bandHeight);
+    EdgeSamples samples (samplesPerPixel, threshold, numBands);
+
+    std::atomic<int> nextBand {0};
+    auto sampleBands = [&]
+    {
+        for (int band = nextBand++; band < numBands; band = nextBand++)
+            samples.sampleArea (params, iterations,
+                                { 0, band * bandHeight, params.width, std::min (bandHeight, params.height - band * bandHeight) },
+                                band, nullptr, simdLevel);
+    };
+
+    int threadCount = numThreads > 0 ? numThreads : static_cast<int> (std::thread::hardware_concurrency());
+    threadCount = std::clamp (threadCount, 1, numBands);
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < threadCount; i++)
+        threads.emplace_back (sampleBands);
+
+    sampleBands();
+
+    for (auto& thread : threads)
+        thread.join();
+
+    return samples;
+}
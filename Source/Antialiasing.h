@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+
+    Antialiasing.h
+    Created: 25 Oct 2026 2:36:09pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "EscapeTime.h"
+#include "IterationBuffer.h"
+#include "Symmetry.h"
+
+class Palette;
+
+//==============================================================================
+/*
+    Adaptive antialiasing for a frame that has already been iterated once per
+    pixel. Only pixels on an edge get more samples: those whose count differs
+    from one of their eight neighbours' by more than a threshold, or that are
+    inside the set next to one that isn't. That is usually a few percent of
+    the frame, so edges come out as smooth as full supersampling for a small
+    part of its cost.
+
+    An edge pixel is sampled on a k x k grid across its square, each sample
+    jittered inside its cell, and is coloured with the average of their
+    colours. The jitter is a hash of the pixel, so the same frame always
+    gets the same samples. Samples are iterated at the frame's precision,
+    including perturbation, as offsets on a grid finer than the pixels.
+
+    The counts stay as they are, so anything that reads them is unaffected,
+    and the samples are kept as counts too, so changing the palette only
+    recolours them. Like pending orbits, the edge pixels are kept in one
+    list per region of the frame, which only one thread at a time may touch.
+*/
+class EdgeSamples
+{
+public:
+    struct Pixel
+    {
+        int x, y;
+    };
+
+    /*  samplesPerPixel is rounded to a square from 4 to 64. Pixels are on an
+        edge when a neighbour's count is more than threshold away.
+    */
+    EdgeSamples (const int samplesPerPixel, const int threshold = defaultThreshold, const int numRegions = 1);
+
+    int getSamplesPerPixel() const noexcept     { return m_gridSize * m_gridSize; }
+    int getThreshold() const noexcept           { return m_threshold; }
+
+    /*  Finds the edge pixels of area and samples them into region's list,
+        replacing what was there. Neighbours outside the buffer are left out,
+        so the area's should be final. Returns false if shouldStop asked it
+        to give up part way, leaving the list empty.
+    */
+    bool sampleArea (const FractalParams& params, const IterationBuffer& iterations, const PixelArea& area,
+                     const int region, const std::function<bool()>& shouldStop = nullptr,
+                     const SimdLevel simdLevel = getSimdLevel());
+
+    const std::vector<Pixel>& getPixels (const int region) const noexcept
+    {
+        return m_regions[static_cast<size_t> (region)].pixels;
+    }
+
+    // The average colour of the samples of a region's index-th edge pixel, as 0xAARRGGBB
+    uint32_t getColour (const Palette& palette, const int region, const size_t index) const noexcept;
+
+    /*  Colours every edge pixel over pixels of width columns, whose first is
+        pixel (0, 0). Pixels outside the image are skipped.
+    */
+    void colourFrame (const Palette& palette, const int width, const int height, uint32_t* pixels) const noexcept;
+
+    int getNumRegions() const noexcept          { return static_cast<int> (m_regions.size()); }
+    size_t getNumPixels() const noexcept;
+    size_t getNumBytes() const noexcept;
+
+    static constexpr int defaultThreshold = 2;
+
+private:
+    struct Region
+    {
+        std::vector<Pixel> pixels;
+        std::vector<int> counts;
+        std::vector<float> magnitudes;
+    };
+
+    void samplePixel (const FractalParams& fine, const int x, const int y, int* counts, float* magnitudes,
+                      const SimdLevel simdLevel) const noexcept;
+
+    const int m_gridSize;
+    const int m_threshold;
+    std::vector<Region> m_regions;
+};
+
+/*  Samples the edges of a whole frame on plain std::threads, which take
+    bands of rows, one region each, from a shared counter. 0 threads means
+    one per hardware thread.
+*/
+EdgeSamples sampleEdges (const FractalParams& params, const IterationBuffer& iterations,
+                         const int samplesPerPixel, const int threshold = EdgeSamples::defaultThreshold,
+                         const int numThreads = 0, const SimdLevel simdLevel = getSimdLevel());
@@ -0,0 +1,326 @@
+/*
+  ==============================================================================
+
+    Buddhabrot.cpp
+    Created: 22 Oct 2026 10:14:52am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "Buddhabrot.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <thread>
+
+namespace
+{
+    // c is drawn from [-2, 2] x [-2, 2]
+    constexpr double samplingMin = -2.0;
+    constexpr double samplingSpan = 4.0;
+
+    // Orbits traced per cell to build the importance map, on a 4x4 jittered grid
+    constexpr int samplesPerCellSide = 4;
+
+    // Cells are drawn up to this many times as often as one where nothing counted
+    constexpr uint32_t maxCellWeight = 16;
+
+    // Rough number of iterations a thread does per pass
+    constexpr uint64_t iterationsPerPass = uint64_t { 1 } << 25;
+
+    // Streams past this one seed the importance map rather than chunks
+    constexpr uint64_t importanceStream = uint64_t { 1 } << 63;
+
+    uint64_t mix (uint64_t z) noexcept
+    {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    // SplitMix64: tiny, fast and good enough for placing samples
+    class Random
+    {
+    public:
+        Random (const uint64_t seed, const uint64_t stream) noexcept
+            : m_state (mix (seed ^ mix (stream + 1))) {}
+
+        uint64_t next() noexcept            { return mix (m_state += 0x9e3779b97f4a7c15ull); }
+        double nextDouble() noexcept        { return static_cast<double> (next() >> 11) * 0x1.0p-53; }
+
+    private:
+        uint64_t m_state;
+    };
+
+    // Maps orbit points to pixels the way FractalParams::pixelX() and pixelY() do, rounded
+    struct PixelMapping
+    {
+        explicit PixelMapping (const FractalParams& params) noexcept
+            : scale (1.0 / params.pixelSize),
+              offsetX (params.width * 0.5 - params.centreX * scale + 0.5),
+              offsetY (params.height * 0.5 - params.centreY * scale + 0.5),
+              width (params.width), height (params.height) {}
+
+        bool find (const double re, const double im, size_t& index) const noexcept
+        {
+            const double x = re * scale + offsetX;
+            const double y = im * scale + offsetY;
+            if (! (x >= 0.0 && x < width && y >= 0.0 && y < height))
+                return false;
+
+            index = static_cast<size_t> (static_cast<int> (y)) * static_cast<size_t> (width) + static_cast<size_t> (static_cast<int> (x));
+            return true;
+        }
+
+        double scale, offsetX, offsetY;
+        int width, height;
+    };
+}
+
+/*  Iterates the orbit of z = 0 under the formula into re and im and returns
+    how many of its points count, which is 0 unless the orbit belongs to the
+    kind of image being drawn.
+*/
+template <int power, FormulaVariant variant>
+static int traceOrbit (const double cRe, const double cIm, const int minIterations, const int maxIterations,
+                       const bool anti, double* re, double* im) noexcept {
+    // These never escape, which is all the anti-Buddhabrot wants to know
+    if constexpr (power == 2 && variant == FormulaVariant::standard)
+        if (! anti && isInMainCardioidOrBulb (cRe, cIm))
+            return 0;
+
+    double zRe = 0.0, zIm = 0.0;
+    for (int n = 0; n < maxIterations; n++)
+    {
+        stepFormula<power, variant, ScalarMaths> (zRe, zIm, cRe, cIm);
+        re[n] = zRe;
+        im[n] = zIm;
+
+        if (zRe * zRe + zIm * zIm > 4.0)
+            return anti || n + 1 < minIterations ? 0 : n + 1;
+    }
+    return anti ? maxIterations : 0;
+}
+
+//==============================================================================
+uint64_t DensityMap::getMaximum() const noexcept {
+    return counts.empty() ? 0 : *std::max_element (counts.begin(), counts.end());
+}
+
+void DensityMap::colour (uint32_t* pixels) const noexcept {
+    const uint64_t maximum = getMaximum();
+    const double scale = maximum > 0 ? 255.0 / std::sqrt (static_cast<double> (maximum)) : 0.0;
+
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+        const auto shade = std::min (255u, static_cast<uint32_t> (std::sqrt (static_cast<double> (counts[i])) * scale));
+        pixels[i] = 0xff000000u | shade * 0x010101u;
+    }
+}
+
+//==============================================================================
+BuddhabrotSampler::BuddhabrotSampler (const FractalParams& params, const BuddhabrotOptions& options)
+    : m_params (params), m_options (options) {
+    const int numThreads = options.numThreads > 0 ? options.numThreads
+                                                  : static_cast<int> (std::thread::hardware_concurrency());
+    const auto numPixels = static_cast<size_t> (std::max (0, params.width)) * static_cast<size_t> (std::max (0, params.height));
+    const auto maxSteps = static_cast<size_t> (std::clamp (params.maxIterations, 1, maxIterationLimit));
+
+    m_workers.resize (static_cast<size_t> (std::max (1, numThreads)));
+    for (auto& worker : m_workers)
+    {
+        worker.histogram.assign (numPixels, 0);
+        worker.orbitRe.resize (maxSteps);
+        worker.orbitIm.resize (maxSteps);
+    }
+
+    m_density.width = params.width;
+    m_density.height = params.height;
+    m_density.counts.assign (numPixels, 0);
+
+    withFormula (params.formula, [this] (auto power, auto variant)
+    {
+        m_traceOrbit = traceOrbit<decltype (power)::value, decltype (variant)::value>;
+    });
+}
+
+template <typename Function>
+void BuddhabrotSampler::runOnThreads (Function&& function) {
+    std::vector<std::thread> threads;
+    for (int i = 1; i < getNumThreads(); i++)
+        threads.emplace_back ([&function, i] { function (i); });
+
+    function (0);
+
+    for (auto& thread : threads)
+        thread.join();
+}
+
+bool BuddhabrotSampler::sample (const uint64_t numSamples, const std::function<void (const DensityMap&)>& onPass) {
+    if (! m_hasImportanceMap)
+        buildImportanceMap();
+
+    // Every hit of a pass could land on the same pixel, and the histograms mustn't overflow
+    const int maxIterations = std::clamp (m_params.maxIterations, 1, maxIterationLimit);
+    const uint64_t orbitCost = static_cast<uint64_t> (maxIterations) * chunkSize;
+    const uint64_t chunksPerThread = std::max<uint64_t> (1, std::min (std::numeric_limits<uint32_t>::max() / (orbitCost * maxCellWeight),
+                                                                      iterationsPerPass / orbitCost));
+    const uint64_t chunksPerPass = chunksPerThread * static_cast<uint64_t> (getNumThreads());
+
+    uint64_t chunksLeft = numSamples / chunkSize + (numSamples % chunkSize != 0 ? 1 : 0);
+
+    while (chunksLeft > 0 && ! m_shouldStop)
+    {
+        const uint64_t passChunks = std::min (chunksLeft, chunksPerPass);
+        const uint64_t firstChunk = m_nextChunk;
+        std::atomic<uint64_t> nextChunk { 0 }, chunksTraced { 0 };
+
+        // A thread that has done its share leaves the rest to the others,
+        // and between them they always have room for the whole pass
+        runOnThreads ([&] (const int index)
+        {
+            auto& worker = m_workers[static_cast<size_t> (index)];
+            uint64_t numTraced = 0;
+
+            for (uint64_t chunk = nextChunk++; chunk < passChunks && ! m_shouldStop; chunk = nextChunk++)
+            {
+                traceChunk (worker, firstChunk + chunk);
+                if (++numTraced == chunksPerThread)
+                    break;
+            }
+            chunksTraced += numTraced;
+        });
+
+        // Chunks skipped by stop() are never drawn again, so no two passes share samples
+        m_nextChunk += passChunks;
+        chunksLeft -= passChunks;
+
+        mergeHistograms();
+        m_density.numSamples += chunksTraced * chunkSize;
+
+        if (onPass != nullptr)
+            onPass (m_density);
+    }
+    return ! m_shouldStop;
+}
+
+void BuddhabrotSampler::buildImportanceMap() {
+    m_hasImportanceMap = true;
+    m_cellsAcross = std::clamp (m_options.importanceCells, 1, 1024);
+
+    const auto numCells = static_cast<size_t> (m_cellsAcross) * static_cast<size_t> (m_cellsAcross);
+    std::vector<uint32_t> cellWeights (numCells, maxCellWeight);
+
+    if (m_options.importanceCells > 0)
+    {
+        const int maxIterations = std::clamp (m_params.maxIterations, 1, maxIterationLimit);
+        const double cellSize = samplingSpan / m_cellsAcross;
+        const double stepSize = cellSize / samplesPerCellSide;
+        const PixelMapping mapping (m_params);
+        std::atomic<int> nextRow { 0 };
+
+        runOnThreads ([&] (const int index)
+        {
+            auto& worker = m_workers[static_cast<size_t> (index)];
+
+            for (int row = nextRow++; row < m_cellsAcross; row = nextRow++)
+            {
+                for (int column = 0; column < m_cellsAcross; column++)
+                {
+                    const size_t cell = static_cast<size_t> (row) * static_cast<size_t> (m_cellsAcross) + static_cast<size_t> (column);
+                    Random random (m_options.seed, importanceStream + cell);
+                    uint32_t hits = 0;
+
+                    for (int sample = 0; sample < samplesPerCellSide * samplesPerCellSide; sample++)
+                    {
+                        const double cRe = samplingMin + column * cellSize + (sample % samplesPerCellSide + random.nextDouble()) * stepSize;
+                        const double cIm = samplingMin + row * cellSize + (sample / samplesPerCellSide + random.nextDouble()) * stepSize;
+                        const int length = m_traceOrbit (cRe, cIm, m_params.minIterations, maxIterations, m_options.anti,
+                                                       worker.orbitRe.data(), worker.orbitIm.data());
+
+                        size_t pixel = 0;
+                        for (int i = 0; i < length; i++)
+                        {
+                            if (mapping.find (worker.orbitRe[static_cast<size_t> (i)], worker.orbitIm[static_cast<size_t> (i)], pixel))
+                            {
+                                hits++;
+                                break;
+                            }
+                        }
+                    }
+
+                    // Twice the hits rounded up to a power of two, so every
+                    // hit weight is a whole number
+                    uint32_t weight = 1;
+                    while (weight < maxCellWeight && weight < 2 * hits)
+                        weight *= 2;
+                    cellWeights[cell] = weight;
+                }
+            }
+        });
+    }
+
+    m_cumulativeWeights.resize (numCells);
+    m_hitWeights.resize (numCells);
+    uint64_t total = 0;
+
+    for (size_t cell = 0; cell < numCells; cell++)
+    {
+        total += cellWeights[cell];
+        m_cumulativeWeights[cell] = total;
+        m_hitWeights[cell] = maxCellWeight / cellWeights[cell];
+    }
+}
+
+void BuddhabrotSampler::traceChunk (Worker& worker, const uint64_t chunk) noexcept {
+    Random random (m_options.seed, chunk);
+
+    const int maxIterations = std::clamp (m_params.maxIterations, 1, maxIterationLimit);
+    const double cellSize = samplingSpan / m_cellsAcross;
+    const uint64_t totalWeight = m_cumulativeWeights.back();
+    const PixelMapping mapping (m_params);
+    uint32_t* histogram = worker.histogram.data();
+
+    for (int sample = 0; sample < chunkSize; sample++)
+    {
+        const uint64_t target = random.next() % totalWeight;
+        const auto cell = static_cast<size_t> (std::upper_bound (m_cumulativeWeights.begin(), m_cumulativeWeights.end(), target)
+                                               - m_cumulativeWeights.begin());
+
+        const double cRe = samplingMin + (static_cast<double> (cell % static_cast<size_t> (m_cellsAcross)) + random.nextDouble()) * cellSize;
+        const double cIm = samplingMin + (static_cast<double> (cell / static_cast<size_t> (m_cellsAcross)) + random.nextDouble()) * cellSize;
+        const int length = m_traceOrbit (cRe, cIm, m_params.minIterations, maxIterations, m_options.anti,
+                                       worker.orbitRe.data(), worker.orbitIm.data());
+
+        const uint32_t weight = m_hitWeights[cell];
+        size_t pixel = 0;
+        for (int i = 0; i < length; i++)
+            if (mapping.find (worker.orbitRe[static_cast<size_t> (i)], worker.orbitIm[static_cast<size_t> (i)], pixel))
+                histogram[pixel] += weight;
+    }
+}
+
+void BuddhabrotSampler::mergeHistograms() {
+    // Each thread sums every histogram over its own band of the image and
+    // clears them, so no two threads ever touch the same total
+    const size_t numPixels = m_density.counts.size();
+    const auto numThreads = static_cast<size_t> (getNumThreads());
+
+    runOnThreads ([&] (const int index)
+    {
+        const size_t begin = numPixels * static_cast<size_t> (index) / numThreads;
+        const size_t end = numPixels * static_cast<size_t> (index + 1) / numThreads;
+        uint64_t* counts = m_density.counts.data();
+
+        for (auto& worker : m_workers)
+        {
+            uint32_t* histogram = worker.histogram.data();
+            for (size_t i = begin; i < end; i++)
+            {
+                counts[i] += histogram[i];
+                histogram[i] = 0;
+            }
+        }
+    });
+}
@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    Buddhabrot.h
+    Created: 22 Oct 2026 10:14:52am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "EscapeTime.h"
+
+//==============================================================================
+/*
+    Orbit density rendering. Instead of colouring c by how long its orbit
+    took to escape, random values of c are traced and every z of the orbit
+    adds a hit to the pixel it lands on. The Buddhabrot keeps the orbits that
+    escape within maxIterations, after at least minIterations, and the
+    anti-Buddhabrot the ones that never escape.
+
+    The view is an ordinary FractalParams: its centre, pixel size, size,
+    formula and iteration limits are used, its type and precision are not. c is drawn
+    from the square of side 4 around the origin.
+*/
+struct BuddhabrotOptions
+{
+    // Keep the orbits that never escape instead of the ones that do
+    bool anti { false };
+
+    // 0 means one thread per hardware thread
+    int numThreads { 0 };
+
+    // The same seed and number of samples give the same density on any number of threads
+    uint64_t seed { 1 };
+
+    // Cells across the square for importance sampling, 0 to draw c uniformly
+    int importanceCells { 128 };
+};
+
+/*  Hits per pixel over everything sampled so far, weighted so that it
+    estimates what drawing c uniformly would have given.
+*/
+struct DensityMap
+{
+    int width { 0 }, height { 0 };
+    std::vector<uint64_t> counts;
+
+    // Orbits traced, whether they added anything or not
+    uint64_t numSamples { 0 };
+
+    uint64_t getMaximum() const noexcept;
+
+    // 0xAARRGGBB greys, brightness going with the square root of the density
+    void colour (uint32_t* pixels) const noexcept;
+};
+
+//==============================================================================
+/*
+    Traces orbits on plain std::threads. Each thread adds its hits to a
+    histogram of its own, so the hot loop has no atomics or shared cache
+    lines, and after every pass the histograms are summed into the density
+    with each thread taking a band of the image. Work is handed out in chunks of
+    chunkSize orbits from a shared counter, and every chunk draws from its
+    own random stream, so the result doesn't depend on which thread ran what.
+
+    Most of the square contributes nothing to a zoomed in view, or, for the
+    Buddhabrot, never escapes. The first call therefore traces a few orbits
+    from every cell of a coarse grid and draws c more often from the cells
+    whose orbits counted. Hits are weighted by how much less often their cell
+    was drawn than the busiest one, which keeps the estimate unbiased and the
+    counts whole numbers.
+*/
+class BuddhabrotSampler
+{
+public:
+    BuddhabrotSampler (const FractalParams& params, const BuddhabrotOptions& options = {});
+
+    /*  Traces numSamples more orbits, rounded up to whole chunks. After each
+        pass, about a tenth of a second of work, the density is brought up to
+        date and onPass is called with it on the calling thread. Returns false
+        if stop() cut it short. sample (0) just builds the importance map.
+    */
+    bool sample (const uint64_t numSamples, const std::function<void (const DensityMap&)>& onPass = nullptr);
+
+    // Makes sample() return after the chunks in flight, for good; safe from any thread
+    void stop() noexcept                            { m_shouldStop = true; }
+
+    const DensityMap& getDensity() const noexcept   { return m_density; }
+    int getNumThreads() const noexcept              { return static_cast<int> (m_workers.size()); }
+
+    static constexpr int chunkSize = 1024;
+
+    // Keeps a pass's hits on one pixel within a thread's 32-bit histogram
+    static constexpr int maxIterationLimit = 1 << 17;
+
+private:
+    struct Worker
+    {
+        std::vector<uint32_t> histogram;
+        std::vector<double> orbitRe, orbitIm;
+    };
+
+    // Traces one orbit of m_params.formula, picked once so the loop has the formula built in
+    using TraceFunction = int (*) (double cRe, double cIm, int minIterations, int maxIterations,
+                                   bool anti, double* re, double* im);
+
+    template <typename Function>
+    void runOnThreads (Function&& function);
+
+    void buildImportanceMap();
+    void traceChunk (Worker& worker, const uint64_t chunk) noexcept;
+    void mergeHistograms();
+
+    const FractalParams m_params;
+    const BuddhabrotOptions m_options;
+    TraceFunction m_traceOrbit { nullptr };
+
+    std::vector<Worker> m_workers;
+    DensityMap m_density;
+
+    // Running totals of the cell weights, and the weight that multiplies each hit
+    std::vector<uint64_t> m_cumulativeWeights;
+    std::vector<uint32_t> m_hitWeights;
+    int m_cellsAcross { 1 };
+    bool m_hasImportanceMap { false };
+
+    uint64_t m_nextChunk { 0 };
+    std::atomic<bool> m_shouldStop { false };
+};
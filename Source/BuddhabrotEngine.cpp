@@ -0,0 +1,93 @@
+/*
+  ==============================================================================
+
+    BuddhabrotEngine.cpp
+    Created: 22 Oct 2026 2:37:09pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "BuddhabrotEngine.h"
+
+template <typename PixelType>
+static void copyPixels (const uint32_t* pixels, const juce::Image::BitmapData& bitmap) {
+    jassert (bitmap.pixelStride == sizeof (PixelType));
+
+    for (int ptY = 0; ptY < bitmap.height; ptY++)
+    {
+        auto* line = reinterpret_cast<PixelType*> (bitmap.getLinePointer (ptY));
+        const uint32_t* source = pixels + static_cast<size_t> (ptY) * static_cast<size_t> (bitmap.width);
+
+        for (int ptX = 0; ptX < bitmap.width; ptX++)
+            line[ptX].set (juce::Colour (source[ptX]).getPixelARGB());
+    }
+}
+
+//==============================================================================
+BuddhabrotEngine::BuddhabrotEngine()
+    : juce::Thread ("Buddhabrot") {}
+
+BuddhabrotEngine::~BuddhabrotEngine() {
+    stop();
+}
+
+void BuddhabrotEngine::start (const FractalParams& params, const BuddhabrotOptions& options,
+                              juce::Image& target) {
+    stop();
+
+    m_target = &target;
+    m_numSamples = 0;
+    {
+        const juce::ScopedLock sl (m_lock);
+        m_width = params.width;
+        m_height = params.height;
+        m_pixels.assign (static_cast<size_t> (juce::jmax (0, params.width)) * static_cast<size_t> (juce::jmax (0, params.height)), 0);
+        m_hasNewPixels = false;
+    }
+
+    m_sampler = std::make_unique<BuddhabrotSampler> (params, options);
+    startThread();
+}
+
+void BuddhabrotEngine::stop() {
+    // The sampler finishes the chunks it has started and returns
+    if (m_sampler != nullptr)
+        m_sampler->stop();
+
+    stopThread (-1);
+    cancelPendingUpdate();
+    m_sampler = nullptr;
+}
+
+void BuddhabrotEngine::run() {
+    m_sampler->sample (std::numeric_limits<uint64_t>::max(), [this] (const DensityMap& density)
+    {
+        {
+            const juce::ScopedLock sl (m_lock);
+            density.colour (m_pixels.data());
+            m_hasNewPixels = true;
+        }
+        m_numSamples = density.numSamples;
+        triggerAsyncUpdate();
+    });
+}
+
+void BuddhabrotEngine::handleAsyncUpdate() {
+    const juce::ScopedLock sl (m_lock);
+
+    if (! m_hasNewPixels || m_target == nullptr
+        || m_target->getWidth() != m_width || m_target->getHeight() != m_height)
+        return;
+
+    m_hasNewPixels = false;
+
+    juce::Image::BitmapData bitmap (*m_target, juce::Image::BitmapData::writeOnly);
+    if (bitmap.pixelFormat == juce::Image::ARGB)
+        copyPixels<juce::PixelARGB> (m_pixels.data(), bitmap);
+    else
+        copyPixels<juce::PixelRGB> (m_pixels.data(), bitmap);
+
+    if (onPassPublished != nullptr)
+        onPassPublished (m_target->getBounds());
+}
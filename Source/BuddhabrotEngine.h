@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    BuddhabrotEngine.h
+    Created: 22 Oct 2026 2:37:09pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Buddhabrot.h"
+
+//==============================================================================
+/*
+    Runs a BuddhabrotSampler in the background for a component. Sampling
+    never finishes on its own: after every pass the density so far is
+    coloured and copied into the owner's image on the message thread, then
+    onPassPublished is called, so the image keeps sharpening until the view
+    changes or stop() is called.
+*/
+class BuddhabrotEngine : private juce::Thread,
+                         private juce::AsyncUpdater
+{
+public:
+    BuddhabrotEngine();
+    ~BuddhabrotEngine() override;
+
+    // Starts sampling the view in params into target, replacing whatever was running
+    void start (const FractalParams& params, const BuddhabrotOptions& options, juce::Image& target);
+    void stop();
+    bool isSampling() const                 { return isThreadRunning(); }
+
+    // Orbits traced for the current image so far
+    uint64_t getNumSamples() const noexcept { return m_numSamples; }
+
+    std::function<void (const juce::Rectangle<int>&)> onPassPublished;
+
+private:
+    void run() override;
+    void handleAsyncUpdate() override;
+
+    std::unique_ptr<BuddhabrotSampler> m_sampler;
+    juce::Image* m_target {nullptr};
+
+    // The latest pass, coloured, waiting for the message thread
+    juce::CriticalSection m_lock;
+    std::vector<uint32_t> m_pixels;
+    int m_width {0}, m_height {0};
+    bool m_hasNewPixels {false};
+
+    std::atomic<uint64_t> m_numSamples {0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BuddhabrotEngine)
+};
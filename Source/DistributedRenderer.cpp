@@ -0,0 +1,726 @@
+/*
+  ==============================================================================
+
+    DistributedRenderer.cpp
+    Created: 25 Oct 2026 6:40:15pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "DistributedRenderer.h"
+#include "FrameRenderer.h"
+#include "Perturbation.h"
+#include "Symmetry.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <initializer_list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if ! defined(_WIN32)
+ #include <csignal>
+ #include <cerrno>
+ #include <poll.h>
+ #include <sys/socket.h>
+ #include <sys/wait.h>
+ #include <unistd.h>
+#endif
+
+//==============================================================================
+enum class MessageType : uint32_t { job = 1, tile, cancel, result };
+
+struct MessageHeader
+{
+    uint32_t type;
+    uint32_t size;
+};
+
+static constexpr char magic[8] = { 'F', 'F', 'T', 'I', 'L', 'E', 'S', '\0' };
+static constexpr uint32_t protocolVersion = 1;
+
+// A job message's payload, followed by the two centre texts
+struct JobFields
+{
+    char magic[8];
+    uint32_t version;
+    int32_t width, height;
+    int32_t type, formulaPower, formulaVariant, precision;
+    int32_t minIterations, maxIterations;
+
+    double cRe, cIm;
+    double centreX, centreY, centreXLow, centreYLow;
+    double pixelSize;
+
+    uint32_t centreXTextLength, centreYTextLength;
+};
+
+struct TileFields
+{
+    int32_t id, x, y, width, height;
+};
+
+// A result message's payload, followed by width * height counts, then as many magnitudes
+struct ResultFields
+{
+    int32_t id, width, height;
+};
+
+// Far more than a tile's result, but small enough that a bad length can't exhaust memory
+static constexpr uint32_t maxMessageSize = uint32_t { 1 } << 24;
+
+struct Bytes
+{
+    const void* data;
+    size_t size;
+};
+
+// A message whose payload is the pieces one after another
+static void appendMessage (std::vector<char>& out, const MessageType type, std::initializer_list<Bytes> pieces) {
+    size_t size = 0;
+    for (const auto& piece : pieces)
+        size += piece.size;
+
+    const MessageHeader header { static_cast<uint32_t> (type), static_cast<uint32_t> (size) };
+    const auto* headerBytes = reinterpret_cast<const char*> (&header);
+    out.insert (out.end(), headerBytes, headerBytes + sizeof (header));
+    for (const auto& piece : pieces)
+        out.insert (out.end(), static_cast<const char*> (piece.data), static_cast<const char*> (piece.data) + piece.size);
+}
+
+static std::vector<char> makeJob (const FractalParams& params, const std::string& centreXText,
+                                  const std::string& centreYText) {
+    JobFields job {};
+    std::memcpy (job.magic, magic, sizeof (magic));
+    job.version = protocolVersion;
+    job.width = params.width;
+    job.height = params.height;
+    job.type = static_cast<int32_t> (params.type);
+    job.formulaPower = params.formula.power;
+    job.formulaVariant = static_cast<int32_t> (params.formula.variant);
+    job.precision = static_cast<int32_t> (params.precision);
+    job.minIterations = params.minIterations;
+    job.maxIterations = params.maxIterations;
+    job.cRe = params.cRe;
+    job.cIm = params.cIm;
+    job.centreX = params.centreX;
+    job.centreY = params.centreY;
+    job.centreXLow = params.centreXLow;
+    job.centreYLow = params.centreYLow;
+    job.pixelSize = params.pixelSize;
+    job.centreXTextLength = static_cast<uint32_t> (centreXText.size());
+    job.centreYTextLength = static_cast<uint32_t> (centreYText.size());
+
+    const std::string texts = centreXText + centreYText;
+    std::vector<char> message;
+    appendMessage (message, MessageType::job, { { &job, sizeof (job) }, { texts.data(), texts.size() } });
+    return message;
+}
+
+static bool readJob (const std::vector<char>& payload, FractalParams& params,
+                     std::string& centreXText, std::string& centreYText) {
+    JobFields job;
+    if (payload.size() < sizeof (job))
+        return false;
+    std::memcpy (&job, payload.data(), sizeof (job));
+
+    if (std::memcmp (job.magic, magic, sizeof (magic)) != 0 || job.version != protocolVersion
+        || job.width <= 0 || job.height <= 0
+        || job.type < 0 || job.type > static_cast<int32_t> (FractalType::julia)
+        || job.formulaPower < Formula::minPower || job.formulaPower > Formula::maxPower
+        || job.formulaVariant < 0 || job.formulaVariant > static_cast<int32_t> (FormulaVariant::burningShip)
+        || job.precision < 0 || job.precision > static_cast<int32_t> (Precision::perturbation)
+        || job.minIterations < 0 || job.minIterations > job.maxIterations
+        || payload.size() != sizeof (job) + job.centreXTextLength + job.centreYTextLength)
+        return false;
+
+    params = {};
+    params.type = static_cast<FractalType> (job.type);
+    params.formula = { job.formulaPower, static_cast<FormulaVariant> (job.formulaVariant) };
+    params.precision = static_cast<Precision> (job.precision);
+    params.width = job.width;
+    params.height = job.height;
+    params.minIterations = job.minIterations;
+    params.maxIterations = job.maxIterations;
+    params.cRe = job.cRe;
+    params.cIm = job.cIm;
+    params.centreX = job.centreX;
+    params.centreY = job.centreY;
+    params.centreXLow = job.centreXLow;
+    params.centreYLow = job.centreYLow;
+    params.pixelSize = job.pixelSize;
+
+    const char* texts = payload.data() + sizeof (job);
+    centreXText.assign (texts, job.centreXTextLength);
+    centreYText.assign (texts + job.centreXTextLength, job.centreYTextLength);
+    return true;
+}
+
+#if defined(_WIN32)
+
+bool renderDistributed (const FractalParams&, const std::string&, const std::string&,
+                        IterationBuffer&, const DistributedOptions&, DistributedReport*) {
+    return false;
+}
+
+int runTileWorker (const int, const int) {
+    return 1;
+}
+
+#else
+
+//==============================================================================
+// Splits a stream into messages, reading only what has arrived unless told to wait
+class MessageReader
+{
+public:
+    explicit MessageReader (const int fd) : m_fd (fd) {}
+
+    bool isClosed() const noexcept  { return m_isClosed; }
+
+    // Fills in the next whole message; false once the stream has closed or, without waiting, has nothing yet
+    bool next (MessageType& type, std::vector<char>& payload, const bool shouldWait) {
+        for (;;)
+        {
+            MessageHeader header;
+            if (m_buffer.size() - m_start >= sizeof (header))
+            {
+                std::memcpy (&header, m_buffer.data() + m_start, sizeof (header));
+                if (header.size > maxMessageSize)
+                {
+                    m_isClosed = true;
+                    return false;
+                }
+
+                if (m_buffer.size() - m_start >= sizeof (header) + header.size)
+                {
+                    const char* start = m_buffer.data() + m_start + sizeof (header);
+                    type = static_cast<MessageType> (header.type);
+                    payload.assign (start, start + header.size);
+                    m_start += sizeof (header) + header.size;
+                    return true;
+                }
+            }
+
+            if (m_isClosed || ! fill (shouldWait))
+                return false;
+        }
+    }
+
+private:
+    bool fill (const bool shouldWait) {
+        pollfd request { m_fd, POLLIN, 0 };
+        const int numReady = poll (&request, 1, shouldWait ? -1 : 0);
+        if (numReady < 0 && errno == EINTR)
+            return true;
+        if (numReady == 0)
+            return false;
+
+        // What's been parsed goes first, so the buffer only holds one message or so
+        m_buffer.erase (m_buffer.begin(), m_buffer.begin() + static_cast<std::ptrdiff_t> (m_start));
+        m_start = 0;
+
+        char chunk[65536];
+        const ssize_t numRead = read (m_fd, chunk, sizeof (chunk));
+        if (numRead < 0 && errno == EINTR)
+            return true;
+        if (numRead <= 0)
+        {
+            m_isClosed = true;
+            return false;
+        }
+        m_buffer.insert (m_buffer.end(), chunk, chunk + numRead);
+        return true;
+    }
+
+    int m_fd;
+    std::vector<char> m_buffer;
+    size_t m_start { 0 };
+    bool m_isClosed { false };
+};
+
+static bool writeAll (const int fd, const std::vector<char>& bytes, const bool isSocket) {
+    size_t written = 0;
+    while (written < bytes.size())
+    {
+        // A worker that has died mustn't take the coordinator with it
+        const ssize_t numWritten = isSocket ? send (fd, bytes.data() + written, bytes.size() - written, MSG_NOSIGNAL)
+                                            : write (fd, bytes.data() + written, bytes.size() - written);
+        if (numWritten < 0 && errno == EINTR)
+            continue;
+        if (numWritten <= 0)
+            return false;
+        written += static_cast<size_t> (numWritten);
+    }
+    return true;
+}
+
+//==============================================================================
+int runTileWorker (const int inputFd, const int outputFd) {
+    MessageReader reader (inputFd);
+    MessageType type;
+    std::vector<char> payload;
+
+    FractalParams params;
+    std::string centreXText, centreYText;
+    if (! reader.next (type, payload, true))
+        return 0;
+    if (type != MessageType::job || ! readJob (payload, params, centreXText, centreYText))
+        return 1;
+
+    if (params.precision == Precision::perturbation && params.formula.isQuadratic())
+    {
+        FixedPoint centreX, centreY;
+        if (! FixedPoint::parse (centreXText, centreX) || ! FixedPoint::parse (centreYText, centreY))
+            return 1;
+        params.reference = std::make_shared<const ReferenceOrbit> (params, centreX, centreY);
+    }
+
+    std::deque<TileFields> tiles;
+    std::vector<int> counts;
+    std::vector<float> magnitudes;
+    std::vector<char> message;
+
+    for (;;)
+    {
+        // Everything that has arrived, so a cancel can catch a tile before it starts
+        while (reader.next (type, payload, tiles.empty()))
+        {
+            TileFields tile;
+            if ((type != MessageType::tile && type != MessageType::cancel)
+                || payload.size() != (type == MessageType::tile ? sizeof (tile) : sizeof (int32_t)))
+                return 1;
+
+            std::memcpy (&tile, payload.data(), payload.size());
+            if (type == MessageType::cancel)
+            {
+                tiles.erase (std::remove_if (tiles.begin(), tiles.end(),
+                                             [&] (const TileFields& queued) { return queued.id == tile.id; }),
+                             tiles.end());
+                continue;
+            }
+
+            if (tile.x < 0 || tile.y < 0 || tile.width <= 0 || tile.height <= 0
+                || tile.x + tile.width > params.width || tile.y + tile.height > params.height)
+                return 1;
+            tiles.push_back (tile);
+        }
+
+        if (reader.isClosed())
+            return 0;
+        if (tiles.empty())
+            continue;
+
+        const auto tile = tiles.front();
+        tiles.pop_front();
+
+        const auto numPixels = static_cast<size_t> (tile.width) * static_cast<size_t> (tile.height);
+        counts.assign (numPixels, 0);
+        magnitudes.assign (numPixels, 0.f);
+        for (int row = 0; row < tile.height; row++)
+        {
+            const auto offset = static_cast<size_t> (row) * static_cast<size_t> (tile.width);
+            calcIterationsRow (params, tile.y + row, tile.x, tile.width,
+                               { counts.data() + offset, magnitudes.data() + offset });
+        }
+
+        const ResultFields result { tile.id, tile.width, tile.height };
+        message.clear();
+        appendMessage (message, MessageType::result, { { &result, sizeof (result) },
+                                                       { counts.data(), numPixels * sizeof (int) },
+                                                       { magnitudes.data(), numPixels * sizeof (float) } });
+
+        if (! writeAll (outputFd, message, false))
+            return 1;
+    }
+}
+
+//==============================================================================
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    // How long a worker has to exit after SIGTERM before its process group is killed
+    constexpr auto stopGracePeriod = std::chrono::milliseconds (500);
+
+    struct Unit
+    {
+        PixelArea area;
+        bool isDone { false };
+        bool isQueued { true };
+    };
+
+    struct Worker
+    {
+        pid_t pid { -1 };
+        int fd { -1 };
+        std::unique_ptr<MessageReader> reader;
+
+        // Tiles sent and not back, the first being the one it's on
+        std::deque<int> tiles;
+        Clock::time_point frontSince;
+    };
+
+    class Coordinator
+    {
+    public:
+        Coordinator (const FractalParams& params, IterationBuffer& iterations, const DistributedOptions& options,
+                     DistributedReport& report)
+            : m_params (params), m_iterations (iterations), m_options (options), m_report (report),
+              m_symmetry (planSymmetry (params)) {
+            constexpr int tileSize = FrameOptions::tileSize;
+            for (int tileY = 0; tileY < params.height; tileY += tileSize)
+            {
+                for (int tileX = 0; tileX < params.width; tileX += tileSize)
+                {
+                    const PixelArea area { tileX, tileY, std::min (tileSize, params.width - tileX),
+                                           std::min (tileSize, params.height - tileY) };
+                    for (const auto& part : m_symmetry.getUniqueParts (area))
+                    {
+                        m_queue.push_back (static_cast<int> (m_units.size()));
+                        m_units.push_back ({ part });
+                    }
+                }
+            }
+            m_report.numTiles = static_cast<int> (m_units.size());
+        }
+
+        ~Coordinator() {
+            // Whatever a worker is still on is a copy nobody needs
+            for (auto& worker : m_workers)
+                stopWorker (worker);
+        }
+
+        bool start (const std::vector<char>& job) {
+            int numWorkers = m_options.numWorkers > 0 ? m_options.numWorkers
+                                                      : static_cast<int> (std::thread::hardware_concurrency());
+            numWorkers = std::clamp (numWorkers, 1, std::max (1, static_cast<int> (m_units.size())));
+
+            for (int i = 0; i < numWorkers; i++)
+            {
+                Worker worker;
+                if (startWorker (worker) && writeAll (worker.fd, job, true))
+                    m_workers.push_back (std::move (worker));
+                else
+                    stopWorker (worker);
+            }
+            m_report.numWorkers = static_cast<int> (m_workers.size());
+            return ! m_workers.empty();
+        }
+
+        bool run() {
+            MessageType type;
+            std::vector<char> payload;
+            std::vector<pollfd> requests;
+
+            while (m_numDone < static_cast<int> (m_units.size()))
+            {
+                for (auto& worker : m_workers)
+                    if (worker.fd >= 0)
+                        feed (worker);
+
+                requests.clear();
+                for (const auto& worker : m_workers)
+                    if (worker.fd >= 0)
+                        requests.push_back ({ worker.fd, POLLIN, 0 });
+                if (requests.empty())
+                    return false;
+
+                // Woken now and then to look for tiles that are overdue
+                if (poll (requests.data(), static_cast<nfds_t> (requests.size()), 100) < 0 && errno != EINTR)
+                    return false;
+
+                for (auto& worker : m_workers)
+                {
+                    if (worker.fd < 0)
+                        continue;
+
+                    while (worker.reader->next (type, payload, false))
+                    {
+                        if (type != MessageType::result || ! takeResult (worker, payload))
+                        {
+                            loseWorker (worker);
+                            break;
+                        }
+                        if (m_options.onProgress != nullptr && ! m_options.onProgress (m_numDone, m_report.numTiles))
+                            return false;
+                    }
+
+                    if (worker.fd >= 0 && worker.reader->isClosed())
+                        loseWorker (worker);
+                }
+
+                sendOverdueAgain();
+            }
+
+            mirrorArea (m_symmetry, m_iterations, { 0, 0, m_params.width, m_params.height });
+            return true;
+        }
+
+    private:
+        bool startWorker (Worker& worker) {
+            int fds[2];
+            if (socketpair (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0)
+                return false;
+
+            const pid_t pid = fork();
+            if (pid < 0)
+            {
+                close (fds[0]);
+                close (fds[1]);
+                return false;
+            }
+
+            if (pid == 0)
+            {
+                // A group of its own, so the shell's children and an ssh's are stopped with it
+                setpgid (0, 0);
+
+                // The child's end becomes its stdin and stdout, the only descriptors exec keeps
+                dup2 (fds[1], STDIN_FILENO);
+                dup2 (fds[1], STDOUT_FILENO);
+                if (m_options.workerCommand.empty())
+                    execl ("/proc/self/exe", "fractal-render", DistributedOptions::workerArgument, static_cast<char*> (nullptr));
+                else
+                    execl ("/bin/sh", "sh", "-c", m_options.workerCommand.c_str(), static_cast<char*> (nullptr));
+                _exit (127);
+            }
+
+            // Set from both sides, so the group exists whichever runs first
+            setpgid (pid, pid);
+            close (fds[1]);
+            worker.pid = pid;
+            worker.fd = fds[0];
+            worker.reader = std::make_unique<MessageReader> (fds[0]);
+            return true;
+        }
+
+        static void stopWorker (Worker& worker) {
+            if (worker.fd >= 0)
+                close (worker.fd);
+            if (worker.pid > 0)
+            {
+                kill (-worker.pid, SIGTERM);
+
+                // Waited on without reaping it, so the group's id can't be reused before the SIGKILL
+                const auto deadline = Clock::now() + stopGracePeriod;
+                siginfo_t info {};
+                while (waitid (P_PID, static_cast<id_t> (worker.pid), &info, WEXITED | WNOHANG | WNOWAIT) == 0
+                       && info.si_pid == 0 && Clock::now() < deadline)
+                    std::this_thread::sleep_for (std::chrono::milliseconds (10));
+
+                // Whatever in the group is left, the worker itself too if it ignored SIGTERM
+                kill (-worker.pid, SIGKILL);
+                waitpid (worker.pid, nullptr, 0);
+            }
+            worker.fd = -1;
+            worker.pid = -1;
+        }
+
+        bool sendMessage (Worker& worker, const MessageType type, const void* payload, const size_t size) {
+            m_message.clear();
+            appendMessage (m_message, type, { { payload, size } });
+            return writeAll (worker.fd, m_message, true);
+        }
+
+        bool holds (const Worker& worker, const int id) const {
+            return std::find (worker.tiles.begin(), worker.tiles.end(), id) != worker.tiles.end();
+        }
+
+        void send (Worker& worker, const int id) {
+            const auto& area = m_units[static_cast<size_t> (id)].area;
+            const TileFields tile { id, area.x, area.y, area.width, area.height };
+            if (worker.tiles.empty())
+                worker.frontSince = Clock::now();
+            worker.tiles.push_back (id);
+            if (! sendMessage (worker, MessageType::tile, &tile, sizeof (tile)))
+                loseWorker (worker);
+        }
+
+        void cancel (Worker& worker, const int id) {
+            const auto found = std::find (worker.tiles.begin(), worker.tiles.end(), id);
+            if (found == worker.tiles.end())
+                return;
+
+            const bool wasFront = found == worker.tiles.begin();
+            worker.tiles.erase (found);
+            if (wasFront)
+                worker.frontSince = Clock::now();
+
+            const int32_t tileId = id;
+            if (! sendMessage (worker, MessageType::cancel, &tileId, sizeof (tileId)))
+                loseWorker (worker);
+        }
+
+        // Tops the worker up from the queue, or failing that from the tiles others have waiting
+        void feed (Worker& worker) {
+            const size_t capacity = static_cast<size_t> (1 + std::max (0, m_options.tilesAhead));
+            while (worker.fd >= 0 && worker.tiles.size() < capacity)
+            {
+                int id = -1;
+                for (auto queued = m_queue.begin(); queued != m_queue.end();)
+                {
+                    auto& unit = m_units[static_cast<size_t> (*queued)];
+                    if (unit.isDone) {
+                        unit.isQueued = false;
+                        queued = m_queue.erase (queued);
+                    } else if (holds (worker, *queued)) {
+                        ++queued;
+                    } else {
+                        id = *queued;
+                        unit.isQueued = false;
+                        m_queue.erase (queued);
+                        break;
+                    }
+                }
+
+                if (id < 0)
+                    id = steal (worker);
+                if (id < 0)
+                    return;
+                send (worker, id);
+            }
+        }
+
+        // The last tile waiting behind the busiest other worker's, which is told to drop it
+        int steal (const Worker& thief) {
+            Worker* victim = nullptr;
+            for (auto& worker : m_workers)
+            {
+                if (&worker == &thief || worker.fd < 0 || worker.tiles.size() < 2 || holds (thief, worker.tiles.back()))
+                    continue;
+                if (victim == nullptr || worker.tiles.size() > victim->tiles.size())
+                    victim = &worker;
+            }
+            if (victim == nullptr)
+                return -1;
+
+            // Idle workers only take tiles while more than one is left, so they don't just trade
+            if (thief.tiles.size() + 1 >= victim->tiles.size())
+                return -1;
+
+            const int id = victim->tiles.back();
+            cancel (*victim, id);
+            m_report.numStolen++;
+            return id;
+        }
+
+        bool takeResult (Worker& worker, const std::vector<char>& payload) {
+            ResultFields result;
+            if (payload.size() < sizeof (result))
+                return false;
+            std::memcpy (&result, payload.data(), sizeof (result));
+
+            if (result.id < 0 || result.id >= static_cast<int> (m_units.size()))
+                return false;
+            auto& unit = m_units[static_cast<size_t> (result.id)];
+            const auto numPixels = static_cast<size_t> (unit.area.width) * static_cast<size_t> (unit.area.height);
+            if (result.width != unit.area.width || result.height != unit.area.height
+                || payload.size() != sizeof (result) + numPixels * (sizeof (int) + sizeof (float)))
+                return false;
+
+            const auto found = std::find (worker.tiles.begin(), worker.tiles.end(), result.id);
+            if (found != worker.tiles.end())
+            {
+                worker.tiles.erase (found);
+                worker.frontSince = Clock::now();
+            }
+
+            // A copy that was sent again, stolen or cancelled too late; the first one back counts
+            if (unit.isDone)
+                return true;
+
+            const char* counts = payload.data() + sizeof (result);
+            const char* magnitudes = counts + numPixels * sizeof (int);
+            const auto rowCounts = static_cast<size_t> (unit.area.width) * sizeof (int);
+            const auto rowMagnitudes = static_cast<size_t> (unit.area.width) * sizeof (float);
+            for (int row = 0; row < unit.area.height; row++)
+            {
+                const int y = unit.area.y + row;
+                std::memcpy (m_iterations.getCounts (y) + unit.area.x, counts + static_cast<size_t> (row) * rowCounts, rowCounts);
+                std::memcpy (m_iterations.getMagnitudes (y) + unit.area.x,
+                             magnitudes + static_cast<size_t> (row) * rowMagnitudes, rowMagnitudes);
+            }
+
+            unit.isDone = true;
+            m_numDone++;
+
+            for (auto& other : m_workers)
+                if (&other != &worker && other.fd >= 0)
+                    cancel (other, result.id);
+            return true;
+        }
+
+        void requeue (const int id) {
+            auto& unit = m_units[static_cast<size_t> (id)];
+            if (unit.isDone || unit.isQueued)
+                return;
+            unit.isQueued = true;
+            m_queue.push_front (id);
+        }
+
+        void loseWorker (Worker& worker) {
+            if (worker.fd < 0)
+                return;
+
+            stopWorker (worker);
+            m_report.numWorkersLost++;
+
+            // Another worker may have a copy, but it could be the next to go
+            for (const int id : worker.tiles)
+                requeue (id);
+            worker.tiles.clear();
+        }
+
+        void sendOverdueAgain() {
+            const auto now = Clock::now();
+            const auto timeout = std::chrono::duration<double> (m_options.tileTimeoutSeconds);
+
+            for (auto& worker : m_workers)
+            {
+                if (worker.fd < 0 || worker.tiles.empty() || now - worker.frontSince < timeout)
+                    continue;
+
+                // The slow worker keeps its copy, in case it's nearly there
+                const int id = worker.tiles.front();
+                if (! m_units[static_cast<size_t> (id)].isQueued)
+                {
+                    requeue (id);
+                    m_report.numSentAgain++;
+                }
+                worker.frontSince = now;
+            }
+        }
+
+        const FractalParams& m_params;
+        IterationBuffer& m_iterations;
+        const DistributedOptions& m_options;
+        DistributedReport& m_report;
+        const SymmetryPlan m_symmetry;
+
+        std::vector<Unit> m_units;
+        std::deque<int> m_queue;
+        int m_numDone { 0 };
+        std::vector<Worker> m_workers;
+        std::vector<char> m_message;
+    };
+}
+
+bool renderDistributed (const FractalParams& params, const std::string& centreXText, const std::string& centreYText,
+                        IterationBuffer& iterations, const DistributedOptions& options, DistributedReport* report) {
+    DistributedReport localReport;
+    auto& target = report != nullptr ? *report : localReport;
+    target = {};
+
+    if (params.width <= 0 || params.height <= 0)
+        return false;
+
+    Coordinator coordinator (params, iterations, options, target);
+    return coordinator.start (makeJob (params, centreXText, centreYText)) && coordinator.run();
+}
+
+#endif
@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+
+    DistributedRenderer.h
+    Created: 25 Oct 2026 6:40:15pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include "EscapeTime.h"
+#include "IterationBuffer.h"
+
+//==============================================================================
+/*
+    Iterates a frame in several worker processes instead of threads, for
+    renders bigger than one process should take on. Linux only.
+
+    The coordinator splits the frame into the same square tiles as
+    renderFrame(), less the halves a mirror image will fill in, and keeps
+    each worker a few tiles ahead of the one it is on. Workers take one
+    tile at a time, iterate it on a single thread and send back its counts
+    and magnitudes, which go straight into the caller's buffer.
+
+    Once the queue runs dry, a worker with nothing to do takes a tile still
+    waiting behind another worker's, which is told to drop it. A tile that
+    hasn't come back within tileTimeoutSeconds goes to the next idle worker
+    as well, and a worker that dies has its tiles handed out again, so one
+    slow or broken process only costs its own tiles. The first copy of a
+    tile back is kept and the others are cancelled.
+
+    Coordinator and worker talk over a byte stream, so a worker can be any
+    command that ends up in runTileWorker() with the stream on its stdin and
+    stdout: another copy of this program, or the same through ssh on
+    another host with the same build. Every message is a type and a length
+    in native byte order, then its payload:
+
+        job      the frame's FractalParams and its centre as text, first
+        tile     an id and the pixel area to iterate
+        cancel   an id, to drop if the tile hasn't started
+        result   an id, the area's size, its int32 counts then float32 |z|
+
+    Perturbation renders make their reference orbits again in each worker,
+    from the centre text.
+*/
+struct DistributedOptions
+{
+    // Worker processes to start; 0 means one per hardware thread
+    int numWorkers { 0 };
+
+    /*  The command each worker is started with, run by /bin/sh; empty runs
+        this program again with workerArgument. Each worker gets a process
+        group of its own, so stopping it stops whatever the command started.
+    */
+    std::string workerCommand;
+
+    // Tiles sent to a worker behind the one it is on, so it never waits for the next
+    int tilesAhead { 2 };
+
+    // A tile that hasn't come back this long after its worker took it is sent out again
+    double tileTimeoutSeconds { 60.0 };
+
+    // Called on the calling thread as tiles come in; returning false stops the render
+    std::function<bool (int tilesDone, int numTiles)> onProgress;
+
+    static constexpr const char* workerArgument = "--worker";
+};
+
+// What happened to the tiles, for reporting
+struct DistributedReport
+{
+    int numWorkers { 0 };
+    int numTiles { 0 };
+    int numStolen { 0 };
+    int numSentAgain { 0 };
+    int numWorkersLost { 0 };
+};
+
+/*  Returns false if no worker could be started, every worker died, or
+    onProgress stopped the render, in which case the buffer holds whatever
+    tiles came back. The centre text is what perturbation workers start from.
+*/
+bool renderDistributed (const FractalParams& params, const std::string& centreXText, const std::string& centreYText,
+                        IterationBuffer& iterations, const DistributedOptions& options = {},
+                        DistributedReport* report = nullptr);
+
+/*  The worker's side: reads a job and tiles from inputFd and writes results
+    to outputFd until the coordinator closes the stream. Returns the exit
+    status for the process, 0 unless the stream held something unexpected.
+*/
+int runTileWorker (const int inputFd, const int outputFd);
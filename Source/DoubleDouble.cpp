@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    DoubleDouble.cpp
+    Created: 21 Oct 2026 10:22:37am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "DoubleDouble.h"
+
+// A fused multiply-add would swallow the rounding errors twoSum() and
+// twoProduct() exist to recover
+#if defined(__clang__)
+ #pragma clang fp contract (off)
+#elif defined(__GNUC__)
+ #pragma GCC optimize ("fp-contract=off")
+#endif
+
+template <int power, FormulaVariant variant>
+static void iterateDoubleDouble (DoubleDouble& zRe, DoubleDouble& zIm, const DoubleDouble& cRe, const DoubleDouble& cIm,
+                                 int& nIterations, const int maxIterations) noexcept {
+    DoubleDouble savedRe = zRe, savedIm = zIm;
+    int stepsSinceSave = 0, saveInterval = 1;
+
+    while (nIterations <= maxIterations && zRe.hi * zRe.hi + zIm.hi * zIm.hi < 4.0)
+    {
+        stepFormula<power, variant, DoubleDoubleMaths> (zRe, zIm, cRe, cIm);
+        nIterations++;
+
+        if (zRe.hi == savedRe.hi && zRe.lo == savedRe.lo && zIm.hi == savedIm.hi && zIm.lo == savedIm.lo)
+        {
+            nIterations = maxIterations + 1;
+            break;
+        }
+        if (++stepsSinceSave == saveInterval)
+        {
+            savedRe = zRe;
+            savedIm = zIm;
+            stepsSinceSave = 0;
+            saveInterval *= 2;
+        }
+    }
+}
+
+void calcIterationsDoubleDouble (const FractalParams& params, const int x, const int y,
+                                 const OrbitResults& results) noexcept {
+    const bool isJulia = params.type == FractalType::julia;
+
+    // The pixel offset times the pixel size is exact as a double-double
+    const DoubleDouble pointX = DoubleDouble { params.centreX, params.centreXLow }
+                              + twoProduct (x - params.width * 0.5, params.pixelSize);
+    const DoubleDouble pointY = DoubleDouble { params.centreY, params.centreYLow }
+                              + twoProduct (y - params.height * 0.5, params.pixelSize);
+
+    DoubleDouble zRe = isJulia ? pointX : DoubleDouble();
+    DoubleDouble zIm = isJulia ? pointY : DoubleDouble();
+    const DoubleDouble cRe = isJulia ? DoubleDouble { params.cRe, 0.0 } : pointX;
+    const DoubleDouble cIm = isJulia ? DoubleDouble { params.cIm, 0.0 } : pointY;
+
+    int nIterations = params.minIterations;
+
+    // The same shortcuts as the double kernels: the cardioid test is only
+    // ever wrong right on the boundary, and an exact repeat is a cycle
+    // however many bits the numbers have
+    const double yy = cIm.hi * cIm.hi, xq = cRe.hi - 0.25, q = xq * xq + yy;
+    const bool isInterior = ! isJulia && params.formula.isQuadratic()
+                         && (q * (q + xq) < 0.25 * yy || (cRe.hi + 1.0) * (cRe.hi + 1.0) + yy < 0.0625);
+
+    if (isInterior)
+        nIterations = params.maxIterations + 1;
+    else
+        withFormula (params.formula, [&] (auto power, auto variant)
+        {
+            iterateDoubleDouble<decltype (power)::value, decltype (variant)::value> (zRe, zIm, cRe, cIm, nIterations,
+                                                                                     params.maxIterations);
+        });
+
+    results.nIterations[0] = nIterations;
+    if (results.finalMagnitudes != nullptr) results.finalMagnitudes[0] = magnitudeOf (zRe.hi, zIm.hi);
+    if (results.finalRe != nullptr)         results.finalRe[0] = zRe.hi;
+    if (results.finalIm != nullptr)         results.finalIm[0] = zIm.hi;
+}
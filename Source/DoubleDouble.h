@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    DoubleDouble.h
+    Created: 21 Oct 2026 10:22:37am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "EscapeTime.h"
+
+//==============================================================================
+/*
+    A number held as the unevaluated sum of two doubles, hi + lo with
+    |lo| <= half an ulp of hi, giving about 106 bits. The error-free sum and
+    product below depend on every operation being rounded on its own, so
+    code using them must be compiled without floating-point contraction.
+*/
+struct DoubleDouble
+{
+    double hi { 0.0 }, lo { 0.0 };
+};
+
+// a + b exactly, for any a and b
+inline DoubleDouble twoSum (const double a, const double b) noexcept {
+    const double sum = a + b;
+    const double bPart = sum - a;
+    return { sum, (a - (sum - bPart)) + (b - bPart) };
+}
+
+// a + b exactly when |a| >= |b|
+inline DoubleDouble quickTwoSum (const double a, const double b) noexcept {
+    const double sum = a + b;
+    return { sum, b - (sum - a) };
+}
+
+// a * b exactly, by Dekker's splitting into 26-bit halves
+inline DoubleDouble twoProduct (const double a, const double b) noexcept {
+    constexpr double splitter = 134217729.0; // 2^27 + 1
+    const double aScaled = splitter * a, bScaled = splitter * b;
+    const double aHi = aScaled - (aScaled - a), aLo = a - aHi;
+    const double bHi = bScaled - (bScaled - b), bLo = b - bHi;
+    const double product = a * b;
+    return { product, ((aHi * bHi - product) + aHi * bLo + aLo * bHi) + aLo * bLo };
+}
+
+inline DoubleDouble operator+ (const DoubleDouble& a, const DoubleDouble& b) noexcept {
+    const DoubleDouble sum = twoSum (a.hi, b.hi);
+    return quickTwoSum (sum.hi, sum.lo + a.lo + b.lo);
+}
+
+inline DoubleDouble operator- (const DoubleDouble& a) noexcept {
+    return { -a.hi, -a.lo };
+}
+
+inline DoubleDouble operator- (const DoubleDouble& a, const DoubleDouble& b) noexcept {
+    return a + -b;
+}
+
+inline DoubleDouble operator* (const DoubleDouble& a, const DoubleDouble& b) noexcept {
+    const DoubleDouble product = twoProduct (a.hi, b.hi);
+    return quickTwoSum (product.hi, product.lo + (a.hi * b.lo + a.lo * b.hi));
+}
+
+// What the formula templates in Formula.h need besides arithmetic
+struct DoubleDoubleMaths
+{
+    static void makeAbsolute (DoubleDouble& a) noexcept   { if (a.hi < 0.0) a = -a; }
+};
+
+/*  Iterates pixel (x, y) in double-double from params.centreX + centreXLow
+    and stores the result in the first entry of results. Counts follow
+    calcIterations(), including the interior shortcuts.
+*/
+void calcIterationsDoubleDouble (const FractalParams& params, const int x, const int y,
+                                 const OrbitResults& results) noexcept;
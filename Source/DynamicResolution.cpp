@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    DynamicResolution.cpp
+    Created: 25 Oct 2026 5:12:44pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "DynamicResolution.h"
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+//==============================================================================
+// Fractions of the display's scale to drop to while interacting, largest first
+static constexpr double interactiveFactors[] = { 1.0, 0.75, 0.5, 0.375, 0.25 };
+
+// A scale is only stepped up to when it's predicted to take this much of the target or less
+static constexpr double stepUpMargin = 0.7;
+
+// How far each timed frame moves the average towards itself
+static constexpr double smoothing = 0.3;
+
+DynamicResolution::DynamicResolution() {}
+
+DynamicResolution::~DynamicResolution() {
+    stopTimer();
+}
+
+bool DynamicResolution::setDisplayScale(const double scale) {
+    if (scale <= 0.0 || scale == m_displayScale)
+        return false;
+
+    // Times per pixel don't depend on the display, so the average carries over
+    m_displayScale = scale;
+    m_interactiveScale = scale;
+    if (m_isInteracting)
+        chooseInteractiveScale();
+    return true;
+}
+
+void DynamicResolution::setTargetFrameMs(const double milliseconds) {
+    m_targetFrameMs = juce::jmax(1.0, milliseconds);
+}
+
+void DynamicResolution::interacted() {
+    if (! m_isInteracting) {
+        m_isInteracting = true;
+        chooseInteractiveScale();
+    }
+    startTimer(idleDelayMs);
+}
+
+void DynamicResolution::timerCallback() {
+    stopTimer();
+    m_isInteracting = false;
+    if (onIdle != nullptr)
+        onIdle();
+}
+
+//==============================================================================
+void DynamicResolution::addFrame(const FrameStats& frame, const double scale,
+                                 const int logicalWidth, const int logicalHeight) {
+    m_logicalWidth = logicalWidth;
+    m_logicalHeight = logicalHeight;
+
+    // A frame that was replaced is timed as far as it got, which errs on the slow side
+    if (frame.frame != m_latest.frame && ! m_latestIsTimed) {
+        timeFrame(m_latest, m_latestScale);
+        m_latestIsTimed = true;
+    }
+
+    if (frame.frame < 0 || std::strcmp(frame.kind, "render") != 0)
+        return;
+
+    m_latest = frame;
+    m_latestScale = scale;
+    m_latestIsTimed = frame.isFinished;
+    if (frame.isFinished)
+        timeFrame(frame, scale);
+}
+
+void DynamicResolution::timeFrame(const FrameStats& frame, const double scale) {
+    // Tiles from the cache cost nothing, so the time goes on the pixels iterated
+    if (frame.numPixels <= 0)
+        return;
+
+    const double msPerPixel = frame.durationMs / static_cast<double>(frame.numPixels);
+    m_msPerPixel = m_msPerPixel > 0.0 ? m_msPerPixel + smoothing * (msPerPixel - m_msPerPixel) : msPerPixel;
+    m_lastFrameMs = frame.durationMs;
+    m_lastFrameScale = scale;
+
+    if (m_isInteracting)
+        chooseInteractiveScale();
+}
+
+double DynamicResolution::predictFrameMs(const double scale) const noexcept {
+    return m_msPerPixel * getScaledSize(m_logicalWidth, scale) * getScaledSize(m_logicalHeight, scale);
+}
+
+void DynamicResolution::chooseInteractiveScale() {
+    // Nothing timed yet, so the first drag starts sharp and finds its level from there
+    if (m_msPerPixel <= 0.0)
+        return;
+
+    for (const double factor : interactiveFactors) {
+        const double scale = m_displayScale * factor;
+        const double budget = scale > m_interactiveScale ? m_targetFrameMs * stepUpMargin : m_targetFrameMs;
+        if (predictFrameMs(scale) <= budget) {
+            m_interactiveScale = scale;
+            return;
+        }
+    }
+    m_interactiveScale = m_displayScale * interactiveFactors[std::size(interactiveFactors) - 1];
+}
+
+//==============================================================================
+juce::String DynamicResolution::getDescription() const {
+    const juce::String state = m_isInteracting ? " (drag)" : "";
+    return "scale " + juce::String(m_lastFrameScale, 2) + " of " + juce::String(m_displayScale, 2) + state
+         + ", " + juce::String(m_lastFrameMs, 1) + " / " + juce::String(m_targetFrameMs, 1) + " ms";
+}
+
+int DynamicResolution::getScaledSize(const int logicalSize, const double scale) {
+    return logicalSize > 0 ? juce::jmax(1, juce::roundToInt(logicalSize * scale)) : 0;
+}
+
+juce::Rectangle<int> DynamicResolution::toLogical(const juce::Rectangle<int>& area, const double scale) {
+    return juce::Rectangle<int>::leftTopRightBottom(static_cast<int>(std::floor(area.getX() / scale)),
+                                                    static_cast<int>(std::floor(area.getY() / scale)),
+                                                    static_cast<int>(std::ceil(area.getRight() / scale)),
+                                                    static_cast<int>(std::ceil(area.getBottom() / scale)));
+}
@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    DynamicResolution.h
+    Created: 25 Oct 2026 5:12:44pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RenderStats.h"
+
+//==============================================================================
+/*
+    Picks the resolution a box renders at, as a scale from its logical size.
+
+    At rest a box renders at the display's scale, one pixel per physical
+    pixel, so HiDPI screens get sharp images. While the user is dragging or
+    zooming it drops to the largest scale whose frames are predicted to fit
+    the target time, judged by how long the engine's recent frames took per
+    pixel. The scales come from a short ladder below the display's, so a
+    drag settles on one instead of hunting, and a scale is only stepped up
+    when the prediction is well inside the target.
+
+    Once input has been quiet for idleDelayMs, onIdle is called so the box
+    can render again at the display's scale.
+*/
+class DynamicResolution : private juce::Timer
+{
+public:
+    DynamicResolution();
+    ~DynamicResolution() override;
+
+    // Physical pixels per logical one; returns true if it changed
+    bool setDisplayScale(const double scale);
+    double getDisplayScale() const noexcept { return m_displayScale; }
+
+    void setTargetFrameMs(const double milliseconds);
+    double getTargetFrameMs() const noexcept { return m_targetFrameMs; }
+
+    // Call on every input that re-renders, before asking for the frame
+    void interacted();
+    bool isInteracting() const noexcept { return m_isInteracting; }
+
+    // The scale to render the next frame at
+    double getScale() const noexcept { return m_isInteracting ? m_interactiveScale : m_displayScale; }
+
+    /*  The engine's latest frame, finished or not, the scale it was rendered
+        at and the logical size of the box. Call it whenever tiles are
+        published; frames other than renders are left out.
+    */
+    void addFrame(const FrameStats& frame, const double scale, const int logicalWidth, const int logicalHeight);
+
+    // What a frame at this scale is predicted to take, 0 until a frame has been timed
+    double predictFrameMs(const double scale) const noexcept;
+
+    // The last frame's scale and time, for the stats overlay
+    juce::String getDescription() const;
+
+    std::function<void()> onIdle;
+
+    // Pixels across a logical size at a scale, never 0 unless the size is
+    static int getScaledSize(const int logicalSize, const double scale);
+
+    // An area of an image at a scale, as the logical pixels it covers
+    static juce::Rectangle<int> toLogical(const juce::Rectangle<int>& area, const double scale);
+
+    static constexpr int idleDelayMs = 200;
+
+private:
+    void timerCallback() override;
+    void timeFrame(const FrameStats& frame, const double scale);
+    void chooseInteractiveScale();
+
+    double m_displayScale {1.0};
+    double m_interactiveScale {1.0};
+    double m_targetFrameMs {1000.0 / 30.0};
+    bool m_isInteracting {false};
+
+    int m_logicalWidth {0}, m_logicalHeight {0};
+
+    // The render in flight, timed once it finishes or something replaces it
+    FrameStats m_latest;
+    double m_latestScale {1.0};
+    bool m_latestIsTimed {true};
+
+    // Wall time per pixel iterated, averaged over recent frames
+    double m_msPerPixel {0.0};
+    double m_lastFrameMs {0.0};
+    double m_lastFrameScale {1.0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (DynamicResolution)
+};
@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+    EscapeTime.h
+    Created: 17 Oct 2026 9:12:05am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <vector>
+#include "Formula.h"
+
+class ReferenceOrbit;
+
+enum class FractalType
+{
+    mandelbrot,
+    julia
+};
+
+// Ordered so that a higher level can always run the code of a lower one
+enum class SimdLevel
+{
+    scalar,
+    sse2,
+    avx2,
+    avx512
+};
+
+/*  How pixels are iterated, from the cheapest to the one that reaches
+    deepest. choosePrecision() picks the cheapest that resolves a view.
+*/
+enum class Precision
+{
+    float32,        // twice the SIMD lanes of double; fine for shallow views
+    float64,
+    doubleDouble,   // about 106 bits, scalar
+    perturbation    // offsets from a high precision reference orbit, see Perturbation.h
+};
+
+//==============================================================================
+/*
+    A snapshot of everything needed to iterate one frame. The boxes fill one of
+    these on the message thread and hand it to the render engine, so worker
+    threads never read component state.
+*/
+struct FractalParams
+{
+    FractalType type { FractalType::mandelbrot };
+    Formula formula;
+
+    // Julia constant, ignored for the Mandelbrot set
+    double cRe { 0.0 }, cIm { 0.0 };
+
+    // Maths coordinate of the image centre and the size of one (square) pixel
+    double centreX { 0.0 }, centreY { 0.0 };
+    double pixelSize { 0.0 };
+
+    // What the centre is short of its exact value, for the double-double tier
+    double centreXLow { 0.0 }, centreYLow { 0.0 };
+
+    int width { 0 }, height { 0 };
+    int minIterations { 1 }, maxIterations { 40 };
+
+    Precision precision { Precision::float64 };
+
+    // The orbit of the image centre that Precision::perturbation iterates
+    // pixels against; without one those frames use doubleDouble instead
+    std::shared_ptr<const ReferenceOrbit> reference;
+
+    double mathX (const int x) const noexcept  { return centreX + (x - width * 0.5) * pixelSize; }
+    double mathY (const int y) const noexcept  { return centreY + (y - height * 0.5) * pixelSize; }
+
+    // The inverse mapping, in fractional pixels
+    double pixelX (const double mathX) const noexcept  { return (mathX - centreX) / pixelSize + width * 0.5; }
+    double pixelY (const double mathY) const noexcept  { return (mathY - centreY) / pixelSize + height * 0.5; }
+
+    // Sizes pixels so that span maths units fit across the shorter side
+    void fitToSpan (const double span) noexcept
+    {
+        pixelSize = span / (width < height ? width : height);
+    }
+};
+
+/*  The cheapest precision that resolves pixels of params.pixelSize.
+    canPerturb says whether the caller can build a reference orbit; if not,
+    views deeper than doubles get doubleDouble, which blurs past about 1e-28.
+*/
+Precision choosePrecision (const FractalParams& params, const bool canPerturb) noexcept;
+
+/*  Runs the escape-time loop for pixel (x, y) and returns the raw loop count,
+    which is maxIterations + 1 for points that never escaped. If finalMagnitude
+    is given it receives |z| where the loop stopped, for smooth colouring.
+*/
+int calcIterations (const FractalParams& params, const int x, const int y,
+                    float* finalMagnitude = nullptr) noexcept;
+
+/*  The orbit of z = 0 under the formula with c = point, one entry per step,
+    stopping after maxSteps or once z has left the radius 2 circle.
+*/
+std::vector<std::complex<double>> calcOrbit (const std::complex<double> point, const int maxSteps,
+                                             const Formula& formula = {});
+
+// The same, into a vector whose storage is reused from call to call
+void calcOrbit (const std::complex<double> point, const int maxSteps, std::vector<std::complex<double>>& orbit,
+                const Formula& formula = {});
+
+/*  |z| as the kernels report it: the square root of the same re^2 + im^2 the
+    vector kernels compare, so every kernel gives bit-identical magnitudes.
+*/
+inline float magnitudeOf (const double re, const double im) noexcept
+{
+    return static_cast<float> (std::sqrt (re * re + im * im));
+}
+
+/*  Whether c is inside the main cardioid or the period-2 bulb of the
+    Mandelbrot set, where the orbit of z = 0 never escapes.
+*/
+inline bool isInMainCardioidOrBulb (const double x, const double y) noexcept
+{
+    const double yy = y * y;
+    const double xq = x - 0.25;
+    const double q = xq * xq + yy;
+    return q * (q + xq) < 0.25 * yy || (x + 1.0) * (x + 1.0) + yy < 0.0625;
+}
+
+/*  Maps a raw loop count to the 0-255 shade used for colouring, 0 meaning the
+    point is treated as inside the set.
+*/
+int shadeFromIterations (const int nIterations, const int maxIterations) noexcept;
+
+/*  Where a batch of orbits ends up. Only nIterations is required; the other
+    outputs are skipped when null.
+*/
+struct OrbitResults
+{
+    int* nIterations { nullptr };
+    float* finalMagnitudes { nullptr };
+
+    // Final z, which is what a later, deeper pass resumes from
+    double* finalRe { nullptr };
+    double* finalIm { nullptr };
+
+    OrbitResults offsetBy (const int numOrbits) const noexcept
+    {
+        auto advance = [numOrbits] (auto* p) { return p != nullptr ? p + numOrbits : nullptr; };
+        return { advance (nIterations), advance (finalMagnitudes), advance (finalRe), advance (finalIm) };
+    }
+};
+
+/*  A run of independent orbits to iterate side by side. Every orbit starts
+    from its own z and c with the same loop count, so a fresh pixel starts at
+    minIterations and a resumed one at the previous maxIterations + 1.
+*/
+struct OrbitBatch
+{
+    int numOrbits { 0 };
+    int firstIteration { 1 };
+    Formula formula;
+
+    // The orbits started from z = 0, so points inside the main cardioid or
+    // the period-2 bulb can be rejected without iterating. Only z^2 + c
+    // has those, so other formulas ignore it.
+    bool isMandelbrot { false };
+
+    // Iterate in float, with twice as many orbits per vector. Inputs are
+    // rounded to float on the way in and results widened on the way out, so
+    // a float orbit resumed from its final z carries on exactly.
+    bool useFloats { false };
+
+    const double* zRe { nullptr };
+    const double* zIm { nullptr };
+    const double* cRe { nullptr };
+    const double* cIm { nullptr };
+
+    OrbitResults results;
+};
+
+/*  Best vector instruction set this CPU supports, detected once at startup. */
+SimdLevel getSimdLevel() noexcept;
+
+/*  Iterates every orbit in the batch up to maxIterations, several at a time.
+    Counts, magnitudes and final z values are identical to running the scalar
+    loop of the same precision on each orbit. Asking for a level above what the CPU supports falls
+    back to the best available one.
+*/
+void iterateOrbits (const OrbitBatch& batch, const int maxIterations,
+                    SimdLevel level = getSimdLevel()) noexcept;
+
+/*  Iterates the pixels (x, y), (x + xStep, y), (x + 2 * xStep, y)... through
+    iterateOrbits(). The counts are identical to calling calcIterations() per
+    pixel. The double-double and perturbation tiers have no batch kernels
+    and go one pixel at a time.
+*/
+void calcIterationsRow (const FractalParams& params, const int y, const int x,
+                        const int numPixels, const OrbitResults& results,
+                        const int xStep = 1, SimdLevel level = getSimdLevel()) noexcept;
@@ -0,0 +1,1221 @@
+/*
+  ==============================================================================
+
+    EscapeTimeSimd.cpp
+    Created: 17 Oct 2026 11:02:17am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "EscapeTime.h"
+#include "DoubleDouble.h"
+#include "Perturbation.h"
+#include <complex>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #define FRACTAL_HAS_X86_SIMD 1
+ #include <immintrin.h>
+ #if defined(_MSC_VER) && ! defined(__clang__)
+  #include <intrin.h>
+ #endif
+#else
+ #define FRACTAL_HAS_X86_SIMD 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+ #define FRACTAL_TARGET(isa) __attribute__((target (isa)))
+#else
+ #define FRACTAL_TARGET(isa)
+#endif
+
+// The AVX-512 target enables FMA, and a fused multiply-add rounds differently
+// from the separate multiply and add the scalar path does.
+#if defined(__clang__)
+ #pragma clang fp contract (off)
+#elif defined(__GNUC__)
+ #pragma GCC optimize ("fp-contract=off")
+#endif
+
+// The formula kernels' wide vectors never cross a call, as everything they
+// use is inlined, so GCC's notes on how those would be passed don't apply
+#if defined(__GNUC__) && ! defined(__clang__)
+ #pragma GCC diagnostic ignored "-Wpsabi"
+#endif
+
+/*  The vector kernels compare |z|^2 against 4 instead of taking a square root.
+    Both sides of that comparison are rounded differently from the scalar
+    abs(z) < 2, so lanes whose squared magnitude lands within a hair of 4 are
+    re-checked with the scalar test. That keeps every count identical to
+    calcIterations() while costing one extra compare per step.
+*/
+static constexpr double normBelow = 4.0 - 1.0e-12;
+static constexpr double normAbove = 4.0 + 1.0e-12;
+
+static inline bool magnitudeBelowTwo (const double re, const double im) noexcept {
+    return abs(std::complex<double>(re, im)) < 2;
+}
+
+/*  Interior points cost the whole iteration budget, so two shortcuts stop
+    them early without changing any count:
+
+    - Mandelbrot points inside the main cardioid or the period-2 bulb are
+      known never to escape, so they are rejected before iterating. Rounding
+      can only misjudge points so close to the boundary that they would take
+      far longer than any iteration limit to escape.
+    - Brent's cycle detection: z is saved at steps 1, 2, 4, 8... and compared
+      with every later z. The loop is deterministic, so once z repeats exactly
+      the orbit is stuck in a cycle and can never escape.
+
+    Either way the point gets the count of one that ran out of iterations.
+*/
+static void storeResult (const OrbitResults& results, const int i, const int nIterations,
+                         const double re, const double im) noexcept {
+    results.nIterations[i] = nIterations;
+    if (results.finalMagnitudes != nullptr) results.finalMagnitudes[i] = magnitudeOf (re, im);
+    if (results.finalRe != nullptr)         results.finalRe[i] = re;
+    if (results.finalIm != nullptr)         results.finalIm[i] = im;
+}
+
+static void iterateScalar (const OrbitBatch& batch, const int first, const int maxIterations) noexcept {
+    for (int i = first; i < batch.numOrbits; i++)
+    {
+        std::complex<double> complexZ (batch.zRe[i], batch.zIm[i]);
+        const std::complex<double> complexPoint (batch.cRe[i], batch.cIm[i]);
+
+        if (batch.isMandelbrot && isInMainCardioidOrBulb (complexPoint.real(), complexPoint.imag()))
+        {
+            storeResult (batch.results, i, maxIterations + 1, complexZ.real(), complexZ.imag());
+            continue;
+        }
+
+        std::complex<double> savedZ (complexZ);
+        int stepsSinceSave = 0, saveInterval = 1;
+
+        int nIterations = batch.firstIteration;
+        while ((abs(complexZ) < 2 ) && ( nIterations <= maxIterations ))
+        {
+            complexZ = complexZ * complexZ + complexPoint;
+            nIterations++;
+
+            if (complexZ == savedZ)
+            {
+                nIterations = maxIterations + 1;
+                break;
+            }
+            if (++stepsSinceSave == saveInterval)
+            {
+                savedZ = complexZ;
+                stepsSinceSave = 0;
+                saveInterval *= 2;
+            }
+        }
+        storeResult (batch.results, i, nIterations, complexZ.real(), complexZ.imag());
+    }
+}
+
+/*  The float loop compares |z|^2 < 4 directly in every kernel, scalar
+    included, so unlike the double kernels no lane needs re-checking.
+*/
+static inline bool isInMainCardioidOrBulbFloat (const float x, const float y) noexcept {
+    const float yy = y * y;
+    const float xq = x - 0.25f;
+    const float q = xq * xq + yy;
+    return q * (q + xq) < 0.25f * yy || (x + 1.0f) * (x + 1.0f) + yy < 0.0625f;
+}
+
+static void iterateScalarFloat (const OrbitBatch& batch, const int first, const int maxIterations) noexcept {
+    for (int i = first; i < batch.numOrbits; i++)
+    {
+        float zx = static_cast<float> (batch.zRe[i]);
+        float zy = static_cast<float> (batch.zIm[i]);
+        const float cx = static_cast<float> (batch.cRe[i]);
+        const float cy = static_cast<float> (batch.cIm[i]);
+
+        int nIterations = batch.firstIteration;
+        float norm = 0.0f;
+        bool hasEscaped = false;
+
+        if (batch.isMandelbrot && isInMainCardioidOrBulbFloat (cx, cy))
+        {
+            nIterations = maxIterations + 1;
+        }
+        else
+        {
+            float savedX = zx, savedY = zy;
+            int stepsSinceSave = 0, saveInterval = 1;
+
+            while (nIterations <= maxIterations)
+            {
+                const float xx = zx * zx, yy = zy * zy, xy = zx * zy;
+                norm = xx + yy;
+                hasEscaped = ! (norm < 4.0f);
+                if (hasEscaped)
+                    break;
+
+                zx = xx - yy + cx;
+                zy = xy + xy + cy;
+                nIterations++;
+
+                if (zx == savedX && zy == savedY)
+                {
+                    nIterations = maxIterations + 1;
+                    break;
+                }
+                if (++stepsSinceSave == saveInterval)
+                {
+                    savedX = zx;
+                    savedY = zy;
+                    stepsSinceSave = 0;
+                    saveInterval *= 2;
+                }
+            }
+        }
+
+        if (! hasEscaped)
+            norm = zx * zx + zy * zy;
+
+        batch.results.nIterations[i] = nIterations;
+        if (batch.results.finalMagnitudes != nullptr) batch.results.finalMagnitudes[i] = std::sqrt (norm);
+        if (batch.results.finalRe != nullptr)         batch.results.finalRe[i] = zx;
+        if (batch.results.finalIm != nullptr)         batch.results.finalIm[i] = zy;
+    }
+}
+
+//==============================================================================
+/*  Other formulas go through one loop, written once over a lane type and
+    instantiated per formula and instruction set, so the power and fold are
+    baked into each kernel instead of being decided per pixel. There is no
+    interior test, which only z^2 + c has, but cycle detection works for any
+    formula. Scalar and vector instantiations compare |z|^2 < 4 the same
+    way, so their counts agree.
+*/
+#if defined(__GNUC__) || defined(__clang__)
+ #define FRACTAL_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+ #define FRACTAL_ALWAYS_INLINE inline
+#endif
+
+namespace
+{
+    template <typename RealType>
+    struct ScalarLanes
+    {
+        using Real = RealType;
+        using Value = Real;
+        using Mask = bool;
+        static constexpr int size = 1;
+
+        static FRACTAL_ALWAYS_INLINE Value load (const double* source) noexcept                 { return static_cast<Real> (*source); }
+        static FRACTAL_ALWAYS_INLINE void store (double* destination, const Value v) noexcept   { *destination = v; }
+        static FRACTAL_ALWAYS_INLINE Value broadcast (const Real value) noexcept                { return value; }
+        static FRACTAL_ALWAYS_INLINE void makeAbsolute (Value& v) noexcept                      { v = std::abs (v); }
+
+        static FRACTAL_ALWAYS_INLINE Mask all() noexcept                                        { return true; }
+        static FRACTAL_ALWAYS_INLINE Mask none() noexcept                                       { return false; }
+        static FRACTAL_ALWAYS_INLINE Mask andNot (const Mask a, const Mask b) noexcept          { return ! a && b; }
+        static FRACTAL_ALWAYS_INLINE Mask both (const Mask a, const Mask b) noexcept            { return a && b; }
+        static FRACTAL_ALWAYS_INLINE Mask either (const Mask a, const Mask b) noexcept          { return a || b; }
+        static FRACTAL_ALWAYS_INLINE bool any (const Mask m) noexcept                           { return m; }
+        static FRACTAL_ALWAYS_INLINE bool isSet (const Mask m, int) noexcept                    { return m; }
+        static FRACTAL_ALWAYS_INLINE Real lane (const Value v, int) noexcept                    { return v; }
+        static FRACTAL_ALWAYS_INLINE Value select (const Mask m, const Value ifTrue, const Value ifFalse) noexcept
+        {
+            return m ? ifTrue : ifFalse;
+        }
+    };
+
+   #if defined(__GNUC__) || defined(__clang__)
+    /*  GCC and Clang vector extensions, which compile to whichever registers
+        the calling function's target has. Everything is inlined into the
+        per-ISA entry points below, so no vector ever crosses a call.
+
+        Vectors wider than the baseline's registers have their comparisons
+        split into scalar ones before they are inlined anywhere, which GCC
+        does from 512 bits, so nothing here is wider than AVX2.
+    */
+    template <typename RealType, int numLanes>
+    struct VectorLanes
+    {
+        using Real = RealType;
+        typedef Real Value __attribute__((vector_size (sizeof (Real) * numLanes)));
+        typedef double Doubles __attribute__((vector_size (sizeof (double) * numLanes)));
+        using Mask = decltype (Value() < Value());
+        static constexpr int size = numLanes;
+
+        static FRACTAL_ALWAYS_INLINE Value load (const double* source) noexcept
+        {
+            Doubles values;
+            std::memcpy (&values, source, sizeof (values));
+            return __builtin_convertvector (values, Value);
+        }
+
+        static FRACTAL_ALWAYS_INLINE void store (double* destination, const Value v) noexcept
+        {
+            const Doubles values = __builtin_convertvector (v, Doubles);
+            std::memcpy (destination, &values, sizeof (values));
+        }
+
+        static FRACTAL_ALWAYS_INLINE Value broadcast (const Real value) noexcept
+        {
+            // Not 0 + value, which would turn -0 into +0
+            Value result;
+            for (int lane = 0; lane < numLanes; lane++)
+                result[lane] = value;
+            return result;
+        }
+
+        // Clears the sign bit, as std::abs does, so -0 comes out as +0 too
+        static FRACTAL_ALWAYS_INLINE void makeAbsolute (Value& v) noexcept
+        {
+            const Mask signBit = (Mask) broadcast (Real (-0.0));
+            v = (Value) (((Mask) v) & ~signBit);
+        }
+
+        static FRACTAL_ALWAYS_INLINE Mask all() noexcept                                { return Value {} == Value {}; }
+        static FRACTAL_ALWAYS_INLINE Mask none() noexcept                               { return Value {} != Value {}; }
+        static FRACTAL_ALWAYS_INLINE Mask andNot (const Mask a, const Mask b) noexcept  { return ~a & b; }
+        static FRACTAL_ALWAYS_INLINE Mask both (const Mask a, const Mask b) noexcept    { return a & b; }
+        static FRACTAL_ALWAYS_INLINE Mask either (const Mask a, const Mask b) noexcept  { return a | b; }
+        static FRACTAL_ALWAYS_INLINE bool isSet (const Mask m, const int lane) noexcept { return m[lane] != 0; }
+        static FRACTAL_ALWAYS_INLINE Real lane (const Value v, const int lane) noexcept { return v[lane]; }
+
+        // ORs whole 64-bit words rather than lanes, which halves the extracts for floats
+        static FRACTAL_ALWAYS_INLINE bool any (const Mask m) noexcept
+        {
+            uint64_t words[sizeof (Mask) / sizeof (uint64_t)];
+            std::memcpy (words, &m, sizeof (words));
+
+            uint64_t bits = 0;
+            for (const auto word : words)
+                bits |= word;
+            return bits != 0;
+        }
+
+        // Bitwise, as SSE2 has no 64-bit compare to turn m back into a condition with
+        static FRACTAL_ALWAYS_INLINE Value select (const Mask m, const Value ifTrue, const Value ifFalse) noexcept
+        {
+            return (Value) ((m & (Mask) ifTrue) | (~m & (Mask) ifFalse));
+        }
+    };
+   #endif
+
+    template <typename Lanes, int power, FormulaVariant variant>
+    FRACTAL_ALWAYS_INLINE void iterateFormulaLanes (const OrbitBatch& batch, const int maxIterations, int& i) noexcept
+    {
+        using Real = typename Lanes::Real;
+        using Value = typename Lanes::Value;
+        using Mask = typename Lanes::Mask;
+        constexpr int numLanes = Lanes::size;
+
+        const Value four = Lanes::broadcast (Real (4));
+
+        for (; i + numLanes <= batch.numOrbits; i += numLanes)
+        {
+            Value zx = Lanes::load (batch.zRe + i);
+            Value zy = Lanes::load (batch.zIm + i);
+            const Value cx = Lanes::load (batch.cRe + i);
+            const Value cy = Lanes::load (batch.cIm + i);
+
+            int counts[numLanes];
+            Real norms[numLanes];
+            Mask active = Lanes::all();
+
+            // Each lane stops once, so these run at most numLanes times per batch
+            auto retire = [&] (const Mask stopped, const int count, const Value norm)
+            {
+                for (int lane = 0; lane < numLanes; lane++)
+                {
+                    if (Lanes::isSet (stopped, lane))
+                    {
+                        counts[lane] = count;
+                        norms[lane] = Lanes::lane (norm, lane);
+                    }
+                }
+                active = Lanes::andNot (stopped, active);
+            };
+
+            Value savedX = zx, savedY = zy;
+            int stepsSinceSave = 0, saveInterval = 1;
+            int n = batch.firstIteration;
+
+            // Cycles found by a step are retired at the top of the next one,
+            // so each step tests its masks once. A lane can't be in both, as
+            // the z it repeated was inside the circle when it was saved. If
+            // the loop runs out first, the count is maxIterations + 1 anyway.
+            Mask cycled = Lanes::none();
+
+            while (n <= maxIterations)
+            {
+                const Value norm = zx * zx + zy * zy;
+                const Mask escaped = Lanes::andNot (norm < four, active);
+                if (Lanes::any (Lanes::either (escaped, cycled)))
+                {
+                    retire (escaped, n, norm);
+                    retire (cycled, maxIterations + 1, norm);
+                    if (! Lanes::any (active))
+                        break;
+                }
+
+                Value newX = zx, newY = zy;
+                stepFormula<power, variant, Lanes> (newX, newY, cx, cy);
+                zx = Lanes::select (active, newX, zx);
+                zy = Lanes::select (active, newY, zy);
+                n++;
+
+                cycled = Lanes::both (active, Lanes::both (zx == savedX, zy == savedY));
+                if (++stepsSinceSave == saveInterval)
+                {
+                    savedX = zx;
+                    savedY = zy;
+                    stepsSinceSave = 0;
+                    saveInterval *= 2;
+                }
+            }
+
+            // Lanes still active ran out of iterations
+            if (Lanes::any (active))
+                retire (active, n, zx * zx + zy * zy);
+
+            const OrbitResults& results = batch.results;
+            for (int lane = 0; lane < numLanes; lane++)
+            {
+                results.nIterations[i + lane] = counts[lane];
+                if (results.finalMagnitudes != nullptr)
+                    results.finalMagnitudes[i + lane] = static_cast<float> (std::sqrt (norms[lane]));
+            }
+            if (results.finalRe != nullptr) Lanes::store (results.finalRe + i, zx);
+            if (results.finalIm != nullptr) Lanes::store (results.finalIm + i, zy);
+        }
+    }
+
+    template <int power, FormulaVariant variant>
+    void iterateFormulaScalar (const OrbitBatch& batch, const int maxIterations) noexcept
+    {
+        int i = 0;
+        if (batch.useFloats)
+            iterateFormulaLanes<ScalarLanes<float>, power, variant> (batch, maxIterations, i);
+        else
+            iterateFormulaLanes<ScalarLanes<double>, power, variant> (batch, maxIterations, i);
+    }
+}
+
+#if FRACTAL_HAS_X86_SIMD
+
+//==============================================================================
+FRACTAL_TARGET ("sse2")
+static void iterateSse2 (const OrbitBatch& batch, const int maxIterations) noexcept {
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d below = _mm_set1_pd (normBelow);
+    const __m128d above = _mm_set1_pd (normAbove);
+
+    int i = 0;
+    for (; i + 2 <= batch.numOrbits; i += 2)
+    {
+        __m128d zx = _mm_loadu_pd (batch.zRe + i);
+        __m128d zy = _mm_loadu_pd (batch.zIm + i);
+        const __m128d cx = _mm_loadu_pd (batch.cRe + i);
+        const __m128d cy = _mm_loadu_pd (batch.cIm + i);
+
+        const __m128d interiorCount = _mm_set1_pd (static_cast<double> (maxIterations + 1));
+        __m128d counts = zero;
+        __m128d norms = zero;
+        __m128d active = _mm_cmpeq_pd (zero, zero);
+
+        if (batch.isMandelbrot)
+        {
+            const __m128d yy = _mm_mul_pd (cy, cy);
+            const __m128d xq = _mm_sub_pd (cx, _mm_set1_pd (0.25));
+            const __m128d q = _mm_add_pd (_mm_mul_pd (xq, xq), yy);
+            const __m128d x1 = _mm_add_pd (cx, _mm_set1_pd (1.0));
+            const __m128d interior = _mm_or_pd (_mm_cmplt_pd (_mm_mul_pd (q, _mm_add_pd (q, xq)), _mm_mul_pd (_mm_set1_pd (0.25), yy)),
+                                                _mm_cmplt_pd (_mm_add_pd (_mm_mul_pd (x1, x1), yy), _mm_set1_pd (0.0625)));
+            counts = _mm_and_pd (interior, interiorCount);
+            norms = _mm_and_pd (interior, _mm_add_pd (_mm_mul_pd (zx, zx), _mm_mul_pd (zy, zy)));
+            active = _mm_andnot_pd (interior, active);
+        }
+
+        __m128d savedX = zx, savedY = zy;
+        int stepsSinceSave = 0, saveInterval = 1;
+        int n = _mm_movemask_pd (active) != 0 ? batch.firstIteration : maxIterations + 1;
+
+        while (n <= maxIterations)
+        {
+            const __m128d xx = _mm_mul_pd (zx, zx);
+            const __m128d yy = _mm_mul_pd (zy, zy);
+            const __m128d xy = _mm_mul_pd (zx, zy);
+            const __m128d norm = _mm_add_pd (xx, yy);
+
+            __m128d inside = _mm_cmplt_pd (norm, below);
+            const __m128d unsure = _mm_and_pd (active, _mm_andnot_pd (inside, _mm_cmple_pd (norm, above)));
+            if (_mm_movemask_pd (unsure) != 0)
+            {
+                alignas (16) double re[2], im[2];
+                _mm_store_pd (re, zx);
+                _mm_store_pd (im, zy);
+                const int unsureBits = _mm_movemask_pd (unsure);
+                int insideBits = _mm_movemask_pd (inside);
+                for (int lane = 0; lane < 2; lane++)
+                    if (((unsureBits >> lane) & 1) && magnitudeBelowTwo (re[lane], im[lane]))
+                        insideBits |= 1 << lane;
+                inside = _mm_castsi128_pd (_mm_set_epi64x ((insideBits & 2) ? -1 : 0, (insideBits & 1) ? -1 : 0));
+            }
+
+            const __m128d escaped = _mm_andnot_pd (inside, active);
+            const __m128d nVec = _mm_set1_pd (static_cast<double> (n));
+            counts = _mm_or_pd (_mm_andnot_pd (escaped, counts), _mm_and_pd (escaped, nVec));
+            norms = _mm_or_pd (_mm_andnot_pd (escaped, norms), _mm_and_pd (escaped, norm));
+            active = _mm_and_pd (active, inside);
+            if (_mm_movemask_pd (active) == 0)
+                break;
+
+            const __m128d newX = _mm_add_pd (_mm_sub_pd (xx, yy), cx);
+            const __m128d newY = _mm_add_pd (_mm_add_pd (xy, xy), cy);
+            zx = _mm_or_pd (_mm_andnot_pd (active, zx), _mm_and_pd (active, newX));
+            zy = _mm_or_pd (_mm_andnot_pd (active, zy), _mm_and_pd (active, newY));
+            n++;
+
+            const __m128d cycled = _mm_and_pd (active, _mm_and_pd (_mm_cmpeq_pd (zx, savedX), _mm_cmpeq_pd (zy, savedY)));
+            if (_mm_movemask_pd (cycled) != 0)
+            {
+                const __m128d cycledNorm = _mm_add_pd (_mm_mul_pd (zx, zx), _mm_mul_pd (zy, zy));
+                counts = _mm_or_pd (_mm_andnot_pd (cycled, counts), _mm_and_pd (cycled, interiorCount));
+                norms = _mm_or_pd (_mm_andnot_pd (cycled, norms), _mm_and_pd (cycled, cycledNorm));
+                active = _mm_andnot_pd (cycled, active);
+                if (_mm_movemask_pd (active) == 0)
+                    break;
+            }
+            if (++stepsSinceSave == saveInterval)
+            {
+                savedX = zx;
+                savedY = zy;
+                stepsSinceSave = 0;
+                saveInterval *= 2;
+            }
+        }
+
+        // Lanes still active ran out of iterations
+        const __m128d nVec = _mm_set1_pd (static_cast<double> (n));
+        const __m128d lastNorm = _mm_add_pd (_mm_mul_pd (zx, zx), _mm_mul_pd (zy, zy));
+        counts = _mm_or_pd (_mm_andnot_pd (active, counts), _mm_and_pd (active, nVec));
+        norms = _mm_or_pd (_mm_andnot_pd (active, norms), _mm_and_pd (active, lastNorm));
+
+        alignas (16) double result[2];
+        _mm_store_pd (result, counts);
+        batch.results.nIterations[i] = static_cast<int> (result[0]);
+        batch.results.nIterations[i + 1] = static_cast<int> (result[1]);
+
+        if (batch.results.finalMagnitudes != nullptr)
+        {
+            _mm_store_pd (result, _mm_sqrt_pd (norms));
+            batch.results.finalMagnitudes[i] = static_cast<float> (result[0]);
+            batch.results.finalMagnitudes[i + 1] = static_cast<float> (result[1]);
+        }
+        if (batch.results.finalRe != nullptr) _mm_storeu_pd (batch.results.finalRe + i, zx);
+        if (batch.results.finalIm != nullptr) _mm_storeu_pd (batch.results.finalIm + i, zy);
+    }
+
+    iterateScalar (batch, i, maxIterations);
+}
+
+//==============================================================================
+FRACTAL_TARGET ("avx2")
+static void iterateAvx2 (const OrbitBatch& batch, const int maxIterations, int i = 0) noexcept {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d below = _mm256_set1_pd (normBelow);
+    const __m256d above = _mm256_set1_pd (normAbove);
+
+    for (; i + 4 <= batch.numOrbits; i += 4)
+    {
+        __m256d zx = _mm256_loadu_pd (batch.zRe + i);
+        __m256d zy = _mm256_loadu_pd (batch.zIm + i);
+        const __m256d cx = _mm256_loadu_pd (batch.cRe + i);
+        const __m256d cy = _mm256_loadu_pd (batch.cIm + i);
+
+        const __m256d interiorCount = _mm256_set1_pd (static_cast<double> (maxIterations + 1));
+        __m256d counts = zero;
+        __m256d norms = zero;
+        __m256d active = _mm256_cmp_pd (zero, zero, _CMP_EQ_OQ);
+
+        if (batch.isMandelbrot)
+        {
+            const __m256d yy = _mm256_mul_pd (cy, cy);
+            const __m256d xq = _mm256_sub_pd (cx, _mm256_set1_pd (0.25));
+            const __m256d q = _mm256_add_pd (_mm256_mul_pd (xq, xq), yy);
+            const __m256d x1 = _mm256_add_pd (cx, _mm256_set1_pd (1.0));
+            const __m256d interior = _mm256_or_pd (_mm256_cmp_pd (_mm256_mul_pd (q, _mm256_add_pd (q, xq)), _mm256_mul_pd (_mm256_set1_pd (0.25), yy), _CMP_LT_OQ),
+                                                   _mm256_cmp_pd (_mm256_add_pd (_mm256_mul_pd (x1, x1), yy), _mm256_set1_pd (0.0625), _CMP_LT_OQ));
+            counts = _mm256_and_pd (interior, interiorCount);
+            norms = _mm256_and_pd (interior, _mm256_add_pd (_mm256_mul_pd (zx, zx), _mm256_mul_pd (zy, zy)));
+            active = _mm256_andnot_pd (interior, active);
+        }
+
+        __m256d savedX = zx, savedY = zy;
+        int stepsSinceSave = 0, saveInterval = 1;
+        int n = ! _mm256_testz_pd (active, active) ? batch.firstIteration : maxIterations + 1;
+
+        while (n <= maxIterations)
+        {
+            const __m256d xx = _mm256_mul_pd (zx, zx);
+            const __m256d yy = _mm256_mul_pd (zy, zy);
+            const __m256d xy = _mm256_mul_pd (zx, zy);
+            const __m256d norm = _mm256_add_pd (xx, yy);
+
+            __m256d inside = _mm256_cmp_pd (norm, below, _CMP_LT_OQ);
+            const __m256d unsure = _mm256_and_pd (active, _mm256_andnot_pd (inside, _mm256_cmp_pd (norm, above, _CMP_LE_OQ)));
+            if (! _mm256_testz_pd (unsure, unsure))
+            {
+                alignas (32) double re[4], im[4];
+                _mm256_store_pd (re, zx);
+                _mm256_store_pd (im, zy);
+                const int unsureBits = _mm256_movemask_pd (unsure);
+                int insideBits = _mm256_movemask_pd (inside);
+                for (int lane = 0; lane < 4; lane++)
+                    if (((unsureBits >> lane) & 1) && magnitudeBelowTwo (re[lane], im[lane]))
+                        insideBits |= 1 << lane;
+                inside = _mm256_castsi256_pd (_mm256_set_epi64x ((insideBits & 8) ? -1 : 0, (insideBits & 4) ? -1 : 0,
+                                                                 (insideBits & 2) ? -1 : 0, (insideBits & 1) ? -1 : 0));
+            }
+
+            const __m256d escaped = _mm256_andnot_pd (inside, active);
+            counts = _mm256_blendv_pd (counts, _mm256_set1_pd (static_cast<double> (n)), escaped);
+            norms = _mm256_blendv_pd (norms, norm, escaped);
+            active = _mm256_and_pd (active, inside);
+            if (_mm256_testz_pd (active, active))
+                break;
+
+            const __m256d newX = _mm256_add_pd (_mm256_sub_pd (xx, yy), cx);
+            const __m256d newY = _mm256_add_pd (_mm256_add_pd (xy, xy), cy);
+            zx = _mm256_blendv_pd (zx, newX, active);
+            zy = _mm256_blendv_pd (zy, newY, active);
+            n++;
+
+            const __m256d cycled = _mm256_and_pd (active, _mm256_and_pd (_mm256_cmp_pd (zx, savedX, _CMP_EQ_OQ),
+                                                                         _mm256_cmp_pd (zy, savedY, _CMP_EQ_OQ)));
+            if (! _mm256_testz_pd (cycled, cycled))
+            {
+                const __m256d cycledNorm = _mm256_add_pd (_mm256_mul_pd (zx, zx), _mm256_mul_pd (zy, zy));
+                counts = _mm256_blendv_pd (counts, interiorCount, cycled);
+                norms = _mm256_blendv_pd (norms, cycledNorm, cycled);
+                active = _mm256_andnot_pd (cycled, active);
+                if (_mm256_testz_pd (active, active))
+                    break;
+            }
+            if (++stepsSinceSave == saveInterval)
+            {
+                savedX = zx;
+                savedY = zy;
+                stepsSinceSave = 0;
+                saveInterval *= 2;
+            }
+        }
+
+        // Lanes still active ran out of iterations
+        const __m256d lastNorm = _mm256_add_pd (_mm256_mul_pd (zx, zx), _mm256_mul_pd (zy, zy));
+        counts = _mm256_blendv_pd (counts, _mm256_set1_pd (static_cast<double> (n)), active);
+        norms = _mm256_blendv_pd (norms, lastNorm, active);
+        _mm_storeu_si128 (reinterpret_cast<__m128i*> (batch.results.nIterations + i), _mm256_cvtpd_epi32 (counts));
+
+        if (batch.results.finalMagnitudes != nullptr)
+            _mm_storeu_ps (batch.results.finalMagnitudes + i, _mm256_cvtpd_ps (_mm256_sqrt_pd (norms)));
+        if (batch.results.finalRe != nullptr) _mm256_storeu_pd (batch.results.finalRe + i, zx);
+        if (batch.results.finalIm != nullptr) _mm256_storeu_pd (batch.results.finalIm + i, zy);
+    }
+
+    iterateScalar (batch, i, maxIterations);
+}
+
+//==============================================================================
+FRACTAL_TARGET ("avx512f")
+static void iterateAvx512 (const OrbitBatch& batch, const int maxIterations) noexcept {
+    const __m512d below = _mm512_set1_pd (normBelow);
+    const __m512d above = _mm512_set1_pd (normAbove);
+
+    int i = 0;
+    for (; i + 8 <= batch.numOrbits; i += 8)
+    {
+        __m512d zx = _mm512_loadu_pd (batch.zRe + i);
+        __m512d zy = _mm512_loadu_pd (batch.zIm + i);
+        const __m512d cx = _mm512_loadu_pd (batch.cRe + i);
+        const __m512d cy = _mm512_loadu_pd (batch.cIm + i);
+
+        const __m512i interiorCount = _mm512_set1_epi32 (maxIterations + 1);
+        __m512i counts = _mm512_setzero_si512();
+        __m512d norms = _mm512_setzero_pd();
+        __mmask8 active = 0xff;
+
+        if (batch.isMandelbrot)
+        {
+            const __m512d yy = _mm512_mul_pd (cy, cy);
+            const __m512d xq = _mm512_sub_pd (cx, _mm512_set1_pd (0.25));
+            const __m512d q = _mm512_add_pd (_mm512_mul_pd (xq, xq), yy);
+            const __m512d x1 = _mm512_add_pd (cx, _mm512_set1_pd (1.0));
+            const __mmask8 interior = _mm512_cmp_pd_mask (_mm512_mul_pd (q, _mm512_add_pd (q, xq)), _mm512_mul_pd (_mm512_set1_pd (0.25), yy), _CMP_LT_OQ)
+                                    | _mm512_cmp_pd_mask (_mm512_add_pd (_mm512_mul_pd (x1, x1), yy), _mm512_set1_pd (0.0625), _CMP_LT_OQ);
+            counts = _mm512_mask_mov_epi32 (counts, interior, interiorCount);
+            norms = _mm512_mask_mov_pd (norms, interior, _mm512_add_pd (_mm512_mul_pd (zx, zx), _mm512_mul_pd (zy, zy)));
+            active = static_cast<__mmask8> (active & ~interior);
+        }
+
+        __m512d savedX = zx, savedY = zy;
+        int stepsSinceSave = 0, saveInterval = 1;
+        int n = active != 0 ? batch.firstIteration : maxIterations + 1;
+
+        while (n <= maxIterations)
+        {
+            const __m512d xx = _mm512_mul_pd (zx, zx);
+            const __m512d yy = _mm512_mul_pd (zy, zy);
+            const __m512d xy = _mm512_mul_pd (zx, zy);
+            const __m512d norm = _mm512_add_pd (xx, yy);
+
+            __mmask8 inside = _mm512_cmp_pd_mask (norm, below, _CMP_LT_OQ);
+            const __mmask8 unsure = active & ~inside & _mm512_cmp_pd_mask (norm, above, _CMP_LE_OQ);
+            if (unsure != 0)
+            {
+                alignas (64) double re[8], im[8];
+                _mm512_store_pd (re, zx);
+                _mm512_store_pd (im, zy);
+                for (int lane = 0; lane < 8; lane++)
+                    if (((unsure >> lane) & 1) && magnitudeBelowTwo (re[lane], im[lane]))
+                        inside = static_cast<__mmask8> (inside | (1 << lane));
+            }
+
+            const __mmask8 escaped = active & ~inside;
+            counts = _mm512_mask_mov_epi32 (counts, escaped, _mm512_set1_epi32 (n));
+            norms = _mm512_mask_mov_pd (norms, escaped, norm);
+            active = active & inside;
+            if (active == 0)
+                break;
+
+            zx = _mm512_mask_mov_pd (zx, active, _mm512_add_pd (_mm512_sub_pd (xx, yy), cx));
+            zy = _mm512_mask_mov_pd (zy, active, _mm512_add_pd (_mm512_add_pd (xy, xy), cy));
+            n++;
+
+            const __mmask8 cycled = active & _mm512_cmp_pd_mask (zx, savedX, _CMP_EQ_OQ)
+                                           & _mm512_cmp_pd_mask (zy, savedY, _CMP_EQ_OQ);
+            if (cycled != 0)
+            {
+                counts = _mm512_mask_mov_epi32 (counts, cycled, interiorCount);
+                norms = _mm512_mask_mov_pd (norms, cycled, _mm512_add_pd (_mm512_mul_pd (zx, zx), _mm512_mul_pd (zy, zy)));
+                active = static_cast<__mmask8> (active & ~cycled);
+                if (active == 0)
+                    break;
+            }
+            if (++stepsSinceSave == saveInterval)
+            {
+                savedX = zx;
+                savedY = zy;
+                stepsSinceSave = 0;
+                saveInterval *= 2;
+            }
+        }
+
+        // Lanes still active ran out of iterations
+        const __m512d lastNorm = _mm512_add_pd (_mm512_mul_pd (zx, zx), _mm512_mul_pd (zy, zy));
+        counts = _mm512_mask_mov_epi32 (counts, active, _mm512_set1_epi32 (n));
+        norms = _mm512_mask_mov_pd (norms, active, lastNorm);
+        _mm512_mask_storeu_epi32 (batch.results.nIterations + i, 0xff, counts);
+
+        if (batch.results.finalMagnitudes != nullptr)
+            _mm256_storeu_ps (batch.results.finalMagnitudes + i, _mm512_maskz_cvtpd_ps (0xff, _mm512_maskz_sqrt_pd (0xff, norms)));
+        if (batch.results.finalRe != nullptr) _mm512_storeu_pd (batch.results.finalRe + i, zx);
+        if (batch.results.finalIm != nullptr) _mm512_storeu_pd (batch.results.finalIm + i, zy);
+    }
+
+    iterateAvx2 (batch, maxIterations, i);
+}
+
+//==============================================================================
+/*  The float kernels follow the double ones lane for lane, with counts kept
+    as integers since a float can't hold every count above 2^24.
+*/
+FRACTAL_TARGET ("sse2")
+static inline __m128 loadFloatsSse2 (const double* source) noexcept {
+    return _mm_movelh_ps (_mm_cvtpd_ps (_mm_loadu_pd (source)), _mm_cvtpd_ps (_mm_loadu_pd (source + 2)));
+}
+
+FRACTAL_TARGET ("sse2")
+static inline void storeDoublesSse2 (double* destination, const __m128 values) noexcept {
+    _mm_storeu_pd (destination, _mm_cvtps_pd (values));
+    _mm_storeu_pd (destination + 2, _mm_cvtps_pd (_mm_movehl_ps (values, values)));
+}
+
+FRACTAL_TARGET ("sse2")
+static inline __m128i selectSse2 (const __m128i ifFalse, const __m128i ifTrue, const __m128 mask) noexcept {
+    const __m128i bits = _mm_castps_si128 (mask);
+    return _mm_or_si128 (_mm_andnot_si128 (bits, ifFalse), _mm_and_si128 (bits, ifTrue));
+}
+
+FRACTAL_TARGET ("sse2")
+static inline __m128 selectSse2 (const __m128 ifFalse, const __m128 ifTrue, const __m128 mask) noexcept {
+    return _mm_or_ps (_mm_andnot_ps (mask, ifFalse), _mm_and_ps (mask, ifTrue));
+}
+
+FRACTAL_TARGET ("sse2")
+static void iterateSse2Float (const OrbitBatch& batch, const int maxIterations) noexcept {
+    const __m128 four = _mm_set1_ps (4.0f);
+    const __m128i interiorCount = _mm_set1_epi32 (maxIterations + 1);
+
+    int i = 0;
+    for (; i + 4 <= batch.numOrbits; i += 4)
+    {
+        __m128 zx = loadFloatsSse2 (batch.zRe + i);
+        __m128 zy = loadFloatsSse2 (batch.zIm + i);
+        const __m128 cx = loadFloatsSse2 (batch.cRe + i);
+        const __m128 cy = loadFloatsSse2 (batch.cIm + i);
+
+        __m128i counts = _mm_setzero_si128();
+        __m128 norms = _mm_setzero_ps();
+        __m128 active = _mm_castsi128_ps (_mm_set1_epi32 (-1));
+
+        if (batch.isMandelbrot)
+        {
+            const __m128 yy = _mm_mul_ps (cy, cy);
+            const __m128 xq = _mm_sub_ps (cx, _mm_set1_ps (0.25f));
+            const __m128 q = _mm_add_ps (_mm_mul_ps (xq, xq), yy);
+            const __m128 x1 = _mm_add_ps (cx, _mm_set1_ps (1.0f));
+            const __m128 interior = _mm_or_ps (_mm_cmplt_ps (_mm_mul_ps (q, _mm_add_ps (q, xq)), _mm_mul_ps (_mm_set1_ps (0.25f), yy)),
+                                               _mm_cmplt_ps (_mm_add_ps (_mm_mul_ps (x1, x1), yy), _mm_set1_ps (0.0625f)));
+            counts = selectSse2 (counts, interiorCount, interior);
+            norms = selectSse2 (norms, _mm_add_ps (_mm_mul_ps (zx, zx), _mm_mul_ps (zy, zy)), interior);
+            active = _mm_andnot_ps (interior, active);
+        }
+
+        __m128 savedX = zx, savedY = zy;
+        int stepsSinceSave = 0, saveInterval = 1;
+        int n = _mm_movemask_ps (active) != 0 ? batch.firstIteration : maxIterations + 1;
+
+        while (n <= maxIterations)
+        {
+            const __m128 xx = _mm_mul_ps (zx, zx);
+            const __m128 yy = _mm_mul_ps (zy, zy);
+            const __m128 xy = _mm_mul_ps (zx, zy);
+            const __m128 norm = _mm_add_ps (xx, yy);
+
+            const __m128 escaped = _mm_andnot_ps (_mm_cmplt_ps (norm, four), active);
+            counts = selectSse2 (counts, _mm_set1_epi32 (n), escaped);
+            norms = selectSse2 (norms, norm, escaped);
+            active = _mm_andnot_ps (escaped, active);
+            if (_mm_movemask_ps (active) == 0)
+                break;
+
+            zx = selectSse2 (zx, _mm_add_ps (_mm_sub_ps (xx, yy), cx), active);
+            zy = selectSse2 (zy, _mm_add_ps (_mm_add_ps (xy, xy), cy), active);
+            n++;
+
+            const __m128 cycled = _mm_and_ps (active, _mm_and_ps (_mm_cmpeq_ps (zx, savedX), _mm_cmpeq_ps (zy, savedY)));
+            if (_mm_movemask_ps (cycled) != 0)
+            {
+                counts = selectSse2 (counts, interiorCount, cycled);
+                norms = selectSse2 (norms, _mm_add_ps (_mm_mul_ps (zx, zx), _mm_mul_ps (zy, zy)), cycled);
+                active = _mm_andnot_ps (cycled, active);
+                if (_mm_movemask_ps (active) == 0)
+                    break;
+            }
+            if (++stepsSinceSave == saveInterval)
+            {
+                savedX = zx;
+                savedY = zy;
+                stepsSinceSave = 0;
+                saveInterval *= 2;
+            }
+        }
+
+        // Lanes still active ran out of iterations
+        counts = selectSse2 (counts, _mm_set1_epi32 (n), active);
+        norms = selectSse2 (norms, _mm_add_ps (_mm_mul_ps (zx, zx), _mm_mul_ps (zy, zy)), active);
+        _mm_storeu_si128 (reinterpret_cast<__m128i*> (batch.results.nIterations + i), counts);
+
+        if (batch.results.finalMagnitudes != nullptr) _mm_storeu_ps (batch.results.finalMagnitudes + i, _mm_sqrt_ps (norms));
+        if (batch.results.finalRe != nullptr)         storeDoublesSse2 (batch.results.finalRe + i, zx);
+        if (batch.results.finalIm != nullptr)         storeDoublesSse2 (batch.results.finalIm + i, zy);
+    }
+
+    iterateScalarFloat (batch, i, maxIterations);
+}
+
+//==============================================================================
+FRACTAL_TARGET ("avx2")
+static inline __m256 loadFloatsAvx2 (const double* source) noexcept {
+    return _mm256_insertf128_ps (_mm256_castps128_ps256 (_mm256_cvtpd_ps (_mm256_loadu_pd (source))),
+                                 _mm256_cvtpd_ps (_mm256_loadu_pd (source + 4)), 1);
+}
+
+FRACTAL_TARGET ("avx2")
+static inline void storeDoublesAvx2 (double* destination, const __m256 values) noexcept {
+    _mm256_storeu_pd (destination, _mm256_cvtps_pd (_mm256_castps256_ps128 (values)));
+    _mm256_storeu_pd (destination + 4, _mm256_cvtps_pd (_mm256_extractf128_ps (values, 1)));
+}
+
+FRACTAL_TARGET ("avx2")
+static void iterateAvx2Float (const OrbitBatch& batch, const int maxIterations, int i = 0) noexcept {
+    const __m256 four = _mm256_set1_ps (4.0f);
+    const __m256i interiorCount = _mm256_set1_epi32 (maxIterations + 1);
+
+    for (; i + 8 <= batch.numOrbits; i += 8)
+    {
+        __m256 zx = loadFloatsAvx2 (batch.zRe + i);
+        __m256 zy = loadFloatsAvx2 (batch.zIm + i);
+        const __m256 cx = loadFloatsAvx2 (batch.cRe + i);
+        const __m256 cy = loadFloatsAvx2 (batch.cIm + i);
+
+        __m256i counts = _mm256_setzero_si256();
+        __m256 norms = _mm256_setzero_ps();
+        __m256 active = _mm256_castsi256_ps (_mm256_set1_epi32 (-1));
+
+        if (batch.isMandelbrot)
+        {
+            const __m256 yy = _mm256_mul_ps (cy, cy);
+            const __m256 xq = _mm256_sub_ps (cx, _mm256_set1_ps (0.25f));
+            const __m256 q = _mm256_add_ps (_mm256_mul_ps (xq, xq), yy);
+            const __m256 x1 = _mm256_add_ps (cx, _mm256_set1_ps (1.0f));
+            const __m256 interior = _mm256_or_ps (_mm256_cmp_ps (_mm256_mul_ps (q, _mm256_add_ps (q, xq)), _mm256_mul_ps (_mm256_set1_ps (0.25f), yy), _CMP_LT_OQ),
+                                                  _mm256_cmp_ps (_mm256_add_ps (_mm256_mul_ps (x1, x1), yy), _mm256_set1_ps (0.0625f), _CMP_LT_OQ));
+            counts = _mm256_blendv_epi8 (counts, interiorCount, _mm256_castps_si256 (interior));
+            norms = _mm256_blendv_ps (norms, _mm256_add_ps (_mm256_mul_ps (zx, zx), _mm256_mul_ps (zy, zy)), interior);
+            active = _mm256_andnot_ps (interior, active);
+        }
+
+        __m256 savedX = zx, savedY = zy;
+        int stepsSinceSave = 0, saveInterval = 1;
+        int n = ! _mm256_testz_ps (active, active) ? batch.firstIteration : maxIterations + 1;
+
+        while (n <= maxIterations)
+        {
+            const __m256 xx = _mm256_mul_ps (zx, zx);
+            const __m256 yy = _mm256_mul_ps (zy, zy);
+            const __m256 xy = _mm256_mul_ps (zx, zy);
+            const __m256 norm = _mm256_add_ps (xx, yy);
+
+            const __m256 escaped = _mm256_andnot_ps (_mm256_cmp_ps (norm, four, _CMP_LT_OQ), active);
+            counts = _mm256_blendv_epi8 (counts, _mm256_set1_epi32 (n), _mm256_castps_si256 (escaped));
+            norms = _mm256_blendv_ps (norms, norm, escaped);
+            active = _mm256_andnot_ps (escaped, active);
+            if (_mm256_testz_ps (active, active))
+                break;
+
+            zx = _mm256_blendv_ps (zx, _mm256_add_ps (_mm256_sub_ps (xx, yy), cx), active);
+            zy = _mm256_blendv_ps (zy, _mm256_add_ps (_mm256_add_ps (xy, xy), cy), active);
+            n++;
+
+            const __m256 cycled = _mm256_and_ps (active, _mm256_and_ps (_mm256_cmp_ps (zx, savedX, _CMP_EQ_OQ),
+                                                                        _mm256_cmp_ps (zy, savedY, _CMP_EQ_OQ)));
+            if (! _mm256_testz_ps (cycled, cycled))
+            {
+                counts = _mm256_blendv_epi8 (counts, interiorCount, _mm256_castps_si256 (cycled));
+                norms = _mm256_blendv_ps (norms, _mm256_add_ps (_mm256_mul_ps (zx, zx), _mm256_mul_ps (zy, zy)), cycled);
+                active = _mm256_andnot_ps (cycled, active);
+                if (_mm256_testz_ps (active, active))
+                    break;
+            }
+            if (++stepsSinceSave == saveInterval)
+            {
+                savedX = zx;
+                savedY = zy;
+                stepsSinceSave = 0;
+                saveInterval *= 2;
+            }
+        }
+
+        // Lanes still active ran out of iterations
+        counts = _mm256_blendv_epi8 (counts, _mm256_set1_epi32 (n), _mm256_castps_si256 (active));
+        norms = _mm256_blendv_ps (norms, _mm256_add_ps (_mm256_mul_ps (zx, zx), _mm256_mul_ps (zy, zy)), active);
+        _mm256_storeu_si256 (reinterpret_cast<__m256i*> (batch.results.nIterations + i), counts);
+
+        if (batch.results.finalMagnitudes != nullptr) _mm256_storeu_ps (batch.results.finalMagnitudes + i, _mm256_sqrt_ps (norms));
+        if (batch.results.finalRe != nullptr)         storeDoublesAvx2 (batch.results.finalRe + i, zx);
+        if (batch.results.finalIm != nullptr)         storeDoublesAvx2 (batch.results.finalIm + i, zy);
+    }
+
+    iterateScalarFloat (batch, i, maxIterations);
+}
+
+//==============================================================================
+FRACTAL_TARGET ("avx512f")
+static inline __m512 loadFloatsAvx512 (const double* source) noexcept {
+    const __m256 low = _mm512_maskz_cvtpd_ps (0xff, _mm512_loadu_pd (source));
+    const __m256 high = _mm512_maskz_cvtpd_ps (0xff, _mm512_loadu_pd (source + 8));
+    return _mm512_castpd_ps (_mm512_maskz_insertf64x4 (0xff, _mm512_castps_pd (_mm512_castps256_ps512 (low)), _mm256_castps_pd (high), 1));
+}
+
+FRACTAL_TARGET ("avx512f")
+static inline void storeDoublesAvx512 (double* destination, const __m512 values) noexcept {
+    // Through memory, as GCC warns about the undefined upper lanes of the
+    // register casts; this only runs once per orbit
+    alignas (64) float lanes[16];
+    _mm512_store_ps (lanes, values);
+    _mm512_storeu_pd (destination, _mm512_maskz_cvtps_pd (0xff, _mm256_load_ps (lanes)));
+    _mm512_storeu_pd (destination + 8, _mm512_maskz_cvtps_pd (0xff, _mm256_load_ps (lanes + 8)));
+}
+
+FRACTAL_TARGET ("avx512f")
+static void iterateAvx512Float (const OrbitBatch& batch, const int maxIterations) noexcept {
+    const __m512 four = _mm512_set1_ps (4.0f);
+    const __m512i interiorCount = _mm512_set1_epi32 (maxIterations + 1);
+
+    int i = 0;
+    for (; i + 16 <= batch.numOrbits; i += 16)
+    {
+        __m512 zx = loadFloatsAvx512 (batch.zRe + i);
+        __m512 zy = loadFloatsAvx512 (batch.zIm + i);
+        const __m512 cx = loadFloatsAvx512 (batch.cRe + i);
+        const __m512 cy = loadFloatsAvx512 (batch.cIm + i);
+
+        __m512i counts = _mm512_setzero_si512();
+        __m512 norms = _mm512_setzero_ps();
+        __mmask16 active = 0xffff;
+
+        if (batch.isMandelbrot)
+        {
+            const __m512 yy = _mm512_mul_ps (cy, cy);
+            const __m512 xq = _mm512_sub_ps (cx, _mm512_set1_ps (0.25f));
+            const __m512 q = _mm512_add_ps (_mm512_mul_ps (xq, xq), yy);
+            const __m512 x1 = _mm512_add_ps (cx, _mm512_set1_ps (1.0f));
+            const __mmask16 interior = _mm512_cmp_ps_mask (_mm512_mul_ps (q, _mm512_add_ps (q, xq)), _mm512_mul_ps (_mm512_set1_ps (0.25f), yy), _CMP_LT_OQ)
+                                     | _mm512_cmp_ps_mask (_mm512_add_ps (_mm512_mul_ps (x1, x1), yy), _mm512_set1_ps (0.0625f), _CMP_LT_OQ);
+            counts = _mm512_mask_mov_epi32 (counts, interior, interiorCount);
+            norms = _mm512_mask_mov_ps (norms, interior, _mm512_add_ps (_mm512_mul_ps (zx, zx), _mm512_mul_ps (zy, zy)));
+            active = static_cast<__mmask16> (active & ~interior);
+        }
+
+        __m512 savedX = zx, savedY = zy;
+        int stepsSinceSave = 0, saveInterval = 1;
+        int n = active != 0 ? batch.firstIteration : maxIterations + 1;
+
+        while (n <= maxIterations)
+        {
+            const __m512 xx = _mm512_mul_ps (zx, zx);
+            const __m512 yy = _mm512_mul_ps (zy, zy);
+            const __m512 xy = _mm512_mul_ps (zx, zy);
+            const __m512 norm = _mm512_add_ps (xx, yy);
+
+            const __mmask16 escaped = static_cast<__mmask16> (active & ~_mm512_cmp_ps_mask (norm, four, _CMP_LT_OQ));
+            counts = _mm512_mask_mov_epi32 (counts, escaped, _mm512_set1_epi32 (n));
+            norms = _mm512_mask_mov_ps (norms, escaped, norm);
+            active = static_cast<__mmask16> (active & ~escaped);
+            if (active == 0)
+                break;
+
+            zx = _mm512_mask_mov_ps (zx, active, _mm512_add_ps (_mm512_sub_ps (xx, yy), cx));
+            zy = _mm512_mask_mov_ps (zy, active, _mm512_add_ps (_mm512_add_ps (xy, xy), cy));
+            n++;
+
+            const __mmask16 cycled = active & _mm512_cmp_ps_mask (zx, savedX, _CMP_EQ_OQ)
+                                            & _mm512_cmp_ps_mask (zy, savedY, _CMP_EQ_OQ);
+            if (cycled != 0)
+            {
+                counts = _mm512_mask_mov_epi32 (counts, cycled, interiorCount);
+                norms = _mm512_mask_mov_ps (norms, cycled, _mm512_add_ps (_mm512_mul_ps (zx, zx), _mm512_mul_ps (zy, zy)));
+                active = static_cast<__mmask16> (active & ~cycled);
+                if (active == 0)
+                    break;
+            }
+            if (++stepsSinceSave == saveInterval)
+            {
+                savedX = zx;
+                savedY = zy;
+                stepsSinceSave = 0;
+                saveInterval *= 2;
+            }
+        }
+
+        // Lanes still active ran out of iterations
+        counts = _mm512_mask_mov_epi32 (counts, active, _mm512_set1_epi32 (n));
+        norms = _mm512_mask_mov_ps (norms, active, _mm512_add_ps (_mm512_mul_ps (zx, zx), _mm512_mul_ps (zy, zy)));
+        _mm512_storeu_si512 (batch.results.nIterations + i, counts);
+
+        if (batch.results.finalMagnitudes != nullptr) _mm512_storeu_ps (batch.results.finalMagnitudes + i, _mm512_maskz_sqrt_ps (0xffff, norms));
+        if (batch.results.finalRe != nullptr)         storeDoublesAvx512 (batch.results.finalRe + i, zx);
+        if (batch.results.finalIm != nullptr)         storeDoublesAvx512 (batch.results.finalIm + i, zy);
+    }
+
+    iterateAvx2Float (batch, maxIterations, i);
+}
+
+//==============================================================================
+/*  The formula loop once per instruction set, each finishing the orbits
+    that don't fill a whole vector one at a time. AVX-512 runs the AVX2
+    kernels, see VectorLanes.
+*/
+#if defined(__GNUC__) || defined(__clang__)
+ #define FRACTAL_HAS_FORMULA_VECTORS 1
+
+template <int power, FormulaVariant variant, int doubleLanes>
+FRACTAL_ALWAYS_INLINE void iterateFormulaVectors (const OrbitBatch& batch, const int maxIterations) noexcept {
+    int i = 0;
+    if (batch.useFloats)
+    {
+        iterateFormulaLanes<VectorLanes<float, doubleLanes * 2>, power, variant> (batch, maxIterations, i);
+        iterateFormulaLanes<ScalarLanes<float>, power, variant> (batch, maxIterations, i);
+    }
+    else
+    {
+        iterateFormulaLanes<VectorLanes<double, doubleLanes>, power, variant> (batch, maxIterations, i);
+        iterateFormulaLanes<ScalarLanes<double>, power, variant> (batch, maxIterations, i);
+    }
+}
+
+template <int power, FormulaVariant variant>
+FRACTAL_TARGET ("sse2")
+static void iterateFormulaSse2 (const OrbitBatch& batch, const int maxIterations) noexcept {
+    iterateFormulaVectors<power, variant, 2> (batch, maxIterations);
+}
+
+template <int power, FormulaVariant variant>
+FRACTAL_TARGET ("avx2")
+static void iterateFormulaAvx2 (const OrbitBatch& batch, const int maxIterations) noexcept {
+    iterateFormulaVectors<power, variant, 4> (batch, maxIterations);
+}
+#else
+ #define FRACTAL_HAS_FORMULA_VECTORS 0
+#endif
+
+//==============================================================================
+static SimdLevel detectSimdLevel() noexcept {
+   #if defined(_MSC_VER) && ! defined(__clang__)
+    int info[4] {};
+    __cpuid (info, 0);
+    const int maxLeaf = info[0];
+
+    __cpuid (info, 1);
+    const bool hasSse2 = (info[3] & (1 << 26)) != 0;
+    const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv (0) & 0x6) == 0x6;
+    const bool osSavesZmm = osSavesYmm && (_xgetbv (0) & 0xe6) == 0xe6;
+
+    bool hasAvx2 = false, hasAvx512 = false;
+    if (maxLeaf >= 7)
+    {
+        __cpuidex (info, 7, 0);
+        hasAvx2 = osSavesYmm && (info[1] & (1 << 5)) != 0;
+        hasAvx512 = osSavesZmm && (info[1] & (1 << 16)) != 0;
+    }
+   #else
+    __builtin_cpu_init();
+    const bool hasSse2 = __builtin_cpu_supports ("sse2");
+    const bool hasAvx2 = __builtin_cpu_supports ("avx2");
+    const bool hasAvx512 = __builtin_cpu_supports ("avx512f");
+   #endif
+
+    if (hasAvx512 && hasAvx2) return SimdLevel::avx512;
+    if (hasAvx2)              return SimdLevel::avx2;
+    if (hasSse2)              return SimdLevel::sse2;
+    return SimdLevel::scalar;
+}
+
+#else
+
+static SimdLevel detectSimdLevel() noexcept {
+    return SimdLevel::scalar;
+}
+
+#endif
+
+//==============================================================================
+SimdLevel getSimdLevel() noexcept {
+    static const SimdLevel level = detectSimdLevel();
+    return level;
+}
+
+void iterateOrbits (const OrbitBatch& batch, const int maxIterations, SimdLevel level) noexcept {
+    if (level > getSimdLevel())
+        level = getSimdLevel();
+
+    if (! batch.formula.isQuadratic())
+    {
+        withFormula (batch.formula, [&] (auto power, auto variant)
+        {
+            constexpr int p = decltype (power)::value;
+            constexpr FormulaVariant v = decltype (variant)::value;
+
+            switch (level)
+            {
+               #if FRACTAL_HAS_X86_SIMD && FRACTAL_HAS_FORMULA_VECTORS
+                case SimdLevel::avx512:
+                case SimdLevel::avx2:   iterateFormulaAvx2<p, v> (batch, maxIterations); break;
+                case SimdLevel::sse2:   iterateFormulaSse2<p, v> (batch, maxIterations); break;
+               #endif
+                default:                iterateFormulaScalar<p, v> (batch, maxIterations); break;
+            }
+        });
+        return;
+    }
+
+    if (batch.useFloats)
+    {
+        switch (level)
+        {
+           #if FRACTAL_HAS_X86_SIMD
+            case SimdLevel::avx512: iterateAvx512Float (batch, maxIterations); break;
+            case SimdLevel::avx2:   iterateAvx2Float (batch, maxIterations); break;
+            case SimdLevel::sse2:   iterateSse2Float (batch, maxIterations); break;
+           #endif
+            default:                iterateScalarFloat (batch, 0, maxIterations); break;
+        }
+        return;
+    }
+
+    switch (level)
+    {
+       #if FRACTAL_HAS_X86_SIMD
+        case SimdLevel::avx512: iterateAvx512 (batch, maxIterations); break;
+        case SimdLevel::avx2:   iterateAvx2 (batch, maxIterations); break;
+        case SimdLevel::sse2:   iterateSse2 (batch, maxIterations); break;
+       #endif
+        default:                iterateScalar (batch, 0, maxIterations); break;
+    }
+}
+
+void calcIterationsRow (const FractalParams& params, const int y, const int x,
+                        const int numPixels, const OrbitResults& results,
+                        const int xStep, SimdLevel level) noexcept {
+    if (params.precision == Precision::doubleDouble || params.precision == Precision::perturbation)
+    {
+        const bool canPerturb = params.precision == Precision::perturbation && params.reference != nullptr
+                              && params.formula.isQuadratic();
+        for (int i = 0; i < numPixels; i++)
+        {
+            if (canPerturb)
+                calcIterationsPerturbed (params, x + i * xStep, y, results.offsetBy (i));
+            else
+                calcIterationsDoubleDouble (params, x + i * xStep, y, results.offsetBy (i));
+        }
+        return;
+    }
+
+    // Rows are fed to the kernels in chunks small enough to live on the stack
+    constexpr int chunkSize = 64;
+    double pointX[chunkSize], pointY[chunkSize], zero[chunkSize] {}, cRe[chunkSize], cIm[chunkSize];
+
+    const bool isJulia = params.type == FractalType::julia;
+    const double mathY = params.mathY (y);
+
+    for (int i = 0; i < chunkSize; i++)
+    {
+        pointY[i] = mathY;
+        cRe[i] = params.cRe;
+        cIm[i] = params.cIm;
+    }
+
+    for (int start = 0; start < numPixels; start += chunkSize)
+    {
+        OrbitBatch batch;
+        batch.numOrbits = numPixels - start < chunkSize ? numPixels - start : chunkSize;
+        batch.firstIteration = params.minIterations;
+        batch.formula = params.formula;
+        batch.isMandelbrot = ! isJulia;
+        batch.useFloats = params.precision == Precision::float32;
+        batch.results = results.offsetBy (start);
+
+        for (int i = 0; i < batch.numOrbits; i++)
+            pointX[i] = params.mathX (x + (start + i) * xStep);
+
+        batch.zRe = isJulia ? pointX : zero;
+        batch.zIm = isJulia ? pointY : zero;
+        batch.cRe = isJulia ? cRe : pointX;
+        batch.cIm = isJulia ? cIm : pointY;
+
+        iterateOrbits (batch, params.maxIterations, level);
+    }
+}
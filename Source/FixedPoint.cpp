@@ -0,0 +1,240 @@
+/*
+  ==============================================================================
+
+    FixedPoint.cpp
+    Created: 20 Oct 2026 2:12:48pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "FixedPoint.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+static constexpr double limbScale = 4294967296.0;
+
+FixedPoint::FixedPoint (const double value) {
+    m_isNegative = value < 0;
+    double remainder = std::fabs (value);
+
+    const double integer = std::floor (remainder);
+    m_limbs[0] = static_cast<uint32_t> (integer);
+    remainder -= integer;
+
+    // Scaling by 2^32 and dropping the integer part are both exact
+    while (remainder > 0)
+    {
+        remainder *= limbScale;
+        const double limb = std::floor (remainder);
+        m_limbs.push_back (static_cast<uint32_t> (limb));
+        remainder -= limb;
+    }
+
+    if (isZero())
+        m_isNegative = false;
+}
+
+bool FixedPoint::parse (const std::string& text, FixedPoint& result) {
+    size_t pos = 0;
+    const bool isNegative = ! text.empty() && text[0] == '-';
+    if (! text.empty() && (text[0] == '-' || text[0] == '+'))
+        pos++;
+
+    // Every digit in order, and how many of them come before the point
+    std::string digits;
+    int numIntegerDigits = 0;
+    bool hasPoint = false;
+
+    for (; pos < text.size(); pos++)
+    {
+        const char character = text[pos];
+        if (std::isdigit (static_cast<unsigned char> (character))) {
+            digits += character;
+            if (! hasPoint) numIntegerDigits++;
+        } else if (character == '.' && ! hasPoint) {
+            hasPoint = true;
+        } else {
+            break;
+        }
+    }
+
+    if (digits.empty())
+        return false;
+
+    if (pos < text.size())
+    {
+        if (text[pos] != 'e' && text[pos] != 'E')
+            return false;
+
+        size_t exponentEnd = 0;
+        try {
+            numIntegerDigits += std::stoi (text.substr (pos + 1), &exponentEnd);
+        } catch (...) {
+            return false;
+        }
+        if (pos + 1 + exponentEnd != text.size())
+            return false;
+    }
+
+    // Pad so the point falls inside the digits
+    if (numIntegerDigits < 0) {
+        digits.insert (0, static_cast<size_t> (-numIntegerDigits), '0');
+        numIntegerDigits = 0;
+    } else if (numIntegerDigits > static_cast<int> (digits.size())) {
+        digits.append (static_cast<size_t> (numIntegerDigits) - digits.size(), '0');
+    }
+
+    uint64_t integer = 0;
+    for (int i = 0; i < numIntegerDigits; i++)
+    {
+        integer = integer * 10 + static_cast<uint64_t> (digits[static_cast<size_t> (i)] - '0');
+        if (integer >= (1u << 31))
+            return false;
+    }
+
+    // log2(10) < 10/3, so this many bits keep every fraction digit
+    const int numFractionDigits = static_cast<int> (digits.size()) - numIntegerDigits;
+    FixedPoint value;
+    value.m_limbs.assign (static_cast<size_t> ((numFractionDigits * 10 / 3) / 32 + 3), 0);
+
+    // Horner's rule from the last digit: f = (digit + f) / 10
+    for (int i = static_cast<int> (digits.size()) - 1; i >= numIntegerDigits; i--)
+    {
+        value.m_limbs[0] += static_cast<uint32_t> (digits[static_cast<size_t> (i)] - '0');
+
+        uint64_t remainder = 0;
+        for (auto& limb : value.m_limbs)
+        {
+            const uint64_t current = (remainder << 32) | limb;
+            limb = static_cast<uint32_t> (current / 10);
+            remainder = current % 10;
+        }
+    }
+
+    value.m_limbs[0] = static_cast<uint32_t> (integer);
+    value.m_isNegative = isNegative && ! value.isZero();
+    result = value;
+    return true;
+}
+
+double FixedPoint::toDouble() const noexcept {
+    // Four limbs cover a double's 53 bits wherever the leading one is
+    double value = 0;
+    for (int k = std::min (static_cast<int> (m_limbs.size()), 4) - 1; k >= 0; k--)
+        value = value / limbScale + m_limbs[static_cast<size_t> (k)];
+    return m_isNegative ? -value : value;
+}
+
+FixedPoint FixedPoint::withFractionLimbs (const int numFractionLimbs) const {
+    FixedPoint result (*this);
+    result.m_limbs.resize (static_cast<size_t> (std::max (numFractionLimbs, 0)) + 1, 0);
+    if (result.isZero())
+        result.m_isNegative = false;
+    return result;
+}
+
+FixedPoint FixedPoint::operator-() const {
+    FixedPoint result (*this);
+    result.m_isNegative = ! m_isNegative && ! isZero();
+    return result;
+}
+
+FixedPoint FixedPoint::operator+ (const FixedPoint& other) const {
+    return addSigned (*this, other, false);
+}
+
+FixedPoint FixedPoint::operator- (const FixedPoint& other) const {
+    return addSigned (*this, other, true);
+}
+
+FixedPoint FixedPoint::addSigned (const FixedPoint& a, const FixedPoint& b, const bool negateB) {
+    const size_t numLimbs = std::max (a.m_limbs.size(), b.m_limbs.size());
+    auto limbOf = [] (const FixedPoint& x, const size_t k) { return k < x.m_limbs.size() ? x.m_limbs[k] : 0u; };
+
+    FixedPoint result;
+    result.m_limbs.assign (numLimbs, 0);
+
+    const bool bIsNegative = b.m_isNegative != negateB;
+
+    if (a.m_isNegative == bIsNegative)
+    {
+        uint64_t carry = 0;
+        for (size_t k = numLimbs; k-- > 0;)
+        {
+            const uint64_t sum = static_cast<uint64_t> (limbOf (a, k)) + limbOf (b, k) + carry;
+            result.m_limbs[k] = static_cast<uint32_t> (sum);
+            carry = sum >> 32;
+        }
+        result.m_isNegative = a.m_isNegative;
+    }
+    else
+    {
+        // Subtract the smaller magnitude from the larger
+        bool aIsLarger = true;
+        for (size_t k = 0; k < numLimbs; k++)
+        {
+            if (limbOf (a, k) != limbOf (b, k)) {
+                aIsLarger = limbOf (a, k) > limbOf (b, k);
+                break;
+            }
+        }
+
+        const FixedPoint& larger = aIsLarger ? a : b;
+        const FixedPoint& smaller = aIsLarger ? b : a;
+
+        int64_t borrow = 0;
+        for (size_t k = numLimbs; k-- > 0;)
+        {
+            int64_t difference = static_cast<int64_t> (limbOf (larger, k)) - limbOf (smaller, k) - borrow;
+            borrow = difference < 0 ? 1 : 0;
+            if (difference < 0)
+                difference += static_cast<int64_t> (1) << 32;
+            result.m_limbs[k] = static_cast<uint32_t> (difference);
+        }
+        result.m_isNegative = aIsLarger ? a.m_isNegative : bIsNegative;
+    }
+
+    if (result.isZero())
+        result.m_isNegative = false;
+    return result;
+}
+
+FixedPoint FixedPoint::operator* (const FixedPoint& other) const {
+    const size_t numLimbs = std::max (m_limbs.size(), other.m_limbs.size());
+    const auto a = withFractionLimbs (static_cast<int> (numLimbs) - 1);
+    const auto b = other.withFractionLimbs (static_cast<int> (numLimbs) - 1);
+
+    // Schoolbook multiplication from the least significant limbs up; limb i
+    // times limb j lands in limb i + j, and anything past numLimbs is dropped
+    std::vector<uint32_t> product (numLimbs * 2, 0);
+
+    for (size_t i = numLimbs; i-- > 0;)
+    {
+        uint64_t carry = 0;
+        for (size_t j = numLimbs; j-- > 0;)
+        {
+            const uint64_t term = static_cast<uint64_t> (a.m_limbs[i]) * b.m_limbs[j] + product[i + j] + carry;
+            product[i + j] = static_cast<uint32_t> (term);
+            carry = term >> 32;
+        }
+        if (i > 0)
+            product[i - 1] = static_cast<uint32_t> (carry);
+    }
+
+    FixedPoint result;
+    result.m_limbs.assign (product.begin(), product.begin() + static_cast<std::ptrdiff_t> (numLimbs));
+    result.m_isNegative = m_isNegative != other.m_isNegative && ! result.isZero();
+    return result;
+}
+
+int FixedPoint::getLimbsFor (const double resolution) noexcept {
+    // Two guard limbs keep the truncation in products well below one step
+    const double bits = resolution > 0 ? -std::log2 (resolution) : 0.0;
+    return std::max (2, static_cast<int> (std::ceil (bits / 32.0)) + 2);
+}
+
+bool FixedPoint::isZero() const noexcept {
+    return std::all_of (m_limbs.begin(), m_limbs.end(), [] (const uint32_t limb) { return limb == 0; });
+}
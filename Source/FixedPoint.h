@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    FixedPoint.h
+    Created: 20 Oct 2026 2:12:48pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//==============================================================================
+/*
+    A signed fixed-point number with as many 32-bit fraction limbs as it
+    needs, for view coordinates that are deeper than a double can hold.
+
+    The integer part is a single limb, which is plenty for the escape-time
+    loop where nothing outside radius 2 is ever squared. Converting from a
+    double is exact, and the sum or product of two numbers keeps the limbs
+    of the longer one; products are truncated to that length.
+*/
+class FixedPoint
+{
+public:
+    FixedPoint() = default;
+
+    // Exact: a double never needs more than 34 fraction limbs
+    explicit FixedPoint (const double value);
+
+    /*  Reads a decimal such as "-0.743643887037158704752191506114774" or
+        "1.5e-3" into enough limbs to keep every digit. Returns false if the
+        text isn't a number or its magnitude is 2^31 or more.
+    */
+    static bool parse (const std::string& text, FixedPoint& result);
+
+    // The nearest double, give or take the last bit
+    double toDouble() const noexcept;
+
+    int getNumFractionLimbs() const noexcept    { return static_cast<int> (m_limbs.size()) - 1; }
+
+    // Drops or appends fraction limbs
+    FixedPoint withFractionLimbs (const int numFractionLimbs) const;
+
+    FixedPoint operator-() const;
+    FixedPoint operator+ (const FixedPoint& other) const;
+    FixedPoint operator- (const FixedPoint& other) const;
+    FixedPoint operator* (const FixedPoint& other) const;
+
+    FixedPoint& operator+= (const FixedPoint& other)  { return *this = *this + other; }
+    FixedPoint& operator-= (const FixedPoint& other)  { return *this = *this - other; }
+
+    // Fraction limbs needed to resolve steps of the given size, plus guard limbs
+    static int getLimbsFor (const double resolution) noexcept;
+
+private:
+    static FixedPoint addSigned (const FixedPoint& a, const FixedPoint& b, const bool negateB);
+    bool isZero() const noexcept;
+
+    // Limb 0 is the integer part, limb k is worth 2^(-32k)
+    std::vector<uint32_t> m_limbs { 0 };
+    bool m_isNegative { false };
+};
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+
+    Formula.h
+    Created: 22 Oct 2026 3:37:08pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cmath>
+#include <type_traits>
+
+//==============================================================================
+/*
+    The family of maps the escape-time loop can iterate, z -> f (z)^power + c
+    where f folds z before it is raised:
+
+    - standard:     f (z) = z, giving the Mandelbrot set and its multibrots
+    - tricorn:      f (z) = conj (z), the Mandelbar set
+    - burningShip:  f (z) = |re z| + i |im z|
+*/
+enum class FormulaVariant
+{
+    standard,
+    tricorn,
+    burningShip
+};
+
+struct Formula
+{
+    int power { 2 };
+    FormulaVariant variant { FormulaVariant::standard };
+
+    static constexpr int minPower = 2;
+    static constexpr int maxPower = 6;
+
+    // z^2 + c, the only formula with hand-written kernels, interior tests and perturbation
+    bool isQuadratic() const noexcept   { return power == 2 && variant == FormulaVariant::standard; }
+
+    // Whether c -> conj (c) mirrors the Mandelbrot-style frame
+    bool hasConjugateSymmetry() const noexcept  { return variant != FormulaVariant::burningShip; }
+
+    // Whether z -> -z mirrors the Julia-style frame, which needs f (-z)^power == f (z)^power
+    bool hasPointSymmetry() const noexcept
+    {
+        return variant == FormulaVariant::burningShip || power % 2 == 0;
+    }
+
+    bool operator== (const Formula& other) const noexcept
+    {
+        return power == other.power && variant == other.variant;
+    }
+
+    bool operator!= (const Formula& other) const noexcept  { return ! operator== (other); }
+};
+
+//==============================================================================
+/*
+    One step of a formula with its power and variant fixed at compile time,
+    so the loops that call it have no branches or calls left for either.
+    N is anything with +, -, * and unary minus; Maths supplies makeAbsolute(),
+    which works in place so that vector types are never returned by a call.
+
+    The quadratic case rounds exactly as the hand-written z^2 + c loops do,
+    so every kernel agrees on it bit for bit.
+*/
+template <int power, typename N>
+inline void raisePower (N& re, N& im) noexcept
+{
+    static_assert (power >= 1, "powers start at 1");
+
+    if constexpr (power == 2)
+    {
+        const N product = re * im;
+        re = re * re - im * im;
+        im = product + product;
+    }
+    else if constexpr (power % 2 == 0)
+    {
+        raisePower<2> (re, im);
+        raisePower<power / 2> (re, im);
+    }
+    else if constexpr (power > 1)
+    {
+        const N baseRe = re, baseIm = im;
+        raisePower<power - 1> (re, im);
+        const N newRe = re * baseRe - im * baseIm;
+        im = re * baseIm + im * baseRe;
+        re = newRe;
+    }
+}
+
+template <int power, FormulaVariant variant, typename Maths, typename N>
+inline void stepFormula (N& re, N& im, const N& cRe, const N& cIm) noexcept
+{
+    if constexpr (variant == FormulaVariant::tricorn)
+    {
+        im = -im;
+    }
+    else if constexpr (variant == FormulaVariant::burningShip)
+    {
+        Maths::makeAbsolute (re);
+        Maths::makeAbsolute (im);
+    }
+
+    raisePower<power> (re, im);
+    re = re + cRe;
+    im = im + cIm;
+}
+
+struct ScalarMaths
+{
+    template <typename N>
+    static void makeAbsolute (N& x) noexcept   { x = std::abs (x); }
+};
+
+/*  Calls function (power, variant) with both as std::integral_constants, so
+    it can instantiate the loop for this formula. This is the one runtime
+    branch on the formula, taken once per batch of orbits.
+*/
+template <typename Function>
+inline void withFormula (const Formula& formula, Function&& function)
+{
+    auto withPower = [&] (auto variant)
+    {
+        switch (formula.power)
+        {
+            case 3:  function (std::integral_constant<int, 3>(), variant); break;
+            case 4:  function (std::integral_constant<int, 4>(), variant); break;
+            case 5:  function (std::integral_constant<int, 5>(), variant); break;
+            case 6:  function (std::integral_constant<int, 6>(), variant); break;
+            default: function (std::integral_constant<int, 2>(), variant); break;
+        }
+    };
+
+    switch (formula.variant)
+    {
+        case FormulaVariant::tricorn:     withPower (std::integral_constant<FormulaVariant, FormulaVariant::tricorn>()); break;
+        case FormulaVariant::burningShip: withPower (std::integral_constant<FormulaVariant, FormulaVariant::burningShip>()); break;
+        default:                          withPower (std::integral_constant<FormulaVariant, FormulaVariant::standard>()); break;
+    }
+}
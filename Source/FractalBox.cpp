@@ -11,32 +11,62 @@
 #include <JuceHeader.h>
 #include "FractalBox.h"
 #include "JuliaBox.h"
-#include <complex>
 
 //==============================================================================
 FractalBox::FractalBox() {
     m_orbitVec.reserve(static_cast<size_t>(m_maxOrbitLen));
+    m_renderEngine.onTilesPublished = [this] (const juce::Rectangle<int>& area) {
+        repaint(DynamicResolution::toLogical(area, m_imageScale));
+        m_resolution.addFrame(m_renderEngine.getStats().getLatestFrame(), m_imageScale,
+                              static_cast<int>(m_width), static_cast<int>(m_height));
+        if (m_showStats) repaint(getStatsOverlayBounds());
+    };
+    m_resolution.onIdle = [this] {
+        // The last frames were rendered small for speed; now there's time for every pixel
+        if (m_mode == Mode::escapeTime && m_imageScale != m_resolution.getScale())
+            drawFractal();
+    };
+    m_renderEngine.setTileCacheBudget(tileCacheBudget);
+    m_buddhabrotEngine.onPassPublished = [this] (const juce::Rectangle<int>& area) { repaint(area); };
+    setWantsKeyboardFocus(true);
 }
 
 FractalBox::~FractalBox() {}
 
 void FractalBox::paint (juce::Graphics& g)
 {
+    // Moving to a screen with another scale needs a render as much as resizing does
+    const bool scaleChanged = m_resolution.setDisplayScale(getApproximateScaleFactorForComponent(this));
     if (hasSizeChanged(getWidth(), getHeight())) {
         initImage();
         drawFractal();
+    } else if (scaleChanged) {
+        drawFractal();
     }
     auto bounds = getLocalBounds();
     g.setColour(juce::Colours::black);
     g.drawRect(bounds);
     
     
-    g.drawImageAt(m_image, 0, 0);
+    // Timed into the frame the image shows, so slow paints show up next to slow renders
+    const auto paintStarted = RenderStats::Clock::now();
+    if (m_openedFile != nullptr) {
+        g.fillAll(juce::Colours::black);
+        g.drawImageAt(m_openedImage, (getWidth() - m_openedImage.getWidth()) / 2,
+                      (getHeight() - m_openedImage.getHeight()) / 2);
+    } else {
+        g.drawImage(m_image, getLocalBounds().toFloat());
+    }
+    m_renderEngine.getStats().addEvent(m_renderEngine.getCurrentFrame(), RenderStage::paint, -1,
+                                       paintStarted, RenderStats::Clock::now());
     
     g.drawLine(getWidth()/2, 0, getWidth()/2, getHeight());
     g.drawLine(0, getHeight()/2, getWidth(), getHeight()/2);
     
     drawOrbit(g);
+
+    if (m_showStats)
+        drawStatsOverlay(g, m_renderEngine.getStats().getLatestFrame(), m_resolution.getDescription());
 }
 
 void FractalBox::resized() {}
@@ -73,42 +103,149 @@ void FractalBox::drawOrbit(juce::Graphics& g) {
 }
 
 void FractalBox::drawFractal() {
-    // Calculate Brot
-    int nIterations = 0;
-    
-    juce::Colour value;
+    if (m_openedFile != nullptr) {
+        m_openedFile = nullptr;
+        m_openedImage = {};
+        repaint();
+    }
 
-    for (int ptX = 0; ptX < getWidth(); ptX++)
-    {
-        for (int ptY = 0; ptY < getHeight(); ptY++)
-        {
-            nIterations = calcIterations(ptX, ptY);
-            if (nIterations == 0) value = juce::Colour(0,0,0);
-            else value = juce::Colour(255, 255-nIterations, 255-nIterations);
-            m_image.setPixelAt(ptX, ptY, value);
-        }
+    if (m_mode != Mode::escapeTime) {
+        // Samples keep coming in until the view changes, so the density sharpens in place
+        m_renderScheduler.cancel();
+        BuddhabrotOptions options;
+        options.anti = m_mode == Mode::antiBuddhabrot;
+        setImageScale(1.0);
+        m_buddhabrotEngine.start(getFractalParams(), options, m_image);
+        return;
     }
-}
 
-int FractalBox::calcIterations (const int x, const int y) {
-    auto mathPoint = getMathCoord(x, y);
-    auto complexPoint = std::complex<double>(mathPoint.getX(), mathPoint.getY());
-    
-    std::complex<double> complexZ(0, 0);
+    m_buddhabrotEngine.stop();
 
-    int nIterations = m_minIterations;
+    // Tiles are rendered on the engine's pool and copied into m_image as they finish.
+    // Going through the scheduler means a burst of drag events costs one render per frame.
+    const double scale = m_resolution.getScale();
+    auto params = getFractalParams(scale);
+    if (params.precision == Precision::perturbation)
+        params.reference = getReferenceOrbit(params, scale);
+    setImageScale(scale);
+    m_renderScheduler.requestRender(params, getLatticePosition(scale));
 
-    while ((abs(complexZ) < 2 ) && ( nIterations <= m_maxIterations ))
-    {
-        complexZ = complexZ * complexZ + complexPoint;
-        nIterations++;
-    }
+    // The Julia box keeps small renders of the constants in view, for drags through them
+    if (m_juliaBox != nullptr)
+        m_juliaBox->setAtlasArea({params.mathX(0), params.mathY(0),
+                                  params.width * params.pixelSize, params.height * params.pixelSize});
+}
 
-    if (nIterations < m_maxIterations) {
-        return static_cast<int>(( 255 * nIterations ) / m_maxIterations );
-    } else {
-        return 0;
+std::shared_ptr<const ReferenceOrbit> FractalBox::getReferenceOrbit(const FractalParams& params, const double scale) {
+    // One orbit serves every limit up to the one it was iterated for, so
+    // lowering the limit or recolouring doesn't redo the high precision work.
+    // Each scale has a centre of its own, which the orbit has to start from
+    if (m_reference == nullptr || m_referenceScale != scale || m_reference->getMaxIterations() < params.maxIterations) {
+        m_reference = std::make_shared<const ReferenceOrbit>(params, getCentreX(scale), getCentreY(scale));
+        m_referenceScale = scale;
     }
+    return m_reference;
+}
+
+double FractalBox::getSpan() const {
+    return 4.0 * std::exp2(-m_zoomLevel / static_cast<double>(levelsPerOctave));
+}
+
+double FractalBox::getPixelSize() const {
+    // What FractalParams::fitToSpan() works out
+    return getSpan() / static_cast<int>(juce::jmin(m_width, m_height));
+}
+
+FixedPoint FractalBox::getCentreX(const double scale) const {
+    const int width = DynamicResolution::getScaledSize(static_cast<int>(m_width), scale);
+    return m_anchorX + FixedPoint((getLatticePosition(scale).x + width * 0.5) * (getPixelSize() / scale));
+}
+
+FixedPoint FractalBox::getCentreY(const double scale) const {
+    const int height = DynamicResolution::getScaledSize(static_cast<int>(m_height), scale);
+    return m_anchorY + FixedPoint((getLatticePosition(scale).y + height * 0.5) * (getPixelSize() / scale));
+}
+
+LatticePosition FractalBox::getLatticePosition(const double scale) const {
+    // Another scale is a finer or coarser lattice from the same anchor, so
+    // each scale keeps its own tiles in the cache and a drag at one reuses them
+    if (scale == 1.0)
+        return m_lattice;
+    return { m_lattice.anchor, std::llround(m_lattice.x * scale), std::llround(m_lattice.y * scale) };
+}
+
+void FractalBox::setCentre(const FixedPoint& centreX, const FixedPoint& centreY) {
+    // A new anchor starts a new lattice, which has nothing cached yet
+    const double pixelSize = m_width > 0 && m_height > 0 ? getPixelSize() : 0.0;
+    m_anchorX = centreX - FixedPoint(m_width * 0.5 * pixelSize);
+    m_anchorY = centreY - FixedPoint(m_height * 0.5 * pixelSize);
+    m_lattice.anchor++;
+    m_lattice.x = 0;
+    m_lattice.y = 0;
+}
+
+void FractalBox::keepLatticeNearAnchor() {
+    // Zooming scales lattice positions in doubles, which stop landing on the
+    // right pixel long before an int64 runs out
+    if (std::abs(m_lattice.x) > maxLatticeOffset || std::abs(m_lattice.y) > maxLatticeOffset)
+        setCentre(getCentreX(), getCentreY());
+}
+
+void FractalBox::zoomAbout(const juce::Point<int> pixel, const int levels) {
+    const int zoomLevel = juce::jlimit(minZoomLevel, maxZoomLevel, m_zoomLevel + levels);
+    if (zoomLevel == m_zoomLevel)
+        return;
+
+    // Keep the maths point under the pixel where it is, to the nearest pixel
+    const double oldPixelSize = getPixelSize();
+    m_zoomLevel = zoomLevel;
+    const double scale = oldPixelSize / getPixelSize();
+
+    m_lattice.x = std::llround((m_lattice.x + pixel.getX()) * scale) - pixel.getX();
+    m_lattice.y = std::llround((m_lattice.y + pixel.getY()) * scale) - pixel.getY();
+    keepLatticeNearAnchor();
+    viewChanged();
+}
+
+void FractalBox::panBy(const juce::Point<int> pixelOffset) {
+    m_lattice.x -= pixelOffset.getX();
+    m_lattice.y -= pixelOffset.getY();
+    keepLatticeNearAnchor();
+    viewChanged();
+}
+
+void FractalBox::viewChanged() {
+    // The orbit overlay was drawn for the old view
+    m_orbitVec.clear();
+    m_reference = nullptr;
+    drawFractal();
+    repaint();
+}
+
+void FractalBox::resetView() {
+    m_zoomLevel = 0;
+    m_wheelLevels = 0;
+    setCentre(FixedPoint(), FixedPoint());
+    viewChanged();
+}
+
+FractalParams FractalBox::getFractalParams(const double scale) const {
+    FractalParams params;
+    params.type = FractalType::mandelbrot;
+    params.formula = m_formula;
+    params.width = DynamicResolution::getScaledSize(static_cast<int>(m_width), scale);
+    params.height = DynamicResolution::getScaledSize(static_cast<int>(m_height), scale);
+    const auto centreX = getCentreX(scale);
+    const auto centreY = getCentreY(scale);
+    params.centreX = centreX.toDouble();
+    params.centreY = centreY.toDouble();
+    params.centreXLow = (centreX - FixedPoint(params.centreX)).toDouble();
+    params.centreYLow = (centreY - FixedPoint(params.centreY)).toDouble();
+    params.pixelSize = getPixelSize() / scale;
+    params.minIterations = static_cast<int>(m_minIterations);
+    params.maxIterations = static_cast<int>(m_maxIterations);
+    params.precision = choosePrecision(params, true);
+    return params;
 }
 
 bool FractalBox::hasSizeChanged(const int curWidth, const int curHeight) {
@@ -118,83 +255,308 @@ bool FractalBox::hasSizeChanged(const int curWidth, const int curHeight) {
 }
 
 void FractalBox::initImage() {
+    // The pixel size follows the size, so the same centre goes on a new lattice
+    const bool hadSize = m_width > 0 && m_height > 0;
+    const auto centreX = hadSize ? getCentreX() : FixedPoint();
+    const auto centreY = hadSize ? getCentreY() : FixedPoint();
+
     m_width = getWidth();
     m_height = getHeight();
-    m_imageRatio = static_cast<double>(getWidth())/static_cast<double>(getHeight());
-    if (m_imageRatio >= 1.f) {
-        m_widthMath = 4 * m_imageRatio;
-        m_heightMath = 4;
-    } else {
-        m_widthMath = 4;
-        m_heightMath = 4 / m_imageRatio;
-    }
-    m_image = juce::Image(juce::Image::RGB, m_width, m_height, true);
+    m_image = {};
+    setImageScale(m_resolution.getScale());
+    m_reference = nullptr;
+    setCentre(centreX, centreY);
+}
+
+void FractalBox::setImageScale(const double scale) {
+    // The old image is stretched to the new size, so there's something to
+    // show until the frame at that size comes in
+    m_imageScale = scale;
+    const int width = DynamicResolution::getScaledSize(static_cast<int>(m_width), scale);
+    const int height = DynamicResolution::getScaledSize(static_cast<int>(m_height), scale);
+    if (m_image.getWidth() == width && m_image.getHeight() == height)
+        return;
+
+    m_renderEngine.setProgressive(true, RenderEngine::chooseCoarsestStep(width, height));
+    m_image = m_image.isValid() ? m_image.rescaled(width, height, juce::Graphics::lowResamplingQuality)
+                                : juce::Image(juce::Image::RGB, width, height, true);
 }
 
 juce::Point<double> FractalBox::getMathCoord(const int x, const int y) {
-    juce::Point<double> pointOut;
-    if (m_imageRatio >= 1) {
-        pointOut = juce::Point<double>(
-               4*m_imageRatio*(static_cast<double>(x) / getWidth() - 0.5),  4*(static_cast<double>(y) / getHeight() - 0.5));
-    } else {
-        pointOut = juce::Point<double>(
-               4*(static_cast<double>(x) / getWidth() - 0.5),  4/m_imageRatio*(static_cast<double>(y) / getHeight() - 0.5));
-    }
-    return pointOut;
+    // The same mapping the renderer uses, so a click lands on the pixel it hit
+    const auto params = getFractalParams();
+    return juce::Point<double>(params.mathX(x), params.mathY(y));
 }
 
 juce::Point<int> FractalBox::getDispCoord(const double x, const double y) {
-    double xDisp = static_cast<double>(m_width) * (x + static_cast<double>(m_widthMath) / 2.f) / static_cast<double>(m_widthMath);
-    double yDisp = static_cast<double>(m_height) * (y + static_cast<double>(m_heightMath) / 2.f) / static_cast<double>(m_heightMath);
-    auto outPoint = juce::Point<int>(std::round(xDisp), std::round(yDisp));
+    const auto params = getFractalParams();
+    return juce::Point<int>(std::round(params.pixelX(x)), std::round(params.pixelY(y)));
+}
 
-    return outPoint;
+void FractalBox::calcOrbit(juce::Point<double> coordinate) {
+    // Called on every drag event, so both vectors keep their storage
+    m_orbitVec.clear();
+    m_orbitVec.push_back(getDispCoord(coordinate.getX(), coordinate.getY()));
+
+    ::calcOrbit({coordinate.getX(), coordinate.getY()}, static_cast<int>(m_maxOrbitLen), m_orbit, m_formula);
+    for (const auto& z : m_orbit)
+        m_orbitVec.push_back(getDispCoord(z.real(), z.imag()));
 }
 
-std::vector<juce::Point<int>> FractalBox::calcOrbit(juce::Point<double> coordinate) {
-    //  Do the same calculation as get color value
-    std::complex<double> complexPoint(coordinate.getX(), coordinate.getY());
-    std::complex<double> complexZ(0, 0);
+void FractalBox::openIterationFile() {
+    // Made by fractal-render --checkpoint; the chooser has to outlive this call
+    m_fileChooser = std::make_unique<juce::FileChooser>("Open an iteration file",
+        juce::File::getSpecialLocation(juce::File::userDocumentsDirectory));
 
-    auto currentPoint = getDispCoord(coordinate.getX(), coordinate.getY());
-    m_orbitVec.clear();
-    m_orbitVec = {currentPoint};
+    const auto flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles;
+    m_fileChooser->launchAsync(flags, [this] (const juce::FileChooser& chooser) {
+        const auto path = chooser.getResult().getFullPathName();
+        if (path.isEmpty())
+            return;
 
-    int currentstep = 0;
-    while ((abs(complexZ) < 2 ) && ( currentstep < m_maxOrbitLen ))
-    {
-        complexZ = complexZ * complexZ + complexPoint;
-        currentPoint = getDispCoord(complexZ.real(), complexZ.imag());
+        auto file = std::make_unique<IterationFile>(path.toStdString(), false);
+        if (! file->isOpen()) {
+            juce::Logger::writeToLog("Couldn't open " + path + " as an iteration file");
+            return;
+        }
+
+        m_openedFile = std::move(file);
+        showOpenedFile();
+    });
+}
+
+void FractalBox::showOpenedFile() {
+    // The nearest pixel of the file to each one shown, so a gigapixel file
+    // costs no more to show than one the size of the box
+    const auto& params = m_openedFile->getParams();
+    const double scale = juce::jmin(1.0, juce::jmin(getWidth() / static_cast<double>(params.width),
+                                                    getHeight() / static_cast<double>(params.height)));
+    const int width = juce::jmax(1, static_cast<int>(params.width * scale));
+    const int height = juce::jmax(1, static_cast<int>(params.height * scale));
 
-        m_orbitVec.push_back(currentPoint);
-        currentstep++;
+    // Pixels of tiles still to render are left out, and left transparent
+    const auto numPixels = static_cast<size_t>(width) * static_cast<size_t>(height);
+    std::vector<int> counts(numPixels, -1);
+    std::vector<float> magnitudes(numPixels, 0.f);
+
+    for (int ptY = 0; ptY < height; ptY++) {
+        const int fileY = juce::jmin(static_cast<int>((ptY + 0.5) / scale), params.height - 1);
+        for (int ptX = 0; ptX < width; ptX++) {
+            const int fileX = juce::jmin(static_cast<int>((ptX + 0.5) / scale), params.width - 1);
+            if (! m_openedFile->isTileDone(m_openedFile->getTileAt(fileX, fileY)))
+                continue;
+
+            const auto index = static_cast<size_t>(ptY) * static_cast<size_t>(width) + static_cast<size_t>(ptX);
+            counts[index] = m_openedFile->clampCount(m_openedFile->getCounts(fileY)[fileX]);
+            magnitudes[index] = m_openedFile->getMagnitudes(fileY)[fileX];
+        }
+    }
+
+    // A histogram over what is shown, like the render's own
+    auto palette = m_renderEngine.getPalette();
+    palette.build(params.minIterations, params.maxIterations, counts.data(), counts.size());
+
+    m_openedImage = juce::Image(juce::Image::ARGB, width, height, true);
+    const juce::Image::BitmapData bitmap(m_openedImage, juce::Image::BitmapData::writeOnly);
+    for (int ptY = 0; ptY < height; ptY++) {
+        for (int ptX = 0; ptX < width; ptX++) {
+            const auto index = static_cast<size_t>(ptY) * static_cast<size_t>(width) + static_cast<size_t>(ptX);
+            if (counts[index] >= 0)
+                bitmap.setPixelColour(ptX, ptY, juce::Colour(palette.getColour(counts[index], magnitudes[index])));
+        }
+    }
+
+    juce::Logger::writeToLog(juce::String("Showing a ") + juce::String(params.width) + "x" + juce::String(params.height)
+                             + " iteration file, " + juce::String(m_openedFile->getNumTilesDone()) + " of "
+                             + juce::String(m_openedFile->getNumTiles()) + " tiles done");
+    repaint();
+}
+
+void FractalBox::toggleRecording() {
+    // The drags between two presses, as points in the order they came, for fractal-render to animate
+    m_isRecording = ! m_isRecording;
+    if (m_isRecording) {
+        m_recordedPath.clear();
+        juce::Logger::writeToLog("Recording the Julia constants dragged through, until p is pressed again");
+        return;
+    }
+
+    if (m_recordedPath.empty()) {
+        juce::Logger::writeToLog("Nothing was dragged through, so no path was written");
+        return;
+    }
+
+    const auto file = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                          .getNonexistentChildFile("FractalFactory path", ".txt", false);
+    if (! writeJuliaPath(file.getFullPathName().toStdString(), m_recordedPath)) {
+        juce::Logger::writeToLog("Couldn't write the Julia path");
+        return;
     }
-    return m_orbitVec;
+
+    juce::Logger::writeToLog(juce::String(static_cast<int>(m_recordedPath.size())) + " Julia constants written to "
+                             + file.getFullPathName() + "; animate them with fractal-render --path");
 }
 
 void FractalBox::mouseDown (const juce::MouseEvent& event) {
+    // Right or shift dragging moves the view instead of picking a point
+    m_isPanning = event.mods.isPopupMenu() || event.mods.isShiftDown();
+    if (m_isPanning) {
+        m_lastPanPosition = event.getMouseDownPosition();
+        return;
+    }
+
     auto point = juce::Point<int>(event.getMouseDownPosition());
-    m_orbitVec = calcOrbit(getMathCoord(point.getX(), point.getY()));
-    m_juliaBox->setNewFractal(getMathCoord(point.getX(), point.getY()));
+    auto pointD = getMathCoord(point.getX(), point.getY());
+    calcOrbit(pointD);
+    m_juliaBox->setNewFractal(pointD);
+    if (m_isRecording)
+        m_recordedPath.emplace_back(pointD.getX(), pointD.getY());
     m_mouseIsPressed = true;
     repaint();
 }
 
 void FractalBox::mouseDrag (const juce::MouseEvent& event) {
     juce::Point<int> point = event.getPosition();
+    if (m_isPanning) {
+        m_resolution.interacted();
+        panBy(point - m_lastPanPosition);
+        m_lastPanPosition = point;
+        return;
+    }
+
     auto pointD = getMathCoord(point.getX(), point.getY());
-    m_orbitVec = calcOrbit(pointD);
-    m_juliaBox->setNewFractal(pointD);
+    calcOrbit(pointD);
+    m_juliaBox->setNewFractal(pointD, true);
+    if (m_isRecording)
+        m_recordedPath.emplace_back(pointD.getX(), pointD.getY());
     repaint();
 }
 
 void FractalBox::mouseUp (const juce::MouseEvent& event) {
     m_mouseIsPressed = false;
+    m_isPanning = false;
     repaint();
 }
 
+void FractalBox::mouseWheelMove (const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) {
+    // Scrolling up zooms in on the point under the mouse, in whole levels so
+    // that a view zoomed back out lands on tiles that are still cached
+    m_wheelLevels += wheel.deltaY * 4.0 * levelsPerOctave;
+    const int levels = static_cast<int>(m_wheelLevels);
+    m_wheelLevels -= levels;
+
+    if (levels != 0) {
+        m_resolution.interacted();
+        zoomAbout(event.getPosition(), levels);
+    }
+}
+
+bool FractalBox::keyPressed (const juce::KeyPress& key) {
+    // Colour changes only recolour the stored iteration counts
+    auto& palette = m_renderEngine.getPalette();
+    auto character = key.getTextCharacter();
+
+    if (character == '+' || character == '=' || character == '-') {
+        // Raising the limit only continues the orbits that had not escaped yet
+        if (character == '-')
+            m_maxIterations = juce::jmax(m_minIterations + 1, m_maxIterations / 2);
+        else
+            m_maxIterations = juce::jmin(m_maxIterations * 2, maxIterationLimit);
+
+        if (m_mode != Mode::escapeTime || ! m_renderEngine.deepen(static_cast<int>(m_maxIterations)))
+            drawFractal();
+        return true;
+    }
+
+    if (character == 'b') {
+        if (m_mode == Mode::escapeTime) m_mode = Mode::buddhabrot;
+        else if (m_mode == Mode::buddhabrot) m_mode = Mode::antiBuddhabrot;
+        else m_mode = Mode::escapeTime;
+        drawFractal();
+        return true;
+    }
+
+    if (character == 'f') {
+        // z^2, z^3, z^4, then the tricorn and the Burning Ship
+        static const Formula formulas[] = {
+            { 2, FormulaVariant::standard }, { 3, FormulaVariant::standard }, { 4, FormulaVariant::standard },
+            { 2, FormulaVariant::tricorn }, { 2, FormulaVariant::burningShip }
+        };
+        m_formulaIndex = (m_formulaIndex + 1) % std::size(formulas);
+        m_formula = formulas[m_formulaIndex];
+        m_orbitVec.clear();
+        m_juliaBox->setFormula(m_formula);
+        drawFractal();
+        repaint();
+        return true;
+    }
+
+    if (character == 'i') {
+        m_showStats = ! m_showStats;
+        repaint(getStatsOverlayBounds());
+        return true;
+    }
+
+    if (character == 't') {
+        // Both boxes go in one trace, so their frames can be lined up
+        const auto file = exportChromeTrace({&m_renderEngine.getStats(), &m_juliaBox->getRenderStats()});
+        juce::Logger::writeToLog(file.existsAsFile() ? "Render trace written to " + file.getFullPathName()
+                                                     : juce::String("Couldn't write the render trace"));
+        return true;
+    }
+
+    if (character == 'o') {
+        openIterationFile();
+        return true;
+    }
+
+    if (character == 'p') {
+        toggleRecording();
+        return true;
+    }
+
+    if (character == 'a') {
+        // Off, then 4 and 16 samples across each pixel on an edge; only escape times have edges
+        if (m_mode == Mode::escapeTime) {
+            const int samples = m_renderEngine.getAntialiasing();
+            m_renderEngine.setAntialiasing(samples == 0 ? 4 : samples == 4 ? 16 : 0);
+        }
+        return true;
+    }
+
+    if (character == 's') {
+        m_renderEngine.setSubdivision(! m_renderEngine.isSubdividing());
+        drawFractal();
+        return true;
+    }
+
+    if (character == 'r') {
+        resetView();
+        return true;
+    }
+
+    if (character == 'c') {
+        if (palette.getMode() == Palette::Mode::classic) palette.setMode(Palette::Mode::smooth);
+        else if (palette.getMode() == Palette::Mode::smooth) palette.setMode(Palette::Mode::histogram);
+        else palette.setMode(Palette::Mode::classic);
+    } else if (character == '[') {
+        palette.setCycleOffset(palette.getCycleOffset() - 8);
+    } else if (character == ']') {
+        palette.setCycleOffset(palette.getCycleOffset() + 8);
+    } else {
+        return false;
+    }
+
+    // The density images have colours of their own
+    if (m_mode == Mode::escapeTime)
+        m_renderEngine.recolour();
+    if (m_openedFile != nullptr)
+        showOpenedFile();
+    return true;
+}
+
 void FractalBox::setNewOrbit(const juce::Point<double> orbitStart) {
-    m_orbitVec = calcOrbit(orbitStart);
+    calcOrbit(orbitStart);
     repaint();
 }
 
@@ -11,6 +11,15 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BuddhabrotEngine.h"
+#include "DynamicResolution.h"
+#include "RenderEngine.h"
+#include "RenderScheduler.h"
+#include "StatsOverlay.h"
+#include "FixedPoint.h"
+#include "IterationFile.h"
+#include "JuliaPath.h"
+#include "Perturbation.h"
 
 //==============================================================================
 /*
@@ -29,36 +38,102 @@ public:
     void mouseDown (const juce::MouseEvent& event) override;
     void mouseDrag (const juce::MouseEvent& event) override;
     void mouseUp (const juce::MouseEvent& event) override;
+    void mouseWheelMove (const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
+    bool keyPressed (const juce::KeyPress& key) override;
     
     void setNewOrbit(const juce::Point<double> orbitStart);
     void setJuliaBox(JuliaBox& juliaBox);
+    const RenderStats& getRenderStats() const { return m_renderEngine.getStats(); }
+    const DynamicResolution& getResolution() const { return m_resolution; }
     
 private:
     void drawOrbit(juce::Graphics& g);
-    int calcIterations(const int x, const int y);
     bool hasSizeChanged(const int curWidth, const int curHeight);
     void initImage();
+    void setImageScale(const double scale);
     void drawFractal();
+    FractalParams getFractalParams(const double scale = 1.0) const;
+    LatticePosition getLatticePosition(const double scale) const;
+    std::shared_ptr<const ReferenceOrbit> getReferenceOrbit(const FractalParams& params, const double scale);
+    double getSpan() const;
+    double getPixelSize() const;
+    FixedPoint getCentreX(const double scale = 1.0) const;
+    FixedPoint getCentreY(const double scale = 1.0) const;
+    void setCentre(const FixedPoint& centreX, const FixedPoint& centreY);
+    void keepLatticeNearAnchor();
+    void zoomAbout(const juce::Point<int> pixel, const int levels);
+    void panBy(const juce::Point<int> pixelOffset);
+    void resetView();
+    void viewChanged();
     juce::Point<double> getMathCoord(const int x, const int y);
     juce::Point<int> getDispCoord(const double x, const double y);
-    std::vector<juce::Point<int>> calcOrbit(juce::Point<double> coordinate);
+    void calcOrbit(juce::Point<double> coordinate);
+    void openIterationFile();
+    void showOpenedFile();
+    void toggleRecording();
     
     std::shared_ptr<JuliaBox> m_juliaBox{nullptr};
     
     juce::Image m_image;
+    RenderEngine m_renderEngine{"Mandelbrot"};
+    RenderScheduler m_renderScheduler{m_renderEngine, m_image};
+    BuddhabrotEngine m_buddhabrotEngine;
+    
+    // What the box shows: escape times, or the density of escaping (Buddhabrot)
+    // or trapped (anti-Buddhabrot) orbits over the same view
+    enum class Mode { escapeTime, buddhabrot, antiBuddhabrot };
+    Mode m_mode {Mode::escapeTime};
+    
+    // Cycled by the 'f' key, which the Julia box follows
+    Formula m_formula;
+    size_t m_formulaIndex {0};
     
     uint m_minIterations {1};
     uint m_maxIterations {40};
+    static constexpr uint maxIterationLimit {1 << 16};
     uint m_maxOrbitLen {25};
     uint m_width{0}, m_height{0};
     
-    double m_imageRatio {1.f};
-    double m_fracSize {4};
-    double m_widthMath {0.f}, m_heightMath {0.f};
+    // The view: zoom level n shows 4 * 2^(-n / levelsPerOctave) maths units
+    // across the shorter side. Image pixel (0, 0) is pixel (m_lattice.x, m_lattice.y)
+    // of the level's pixel lattice, whose pixel (0, 0) is the anchor, kept to any
+    // precision so zooming can go past what a double holds. Pans and zooms move
+    // whole lattice pixels, so views that overlap share the engine's cached tiles
+    int m_zoomLevel {0};
+    double m_wheelLevels {0};
+    FixedPoint m_anchorX, m_anchorY;
+    LatticePosition m_lattice;
+    static constexpr int levelsPerOctave {8};
+    static constexpr int minZoomLevel {-16};    // 16 units across
+    static constexpr int maxZoomLevel {7456};   // about 1e-280 across
+    static constexpr int64_t maxLatticeOffset {int64_t {1} << 40};
+    static constexpr size_t tileCacheBudget {size_t {128} << 20};
+    std::shared_ptr<const ReferenceOrbit> m_reference;
+    double m_referenceScale {1.0};
+    
+    // Escape times are rendered at m_imageScale image pixels per logical one:
+    // the display's scale at rest, less while a drag or zoom needs the speed.
+    // Mouse positions and the orbit overlay stay in logical pixels
+    DynamicResolution m_resolution;
+    double m_imageScale {1.0};
+    
+    // An iteration file shown in place of the render until the view changes,
+    // scaled down to the box so only the pixels shown are read from it
+    std::unique_ptr<IterationFile> m_openedFile;
+    juce::Image m_openedImage;
+    std::unique_ptr<juce::FileChooser> m_fileChooser;
+    
+    // Julia constants picked while recording, in order, for fractal-render --path
+    JuliaPath m_recordedPath;
+    bool m_isRecording {false};
     
     std::vector<juce::Point<int>> m_orbitVec;
+    std::vector<std::complex<double>> m_orbit;
     
     bool m_mouseIsPressed {false};
+    bool m_isPanning {false};
+    bool m_showStats {false};
+    juce::Point<int> m_lastPanPosition;
     
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FractalBox)
 };
@@ -0,0 +1,86 @@
+/*
+  ==============================================================================
+
+    FrameRenderer.cpp
+    Created: 19 Oct 2026 11:30:08am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "FrameRenderer.h"
+#include "RenderStats.h"
+#include "Subdivision.h"
+#include "Symmetry.h"
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+void renderFrame (const FractalParams& params, IterationBuffer& iterations,
+                  const FrameOptions& options) {
+    constexpr int tileSize = FrameOptions::tileSize;
+    const int tilesAcross = (params.width + tileSize - 1) / tileSize;
+    const int tilesDown = (params.height + tileSize - 1) / tileSize;
+    const int numTiles = tilesAcross * tilesDown;
+    const int fillableBelow = options.keepMagnitudes ? 0 : getFillableBelow (params);
+    const auto symmetry = options.useSymmetry ? planSymmetry (params) : SymmetryPlan();
+
+    std::atomic<int> nextTile {0};
+
+    auto renderTiles = [&]
+    {
+        for (int tile = nextTile++; tile < numTiles; tile = nextTile++)
+        {
+            const int tileX = (tile % tilesAcross) * tileSize;
+            const int tileY = (tile / tilesAcross) * tileSize;
+            const PixelArea area { tileX, tileY, std::min (tileSize, params.width - tileX),
+                                   std::min (tileSize, params.height - tileY) };
+            const auto parts = symmetry.getUniqueParts (area);
+            const auto started = RenderStats::Clock::now();
+
+            // Mirrored pixels are copied once every tile is done
+            for (const auto& part : parts)
+            {
+                if (options.subdivide)
+                {
+                    subdivideArea (params, iterations, part.x, part.y, part.width, part.height, fillableBelow);
+                    continue;
+                }
+
+                for (int ptY = part.y; ptY < part.getBottom(); ptY++)
+                    calcIterationsRow (params, ptY, part.x, part.width,
+                                       { iterations.getCounts (ptY) + part.x, iterations.getMagnitudes (ptY) + part.x },
+                                       1, options.simdLevel);
+            }
+
+            if (options.stats != nullptr)
+            {
+                options.stats->addEvent (options.statsFrame, RenderStage::iterate, tile, started, RenderStats::Clock::now());
+
+                int64_t numPixels = 0, numIterations = 0;
+                for (const auto& part : parts)
+                {
+                    numPixels += static_cast<int64_t> (part.width) * part.height;
+                    numIterations += countIterations (iterations, part, params.maxIterations);
+                }
+                options.stats->addTile (options.statsFrame, tile, numPixels, numIterations);
+            }
+        }
+    };
+
+    int numThreads = options.numThreads > 0 ? options.numThreads
+                                            : static_cast<int> (std::thread::hardware_concurrency());
+    numThreads = std::clamp (numThreads, 1, numTiles > 0 ? numTiles : 1);
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numThreads; i++)
+        threads.emplace_back (renderTiles);
+
+    renderTiles();
+
+    for (auto& thread : threads)
+        thread.join();
+
+    mirrorArea (symmetry, iterations, { 0, 0, params.width, params.height });
+}
@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    FrameRenderer.h
+    Created: 19 Oct 2026 11:30:08am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "EscapeTime.h"
+#include "IterationBuffer.h"
+
+class RenderStats;
+
+//==============================================================================
+/*
+    Iterates a whole frame on plain std::threads, for code that runs without
+    a message loop such as the command-line renderer. Threads take square
+    tiles from a shared counter until none are left, so a busy tile never
+    holds the others up.
+*/
+struct FrameOptions
+{
+    // 0 means one thread per hardware thread
+    int numThreads { 0 };
+
+    // Mariani-Silver subdivision instead of iterating every pixel
+    bool subdivide { false };
+
+    // Only fill the interior when subdividing, so smooth colouring stays exact
+    bool keepMagnitudes { false };
+
+    // Iterate one side of a symmetric frame and mirror it, see Symmetry.h
+    bool useSymmetry { true };
+
+    SimdLevel simdLevel { getSimdLevel() };
+
+    // Times every tile into this frame of stats, if there are any
+    RenderStats* stats { nullptr };
+    int statsFrame { -1 };
+
+    static constexpr int tileSize = 64;
+};
+
+void renderFrame (const FractalParams& params, IterationBuffer& iterations,
+                  const FrameOptions& options = {});
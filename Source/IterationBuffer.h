@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+
+    IterationBuffer.h
+    Created: 18 Oct 2026 9:41:10am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+//==============================================================================
+/*
+    The result of iterating a frame, kept separately from the image: the raw
+    loop count of every pixel and |z| where its loop stopped. Anything that
+    only changes colours reads this instead of iterating again.
+
+    Pixels that hit the iteration limit also keep the z they stopped at, in
+    one list per region of the frame, so raising the limit later only has to
+    continue those orbits instead of starting every pixel again.
+
+    A buffer can start left of and above pixel (0, 0), so a frame can keep a
+    margin around the visible image and still be indexed in image
+    coordinates: getCounts (y)[x] is pixel (x, y) for getX() <= x < getX() +
+    getWidth().
+*/
+class IterationBuffer
+{
+public:
+    struct PendingOrbit
+    {
+        int x, y;
+        double re, im;
+    };
+
+    // The origin is where the buffer starts, so it is never positive
+    IterationBuffer (const int width, const int height, const int numRegions = 1,
+                     const int originX = 0, const int originY = 0)
+        : m_x (std::min (originX, 0)), m_y (std::min (originY, 0)),
+          m_width (width), m_height (height),
+          m_counts (static_cast<size_t> (width) * static_cast<size_t> (height), 0),
+          m_magnitudes (m_counts.size(), 0.f),
+          m_pendingOrbits (static_cast<size_t> (numRegions)) {}
+
+    int getX() const noexcept       { return m_x; }
+    int getY() const noexcept       { return m_y; }
+    int getWidth() const noexcept   { return m_width; }
+    int getHeight() const noexcept  { return m_height; }
+
+    int* getCounts (const int y) noexcept                      { return m_counts.data() + index (0, y); }
+    const int* getCounts (const int y) const noexcept          { return m_counts.data() + index (0, y); }
+    float* getMagnitudes (const int y) noexcept                { return m_magnitudes.data() + index (0, y); }
+    const float* getMagnitudes (const int y) const noexcept    { return m_magnitudes.data() + index (0, y); }
+
+    const std::vector<int>& getAllCounts() const noexcept      { return m_counts; }
+
+    // What the counts, magnitudes and pending orbits take up
+    size_t getNumBytes() const noexcept
+    {
+        size_t numBytes = m_counts.size() * (sizeof (int) + sizeof (float));
+        for (const auto& orbits : m_pendingOrbits)
+            numBytes += orbits.size() * sizeof (PendingOrbit);
+        return numBytes;
+    }
+
+    // Each region's list must only be touched by one thread at a time
+    std::vector<PendingOrbit>& getPendingOrbits (const int region) noexcept
+    {
+        return m_pendingOrbits[static_cast<size_t> (region)];
+    }
+
+    const std::vector<PendingOrbit>& getPendingOrbits (const int region) const noexcept
+    {
+        return m_pendingOrbits[static_cast<size_t> (region)];
+    }
+
+    // Copies the sample at (x, y) over the rest of the w x h block it starts
+    void fillBlock (const int x, const int y, const int w, const int h) noexcept
+    {
+        fill (x, y, w, h, m_counts[index (x, y)], m_magnitudes[index (x, y)]);
+    }
+
+    void fill (const int x, const int y, const int w, const int h,
+               const int count, const float magnitude) noexcept
+    {
+        for (int blockY = y; blockY < y + h; blockY++)
+        {
+            for (int blockX = x; blockX < x + w; blockX++)
+            {
+                m_counts[index (blockX, blockY)] = count;
+                m_magnitudes[index (blockX, blockY)] = magnitude;
+            }
+        }
+    }
+
+private:
+    size_t index (const int x, const int y) const noexcept
+    {
+        return static_cast<size_t> (y - m_y) * static_cast<size_t> (m_width) + static_cast<size_t> (x - m_x);
+    }
+
+    int m_x, m_y;
+    int m_width, m_height;
+    std::vector<int> m_counts;
+    std::vector<float> m_magnitudes;
+    std::vector<std::vector<PendingOrbit>> m_pendingOrbits;
+};
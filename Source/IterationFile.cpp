@@ -0,0 +1,459 @@
+/*
+  ==============================================================================
+
+    IterationFile.cpp
+    Created: 23 Oct 2026 4:48:12pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "IterationFile.h"
+#include "Palette.h"
+#include "RenderStats.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+ #define WIN32_LEAN_AND_MEAN
+ #define NOMINMAX
+ #include <windows.h>
+#else
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <sys/stat.h>
+ #include <unistd.h>
+#endif
+
+static_assert (sizeof (std::atomic<uint8_t>) == 1 && std::atomic<uint8_t>::is_always_lock_free,
+               "tile marks are single bytes in the file");
+
+//==============================================================================
+static constexpr char magic[8] = { 'F', 'F', 'I', 'T', 'E', 'R', 'S', '\0' };
+static constexpr uint32_t formatVersion = 1;
+static constexpr uint64_t sectionAlignment = 4096;
+
+// The first sectionAlignment bytes of the file; fields never move within a version
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    int32_t width, height, tileSize;
+
+    int32_t type, formulaPower, formulaVariant, precision;
+    int32_t minIterations, maxIterations;
+
+    double cRe, cIm;
+    double centreX, centreY, centreXLow, centreYLow;
+    double pixelSize;
+
+    uint64_t tableOffset, countsOffset, magnitudesOffset, fileSize;
+
+    char centreXText[IterationFile::maxCentreTextLength + 1];
+    char centreYText[IterationFile::maxCentreTextLength + 1];
+};
+
+static_assert (sizeof (FileHeader) <= sectionAlignment, "the header has to fit before the tile table");
+
+static uint64_t alignSection (const uint64_t offset) noexcept {
+    return (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+}
+
+// Where each section goes for a frame of this size
+static void layOut (FileHeader& header) noexcept {
+    const auto tilesAcross = static_cast<uint64_t> ((header.width + header.tileSize - 1) / header.tileSize);
+    const auto tilesDown = static_cast<uint64_t> ((header.height + header.tileSize - 1) / header.tileSize);
+    const uint64_t numPixels = static_cast<uint64_t> (header.width) * static_cast<uint64_t> (header.height);
+
+    header.tableOffset = sectionAlignment;
+    header.countsOffset = alignSection (header.tableOffset + tilesAcross * tilesDown);
+    header.magnitudesOffset = alignSection (header.countsOffset + numPixels * sizeof (int32_t));
+    header.fileSize = alignSection (header.magnitudesOffset + numPixels * sizeof (float));
+}
+
+static std::string readText (const char* text) {
+    return std::string (text, strnlen (text, IterationFile::maxCentreTextLength));
+}
+
+//==============================================================================
+IterationFile::IterationFile (const std::string& path, const FractalParams& params,
+                              const std::string& centreXText, const std::string& centreYText) {
+    if (params.width <= 0 || params.height <= 0
+        || centreXText.size() > maxCentreTextLength || centreYText.size() > maxCentreTextLength)
+        return;
+
+    FileHeader header {};
+    std::memcpy (header.magic, magic, sizeof (magic));
+    header.version = formatVersion;
+    header.width = params.width;
+    header.height = params.height;
+    header.tileSize = tileSize;
+    header.type = static_cast<int32_t> (params.type);
+    header.formulaPower = params.formula.power;
+    header.formulaVariant = static_cast<int32_t> (params.formula.variant);
+    header.precision = static_cast<int32_t> (params.precision);
+    header.minIterations = params.minIterations;
+    header.maxIterations = params.maxIterations;
+    header.cRe = params.cRe;
+    header.cIm = params.cIm;
+    header.centreX = params.centreX;
+    header.centreY = params.centreY;
+    header.centreXLow = params.centreXLow;
+    header.centreYLow = params.centreYLow;
+    header.pixelSize = params.pixelSize;
+    std::memcpy (header.centreXText, centreXText.data(), centreXText.size());
+    std::memcpy (header.centreYText, centreYText.data(), centreYText.size());
+    layOut (header);
+
+    // A new file is all zeros, which is every tile still to do
+    if (! map (path, true, true, header.fileSize))
+    {
+        unmap();
+        return;
+    }
+
+    std::memcpy (m_data, &header, sizeof (header));
+    if (! readHeader())
+        unmap();
+}
+
+IterationFile::IterationFile (const std::string& path, const bool isWritable) {
+    if (! map (path, isWritable, false, 0) || ! readHeader())
+        unmap();
+}
+
+bool IterationFile::readHeader() {
+    if (m_size < sizeof (FileHeader))
+        return false;
+
+    FileHeader header;
+    std::memcpy (&header, m_data, sizeof (header));
+
+    if (std::memcmp (header.magic, magic, sizeof (magic)) != 0 || header.version != formatVersion
+        || header.width <= 0 || header.height <= 0 || header.tileSize != tileSize
+        || header.type < 0 || header.type > static_cast<int32_t> (FractalType::julia)
+        || header.formulaPower < Formula::minPower || header.formulaPower > Formula::maxPower
+        || header.formulaVariant < 0 || header.formulaVariant > static_cast<int32_t> (FormulaVariant::burningShip)
+        || header.precision < 0 || header.precision > static_cast<int32_t> (Precision::perturbation)
+        || header.minIterations < 0 || header.minIterations > header.maxIterations)
+        return false;
+
+    // A file cut short, or sections that aren't where this version puts them
+    auto expected = header;
+    layOut (expected);
+    if (header.tableOffset != expected.tableOffset || header.countsOffset != expected.countsOffset
+        || header.magnitudesOffset != expected.magnitudesOffset || header.fileSize != expected.fileSize
+        || header.fileSize > m_size)
+        return false;
+
+    m_params = {};
+    m_params.type = static_cast<FractalType> (header.type);
+    m_params.formula = { header.formulaPower, static_cast<FormulaVariant> (header.formulaVariant) };
+    m_params.precision = static_cast<Precision> (header.precision);
+    m_params.width = header.width;
+    m_params.height = header.height;
+    m_params.minIterations = header.minIterations;
+    m_params.maxIterations = header.maxIterations;
+    m_params.cRe = header.cRe;
+    m_params.cIm = header.cIm;
+    m_params.centreX = header.centreX;
+    m_params.centreY = header.centreY;
+    m_params.centreXLow = header.centreXLow;
+    m_params.centreYLow = header.centreYLow;
+    m_params.pixelSize = header.pixelSize;
+    m_centreXText = readText (header.centreXText);
+    m_centreYText = readText (header.centreYText);
+
+    m_tilesAcross = (header.width + tileSize - 1) / tileSize;
+    m_tilesDown = (header.height + tileSize - 1) / tileSize;
+    m_doneTiles = reinterpret_cast<std::atomic<uint8_t>*> (m_data + header.tableOffset);
+    m_counts = reinterpret_cast<int*> (m_data + header.countsOffset);
+    m_magnitudes = reinterpret_cast<float*> (m_data + header.magnitudesOffset);
+    return true;
+}
+
+bool IterationFile::matches (const FractalParams& params) const noexcept {
+    return isOpen() && params.type == m_params.type && params.formula == m_params.formula
+        && params.precision == m_params.precision
+        && params.width == m_params.width && params.height == m_params.height
+        && params.minIterations == m_params.minIterations && params.maxIterations == m_params.maxIterations
+        && params.cRe == m_params.cRe && params.cIm == m_params.cIm
+        && params.centreX == m_params.centreX && params.centreY == m_params.centreY
+        && params.centreXLow == m_params.centreXLow && params.centreYLow == m_params.centreYLow
+        && params.pixelSize == m_params.pixelSize;
+}
+
+//==============================================================================
+PixelArea IterationFile::getTileArea (const int tile) const noexcept {
+    const int x = (tile % m_tilesAcross) * tileSize;
+    const int y = (tile / m_tilesAcross) * tileSize;
+    return { x, y, std::min (tileSize, m_params.width - x), std::min (tileSize, m_params.height - y) };
+}
+
+int IterationFile::getTileAt (const int x, const int y) const noexcept {
+    return (y / tileSize) * m_tilesAcross + x / tileSize;
+}
+
+bool IterationFile::isTileDone (const int tile) const noexcept {
+    return m_doneTiles[tile].load (std::memory_order_acquire) != 0;
+}
+
+int IterationFile::getNumTilesDone() const noexcept {
+    int numDone = 0;
+    for (int tile = 0; tile < getNumTiles(); tile++)
+        numDone += isTileDone (tile) ? 1 : 0;
+    return numDone;
+}
+
+void IterationFile::markTileDone (const int tile) noexcept {
+    m_doneTiles[tile].store (1, std::memory_order_release);
+}
+
+bool IterationFile::hasValidCounts (const int tile) const noexcept {
+    const auto area = getTileArea (tile);
+    for (int ptY = area.y; ptY < area.getBottom(); ptY++)
+    {
+        const int* counts = getCounts (ptY) + area.x;
+        for (int i = 0; i < area.width; i++)
+            if (counts[i] != clampCount (counts[i]))
+                return false;
+    }
+    return true;
+}
+
+int IterationFile::unmarkDamagedTiles() noexcept {
+    if (! m_isWritable)
+        return 0;
+
+    int numDamaged = 0;
+    for (int tile = 0; tile < getNumTiles(); tile++)
+    {
+        if (isTileDone (tile) && ! hasValidCounts (tile))
+        {
+            m_doneTiles[tile].store (0, std::memory_order_release);
+            numDamaged++;
+        }
+    }
+    return numDamaged;
+}
+
+void IterationFile::colourRows (const Palette& palette, const int y, const int numRows, uint32_t* pixels) const noexcept {
+    for (int ptY = y; ptY < y + numRows; ptY++)
+    {
+        const int* counts = getCounts (ptY);
+        const float* magnitudes = getMagnitudes (ptY);
+
+        for (int tileX = 0; tileX < m_params.width; tileX += tileSize)
+        {
+            const int tileEnd = std::min (tileX + tileSize, m_params.width);
+
+            if (! isTileDone (getTileAt (tileX, ptY)))
+            {
+                std::fill (pixels + tileX, pixels + tileEnd, 0u);
+                continue;
+            }
+
+            for (int ptX = tileX; ptX < tileEnd; ptX++)
+                pixels[ptX] = palette.getColour (clampCount (counts[ptX]), magnitudes[ptX]);
+        }
+        pixels += m_params.width;
+    }
+}
+
+//==============================================================================
+#if defined(_WIN32)
+
+bool IterationFile::map (const std::string& path, const bool isWritable, const bool isNew, const uint64_t fileSize) {
+    const DWORD access = isWritable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ;
+    const HANDLE file = CreateFileA (path.c_str(), access, FILE_SHARE_READ, nullptr,
+                                     isNew ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+    m_fileHandle = file;
+
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG> (fileSize);
+    if (isNew && ! (SetFilePointerEx (file, size, nullptr, FILE_BEGIN) && SetEndOfFile (file)))
+        return false;
+    if (! GetFileSizeEx (file, &size) || size.QuadPart <= 0)
+        return false;
+
+    m_mapping = CreateFileMappingA (file, nullptr, isWritable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping == nullptr)
+        return false;
+
+    m_data = static_cast<uint8_t*> (MapViewOfFile (m_mapping, isWritable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+    m_size = static_cast<uint64_t> (size.QuadPart);
+    m_isWritable = isWritable;
+    return m_data != nullptr;
+}
+
+void IterationFile::unmap() noexcept {
+    if (m_data != nullptr)
+        UnmapViewOfFile (m_data);
+    if (m_mapping != nullptr)
+        CloseHandle (m_mapping);
+    if (m_fileHandle != nullptr)
+        CloseHandle (m_fileHandle);
+
+    m_data = nullptr;
+    m_mapping = m_fileHandle = nullptr;
+}
+
+bool IterationFile::flush() noexcept {
+    if (! isOpen() || ! m_isWritable)
+        return isOpen();
+    return FlushViewOfFile (m_data, 0) && FlushFileBuffers (m_fileHandle);
+}
+
+#else
+
+bool IterationFile::map (const std::string& path, const bool isWritable, const bool isNew, const uint64_t fileSize) {
+    const int flags = isWritable ? O_RDWR | (isNew ? O_CREAT | O_TRUNC : 0) : O_RDONLY;
+    m_fileDescriptor = ::open (path.c_str(), flags, 0644);
+    if (m_fileDescriptor < 0)
+        return false;
+
+    // Growing the file leaves a hole, so pixels take no disk space until they're rendered
+    if (isNew && ::ftruncate (m_fileDescriptor, static_cast<off_t> (fileSize)) != 0)
+        return false;
+
+    struct stat info;
+    if (::fstat (m_fileDescriptor, &info) != 0 || info.st_size <= 0)
+        return false;
+
+    const auto size = static_cast<uint64_t> (info.st_size);
+    void* data = ::mmap (nullptr, static_cast<size_t> (size), isWritable ? PROT_READ | PROT_WRITE : PROT_READ,
+                         MAP_SHARED, m_fileDescriptor, 0);
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<uint8_t*> (data);
+    m_size = size;
+    m_isWritable = isWritable;
+    return true;
+}
+
+void IterationFile::unmap() noexcept {
+    if (m_data != nullptr)
+        ::munmap (m_data, static_cast<size_t> (m_size));
+    if (m_fileDescriptor >= 0)
+        ::close (m_fileDescriptor);
+
+    m_data = nullptr;
+    m_fileDescriptor = -1;
+}
+
+bool IterationFile::flush() noexcept {
+    if (! isOpen() || ! m_isWritable)
+        return isOpen();
+    return ::msync (m_data, static_cast<size_t> (m_size), MS_SYNC) == 0;
+}
+
+#endif
+
+IterationFile::~IterationFile() {
+    unmap();
+}
+
+//==============================================================================
+static constexpr auto checkpointInterval = std::chrono::seconds (5);
+
+bool renderToFile (IterationFile& file, const FractalParams& params, const FrameOptions& options,
+                   const std::function<bool (int numTilesDone)>& onCheckpoint) {
+    std::vector<int> tiles;
+    for (int tile = 0; tile < file.getNumTiles(); tile++)
+        if (! file.isTileDone (tile))
+            tiles.push_back (tile);
+
+    const int numTiles = static_cast<int> (tiles.size());
+    const int numAlreadyDone = file.getNumTiles() - numTiles;
+
+    std::atomic<int> nextTile {0};
+    std::atomic<int> numFinished {0};
+    std::atomic<bool> shouldStop {false};
+    std::mutex lock;
+    std::condition_variable finished;
+
+    auto renderTiles = [&]
+    {
+        for (int index = nextTile++; index < numTiles && ! shouldStop; index = nextTile++)
+        {
+            const int tile = tiles[static_cast<size_t> (index)];
+            const auto area = file.getTileArea (tile);
+            const auto started = RenderStats::Clock::now();
+
+            int64_t numIterations = 0;
+            for (int ptY = area.y; ptY < area.getBottom(); ptY++)
+            {
+                int* counts = file.getCounts (ptY) + area.x;
+                calcIterationsRow (params, ptY, area.x, area.width,
+                                   { counts, file.getMagnitudes (ptY) + area.x }, 1, options.simdLevel);
+
+                for (int i = 0; i < area.width; i++)
+                    numIterations += std::min (counts[i], params.maxIterations);
+            }
+
+            file.markTileDone (tile);
+
+            if (options.stats != nullptr)
+            {
+                options.stats->addEvent (options.statsFrame, RenderStage::iterate, tile, started, RenderStats::Clock::now());
+                options.stats->addTile (options.statsFrame, tile, static_cast<int64_t> (area.width) * area.height,
+                                        numIterations);
+            }
+
+            {
+                const std::lock_guard<std::mutex> guard (lock);
+                numFinished++;
+            }
+            finished.notify_one();
+        }
+    };
+
+    int numThreads = options.numThreads > 0 ? options.numThreads
+                                            : static_cast<int> (std::thread::hardware_concurrency());
+    numThreads = std::clamp (numThreads, 1, std::max (numTiles, 1));
+
+    // The workers take every tile, leaving the calling thread free to checkpoint
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; i++)
+        threads.emplace_back (renderTiles);
+
+    bool isFlushed = true;
+    auto lastCheckpoint = std::chrono::steady_clock::now();
+
+    for (;;)
+    {
+        std::unique_lock<std::mutex> guard (lock);
+        const bool isDone = finished.wait_until (guard, lastCheckpoint + checkpointInterval,
+                                                 [&] { return numFinished == numTiles; });
+        guard.unlock();
+
+        if (isDone)
+            break;
+
+        lastCheckpoint = std::chrono::steady_clock::now();
+        isFlushed = file.flush() && isFlushed;
+
+        if (onCheckpoint && ! onCheckpoint (numAlreadyDone + numFinished))
+        {
+            shouldStop = true;
+            break;
+        }
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+
+    isFlushed = file.flush() && isFlushed;
+    if (onCheckpoint)
+        onCheckpoint (numAlreadyDone + numFinished);
+
+    return isFlushed && numFinished == numTiles;
+}
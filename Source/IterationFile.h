@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    IterationFile.h
+    Created: 23 Oct 2026 4:48:12pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "EscapeTime.h"
+#include "FrameRenderer.h"
+#include "Symmetry.h"
+
+class Palette;
+
+//==============================================================================
+/*
+    The iteration counts and final |z| of a frame, kept in a file that is
+    memory mapped rather than read. A render writes its tiles straight into
+    the mapping and marks each one done as it finishes, so a render that
+    dies can carry on from where it got to, and a finished frame of any size
+    can be recoloured or viewed without ever being loaded whole.
+
+    The file, all integers little-endian:
+
+        offset          size            contents
+        0               4096            header, see below
+        tableOffset     numTiles        one byte per tile, 1 once it is done
+        countsOffset    4 * w * h       int32 loop counts, row by row
+        magnitudesOffset 4 * w * h      float32 |z| where each loop stopped
+
+    Each section starts on a 4096 byte boundary. Tiles are tileSize pixels
+    square, numbered across then down, the last ones in a row or column cut
+    short by the edge of the frame. Counts mean what they do in an
+    IterationBuffer: maxIterations + 1 for points that never escaped, and 0
+    for pixels of tiles that aren't done yet.
+
+    The header holds the magic "FFITERS", the format version (1), the frame's
+    size and tile size, its FractalParams apart from the reference orbit, the
+    offsets above and the size of the whole file, then the centre as the
+    decimal text it was given, so a deep view can be made again exactly.
+
+    A tile's mark is set after its pixels, and both live in the page cache
+    the moment they're written, so a process that is killed loses nothing.
+    flush() pushes them to the disk; only a crash of the whole machine can
+    lose what came after the last flush.
+*/
+class IterationFile
+{
+public:
+    // Creates a file for the frame with no tiles done, replacing any that was there; check isOpen()
+    IterationFile (const std::string& path, const FractalParams& params,
+                   const std::string& centreXText, const std::string& centreYText);
+
+    // Maps an existing file, for writing only if the tiles are to be rendered; check isOpen()
+    IterationFile (const std::string& path, const bool isWritable);
+
+    ~IterationFile();
+
+    bool isOpen() const noexcept    { return m_data != nullptr; }
+
+    // Everything but the reference orbit, which perturbation renders have to make again
+    const FractalParams& getParams() const noexcept    { return m_params; }
+    const std::string& getCentreXText() const noexcept { return m_centreXText; }
+    const std::string& getCentreYText() const noexcept { return m_centreYText; }
+
+    // Whether the file holds the view params describes, to the last bit
+    bool matches (const FractalParams& params) const noexcept;
+
+    int getWidth() const noexcept   { return m_params.width; }
+    int getHeight() const noexcept  { return m_params.height; }
+
+    int* getCounts (const int y) noexcept                   { return m_counts + rowStart (y); }
+    const int* getCounts (const int y) const noexcept       { return m_counts + rowStart (y); }
+    float* getMagnitudes (const int y) noexcept             { return m_magnitudes + rowStart (y); }
+    const float* getMagnitudes (const int y) const noexcept { return m_magnitudes + rowStart (y); }
+
+    // Every count, row after row
+    const int* getAllCounts() const noexcept                { return m_counts; }
+
+    int getTilesAcross() const noexcept     { return m_tilesAcross; }
+    int getNumTiles() const noexcept        { return m_tilesAcross * m_tilesDown; }
+    PixelArea getTileArea (const int tile) const noexcept;
+    int getTileAt (const int x, const int y) const noexcept;
+
+    bool isTileDone (const int tile) const noexcept;
+    int getNumTilesDone() const noexcept;
+    bool isComplete() const noexcept    { return getNumTilesDone() == getNumTiles(); }
+
+    // Called once the tile's pixels are all written
+    void markTileDone (const int tile) noexcept;
+
+    /*  Unmarks every done tile holding a count a render couldn't have left,
+        as a damaged file's might, so renderToFile() does it again. Returns
+        how many there were; the file has to be writable.
+    */
+    int unmarkDamagedTiles() noexcept;
+
+    // A count from the file brought into [minIterations, maxIterations + 1], so it can't index past a Palette
+    int clampCount (const int count) const noexcept
+    {
+        return std::clamp (count, m_params.minIterations, m_params.maxIterations + 1);
+    }
+
+    /*  Colours numRows rows from y into 0xAARRGGBB pixels, leaving the
+        pixels of tiles that aren't done transparent black. Counts out of
+        range are clamped, so a damaged file colours wrongly but safely.
+    */
+    void colourRows (const Palette& palette, const int y, const int numRows, uint32_t* pixels) const noexcept;
+
+    // Writes everything changed so far to the disk; returns false if that failed
+    bool flush() noexcept;
+
+    static constexpr int tileSize = FrameOptions::tileSize;
+    static constexpr size_t maxCentreTextLength = 1023;
+
+private:
+    bool map (const std::string& path, const bool isWritable, const bool isNew, const uint64_t fileSize);
+    void unmap() noexcept;
+    bool readHeader();
+    bool hasValidCounts (const int tile) const noexcept;
+
+    size_t rowStart (const int y) const noexcept
+    {
+        return static_cast<size_t> (y) * static_cast<size_t> (m_params.width);
+    }
+
+    FractalParams m_params;
+    std::string m_centreXText, m_centreYText;
+    int m_tilesAcross { 0 }, m_tilesDown { 0 };
+
+    uint8_t* m_data { nullptr };
+    uint64_t m_size { 0 };
+    bool m_isWritable { false };
+    std::atomic<uint8_t>* m_doneTiles { nullptr };
+    int* m_counts { nullptr };
+    float* m_magnitudes { nullptr };
+
+   #if defined(_WIN32)
+    void* m_fileHandle { nullptr };
+    void* m_mapping { nullptr };
+   #else
+    int m_fileDescriptor { -1 };
+   #endif
+};
+
+/*  Iterates every tile of the file that isn't done yet on plain std::threads,
+    like renderFrame() but without subdivision or mirroring, as each tile has
+    to be finished on its own. params must be the file's, with a reference
+    orbit if it is a perturbation render. Tiles already done are kept as
+    they are, so call unmarkDamagedTiles() first on a file being resumed.
+
+    Every few seconds, and once at the end, the file is flushed and
+    onCheckpoint, if any, is called on the calling thread with the number
+    of tiles done; returning false stops the render once the tiles in
+    progress finish. Returns
+    whether every tile is done and on the disk.
+*/
+bool renderToFile (IterationFile& file, const FractalParams& params, const FrameOptions& options = {},
+                   const std::function<bool (int numTilesDone)>& onCheckpoint = {});
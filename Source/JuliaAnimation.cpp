@@ -0,0 +1,255 @@
+/*
+  ==============================================================================
+
+    JuliaAnimation.cpp
+    Created: 25 Oct 2026 10:05:51am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "JuliaAnimation.h"
+#include "FrameRenderer.h"
+#include "IterationBuffer.h"
+#include "PngWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//==============================================================================
+// Splits "frame-%05d.png" into "frame-", 5 and ".png"
+static bool splitSequencePath (const std::string& output, std::string& prefix, int& numDigits, std::string& suffix) {
+    const auto percent = output.find ('%');
+    if (percent == std::string::npos || output.find ('%', percent + 1) != std::string::npos)
+        return false;
+
+    auto end = percent + 1;
+    while (end < output.size() && output[end] >= '0' && output[end] <= '9')
+        end++;
+    if (end >= output.size() || output[end] != 'd' || end - percent - 1 > 2)
+        return false;
+
+    prefix = output.substr (0, percent);
+    numDigits = end > percent + 1 ? std::stoi (output.substr (percent + 1, end - percent - 1)) : 0;
+    suffix = output.substr (end + 1);
+    return true;
+}
+
+bool isImageSequencePath (const std::string& output) {
+    std::string prefix, suffix;
+    int numDigits = 0;
+    return splitSequencePath (output, prefix, numDigits, suffix);
+}
+
+//==============================================================================
+/*  Y4M is a one line header and then each frame as "FRAME" and its raw
+    planes. The frames are 4:2:0 in limited range BT.601, which every
+    player and encoder takes, each chroma sample the average of the 2 x 2
+    pixels it covers. C420jpeg only names that centred chroma siting, so
+    the range is stated separately with XCOLORRANGE.
+*/
+static std::string makeY4mHeader (const int width, const int height, const int framesPerSecond) {
+    return "YUV4MPEG2 W" + std::to_string (width) + " H" + std::to_string (height)
+         + " F" + std::to_string (framesPerSecond) + ":1 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n";
+}
+
+static std::vector<uint8_t> encodeY4mFrame (const int width, const int height, const uint32_t* pixels) {
+    static const char frameTag[] = "FRAME\n";
+    const int chromaWidth = (width + 1) / 2, chromaHeight = (height + 1) / 2;
+    const size_t lumaSize = static_cast<size_t> (width) * static_cast<size_t> (height);
+    const size_t chromaSize = static_cast<size_t> (chromaWidth) * static_cast<size_t> (chromaHeight);
+
+    std::vector<uint8_t> bytes (sizeof (frameTag) - 1 + lumaSize + 2 * chromaSize);
+    std::copy (frameTag, frameTag + sizeof (frameTag) - 1, bytes.begin());
+    uint8_t* luma = bytes.data() + sizeof (frameTag) - 1;
+    uint8_t* blueDifference = luma + lumaSize;
+    uint8_t* redDifference = blueDifference + chromaSize;
+
+    for (size_t pixel = 0; pixel < lumaSize; pixel++)
+    {
+        const int red = (pixels[pixel] >> 16) & 0xff, green = (pixels[pixel] >> 8) & 0xff, blue = pixels[pixel] & 0xff;
+        luma[pixel] = static_cast<uint8_t> (((66 * red + 129 * green + 25 * blue + 128) >> 8) + 16);
+    }
+
+    for (int chromaY = 0; chromaY < chromaHeight; chromaY++)
+    {
+        for (int chromaX = 0; chromaX < chromaWidth; chromaX++)
+        {
+            int red = 0, green = 0, blue = 0, numPixels = 0;
+            for (int ptY = 2 * chromaY; ptY < std::min (2 * chromaY + 2, height); ptY++)
+            {
+                for (int ptX = 2 * chromaX; ptX < std::min (2 * chromaX + 2, width); ptX++)
+                {
+                    const uint32_t colour = pixels[static_cast<size_t> (ptY) * static_cast<size_t> (width) + static_cast<size_t> (ptX)];
+                    red += (colour >> 16) & 0xff;
+                    green += (colour >> 8) & 0xff;
+                    blue += colour & 0xff;
+                    numPixels++;
+                }
+            }
+            red /= numPixels;
+            green /= numPixels;
+            blue /= numPixels;
+
+            // The arithmetic shifts round towards minus infinity, as the usual integer formulas expect
+            const auto sample = static_cast<size_t> (chromaY) * static_cast<size_t> (chromaWidth) + static_cast<size_t> (chromaX);
+            blueDifference[sample] = static_cast<uint8_t> (((-38 * red - 74 * green + 112 * blue + 128) >> 8) + 128);
+            redDifference[sample] = static_cast<uint8_t> (((112 * red - 94 * green - 18 * blue + 128) >> 8) + 128);
+        }
+    }
+    return bytes;
+}
+
+static bool writeBytes (std::FILE* file, const std::vector<uint8_t>& bytes) {
+    return std::fwrite (bytes.data(), 1, bytes.size(), file) == bytes.size();
+}
+
+//==============================================================================
+bool renderJuliaAnimation (const FractalParams& frame, const Palette& palette, const JuliaPath& path,
+                           const std::string& output, const AnimationOptions& options) {
+    const int numFrames = static_cast<int> (path.size());
+    if (frame.width <= 0 || frame.height <= 0 || numFrames == 0)
+        return false;
+
+    std::string prefix, suffix;
+    int numDigits = 0;
+    const bool isSequence = splitSequencePath (output, prefix, numDigits, suffix);
+    const bool isStdout = ! isSequence && output == "-";
+
+    std::FILE* video = nullptr;
+    if (! isSequence)
+    {
+        video = isStdout ? stdout : std::fopen (output.c_str(), "wb");
+        const auto header = makeY4mHeader (frame.width, frame.height, std::max (1, options.framesPerSecond));
+        if (video == nullptr || std::fwrite (header.data(), 1, header.size(), video) != header.size())
+        {
+            if (video != nullptr && ! isStdout)
+                std::fclose (video);
+            return false;
+        }
+    }
+
+    int numThreads = options.numThreads > 0 ? options.numThreads
+                                            : static_cast<int> (std::thread::hardware_concurrency());
+    numThreads = std::clamp (numThreads, 1, numFrames);
+
+    // Enough that a slow frame doesn't leave the other threads idle
+    const int maxFramesAhead = 2 * numThreads + 2;
+
+    // Encoded frames wait in a ring indexed by frame % maxFramesAhead
+    std::mutex lock;
+    std::condition_variable changed;
+    std::vector<std::vector<uint8_t>> encoded (static_cast<size_t> (maxFramesAhead));
+    std::vector<bool> isReady (static_cast<size_t> (maxFramesAhead), false);
+    int nextFrame = 0, numWritten = 0;
+    std::atomic<bool> shouldStop { false };
+
+    auto renderFrames = [&]
+    {
+        FrameOptions frameOptions;
+        frameOptions.numThreads = 1;
+        frameOptions.subdivide = options.subdivide;
+        frameOptions.keepMagnitudes = palette.usesMagnitude();
+        frameOptions.simdLevel = options.simdLevel;
+
+        IterationBuffer iterations (frame.width, frame.height);
+        std::vector<uint32_t> pixels (static_cast<size_t> (frame.width) * static_cast<size_t> (frame.height));
+
+        // Only histogram colouring changes from frame to frame
+        Palette framePalette = palette;
+        framePalette.build (frame.minIterations, frame.maxIterations);
+
+        for (;;)
+        {
+            int index = 0;
+            {
+                std::unique_lock<std::mutex> held (lock);
+                changed.wait (held, [&] { return shouldStop || nextFrame >= numFrames
+                                                 || nextFrame < numWritten + maxFramesAhead; });
+                if (shouldStop || nextFrame >= numFrames)
+                    return;
+                index = nextFrame++;
+            }
+
+            auto params = frame;
+            params.type = FractalType::julia;
+            params.cRe = path[static_cast<size_t> (index)].real();
+            params.cIm = path[static_cast<size_t> (index)].imag();
+
+            renderFrame (params, iterations, frameOptions);
+
+            if (framePalette.needsWholeFrame())
+                framePalette.build (frame.minIterations, frame.maxIterations, &iterations);
+            framePalette.colourFrame (iterations, pixels.data());
+
+            auto bytes = isSequence ? encodePng (frame.width, frame.height, pixels.data())
+                                    : encodeY4mFrame (frame.width, frame.height, pixels.data());
+            {
+                const std::lock_guard<std::mutex> held (lock);
+                encoded[static_cast<size_t> (index % maxFramesAhead)] = std::move (bytes);
+                isReady[static_cast<size_t> (index % maxFramesAhead)] = true;
+            }
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; i++)
+        threads.emplace_back (renderFrames);
+
+    // This thread only writes, in order, as the frames come in
+    bool isComplete = true;
+
+    for (int index = 0; index < numFrames && isComplete; index++)
+    {
+        const auto slot = static_cast<size_t> (index % maxFramesAhead);
+        std::vector<uint8_t> bytes;
+        {
+            std::unique_lock<std::mutex> held (lock);
+            changed.wait (held, [&] { return isReady[slot]; });
+            bytes = std::move (encoded[slot]);
+            isReady[slot] = false;
+            numWritten = index + 1;
+        }
+        changed.notify_all();
+
+        if (isSequence)
+        {
+            auto number = std::to_string (index);
+            if (static_cast<int> (number.size()) < numDigits)
+                number.insert (0, static_cast<size_t> (numDigits) - number.size(), '0');
+
+            const auto framePath = prefix + number + suffix;
+            std::FILE* file = std::fopen (framePath.c_str(), "wb");
+            isComplete = file != nullptr && writeBytes (file, bytes);
+            isComplete = (file == nullptr || std::fclose (file) == 0) && isComplete;
+        }
+        else
+        {
+            isComplete = writeBytes (video, bytes);
+        }
+
+        isComplete = isComplete && (options.onProgress == nullptr || options.onProgress (index + 1));
+    }
+
+    {
+        const std::lock_guard<std::mutex> held (lock);
+        shouldStop = true;
+    }
+    changed.notify_all();
+
+    for (auto& thread : threads)
+        thread.join();
+
+    if (video != nullptr)
+    {
+        isComplete = (isStdout ? std::fflush (video) : std::fclose (video)) == 0 && isComplete;
+        if (! isComplete && ! isStdout)
+            std::remove (output.c_str());
+    }
+    return isComplete;
+}
@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+
+    JuliaAnimation.h
+    Created: 25 Oct 2026 10:05:51am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include "EscapeTime.h"
+#include "JuliaPath.h"
+#include "Palette.h"
+
+//==============================================================================
+/*
+    Renders a Julia set for every constant of a path as the frames of an
+    animation, written to a Y4M video or a numbered sequence of PNGs.
+
+    The frames go through a pipeline. Worker threads each take the next
+    frame, iterate it, colour it and encode it, while the calling thread
+    only writes finished frames out in order. Whole frames go to one thread
+    each, which keeps every core busy without the tiles of one frame waiting
+    on each other. Workers run at most two frames per thread past the one
+    being written, so the memory stays the same however long the path is.
+
+    Histogram colouring equalizes each frame over its own counts, which can
+    make the colours flicker from one frame to the next.
+*/
+struct AnimationOptions
+{
+    // 0 means one thread per hardware thread
+    int numThreads { 0 };
+
+    // Only stored in a Y4M file, for the player
+    int framesPerSecond { 30 };
+
+    // Mariani-Silver subdivision instead of iterating every pixel
+    bool subdivide { false };
+
+    SimdLevel simdLevel { getSimdLevel() };
+
+    // Called on the calling thread as frames are written; returning false stops the render
+    std::function<bool (int framesWritten)> onProgress;
+};
+
+/*  Whether output is taken as a sequence of PNGs: a path with a single
+    %d, optionally zero padded like %05d, which is given the frame number.
+    Anything else is written as one Y4M file, and "-" as Y4M on stdout.
+*/
+bool isImageSequencePath (const std::string& output);
+
+/*  The frame's size, view, formula and limits are used for every frame, with
+    the constant taken from the path. Returns false if anything couldn't be
+    written or onProgress stopped the render; a partial Y4M file is removed,
+    while the PNGs already written are kept.
+*/
+bool renderJuliaAnimation (const FractalParams& frame, const Palette& palette, const JuliaPath& path,
+                           const std::string& output, const AnimationOptions& options = {});
@@ -0,0 +1,259 @@
+/*
+  ==============================================================================
+
+    JuliaAtlas.cpp
+    Created: 24 Oct 2026 10:17:52am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "JuliaAtlas.h"
+#include "Palette.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+//==============================================================================
+bool JuliaAtlas::Layout::operator== (const Layout& other) const noexcept {
+    return cRe == other.cRe && cIm == other.cIm && cStep == other.cStep
+        && columns == other.columns && rows == other.rows && formula == other.formula
+        && width == other.width && height == other.height && pixelSize == other.pixelSize
+        && minIterations == other.minIterations && maxIterations == other.maxIterations;
+}
+
+// The fields as the file stores them, with no padding in between
+struct LayoutFields
+{
+    double cRe, cIm, cStep, pixelSize;
+    int32_t columns, rows, width, height;
+    int32_t formulaPower, formulaVariant, minIterations, maxIterations;
+};
+
+static LayoutFields toFields (const JuliaAtlas::Layout& layout) noexcept {
+    return { layout.cRe, layout.cIm, layout.cStep, layout.pixelSize,
+             layout.columns, layout.rows, layout.width, layout.height,
+             layout.formula.power, static_cast<int32_t> (layout.formula.variant),
+             layout.minIterations, layout.maxIterations };
+}
+
+uint64_t JuliaAtlas::Layout::getHash() const noexcept {
+    const auto fields = toFields (*this);
+    uint8_t bytes[sizeof (fields)];
+    std::memcpy (bytes, &fields, sizeof (fields));
+
+    // FNV-1a, which std::hash doesn't promise to be from one run to the next
+    uint64_t hash = 14695981039346656037ull;
+    for (const uint8_t byte : bytes)
+        hash = (hash ^ byte) * 1099511628211ull;
+    return hash;
+}
+
+JuliaAtlas::Layout JuliaAtlas::makeLayout (const double cRe, const double cIm, const double cWidth,
+                                           const double cHeight, const FractalParams& frame) {
+    Layout layout;
+    layout.cStep = std::max (cWidth, cHeight) / (gridSize - 1);
+    layout.columns = std::clamp (static_cast<int> (std::ceil (cWidth / layout.cStep)) + 1, 2, gridSize);
+    layout.rows = std::clamp (static_cast<int> (std::ceil (cHeight / layout.cStep)) + 1, 2, gridSize);
+    layout.cRe = cRe;
+    layout.cIm = cIm;
+
+    const double scale = thumbnailSize / static_cast<double> (std::max (frame.width, frame.height));
+    layout.width = std::max (1, static_cast<int> (std::lround (frame.width * scale)));
+    layout.height = std::max (1, static_cast<int> (std::lround (frame.height * scale)));
+    layout.pixelSize = frame.pixelSize * frame.width / layout.width;
+
+    layout.formula = frame.formula;
+    layout.maxIterations = std::min (frame.maxIterations, maxIterationLimit);
+    layout.minIterations = std::min (frame.minIterations, layout.maxIterations);
+    return layout;
+}
+
+//==============================================================================
+JuliaAtlas::JuliaAtlas (const Layout& layout)
+    : m_layout (layout),
+      m_counts (static_cast<size_t> (layout.getNumEntries()) * static_cast<size_t> (layout.width * layout.height), 0),
+      m_isDone (std::make_unique<std::atomic<bool>[]> (static_cast<size_t> (layout.getNumEntries()))) {
+    for (int entry = 0; entry < layout.getNumEntries(); entry++)
+        m_isDone[entry] = false;
+}
+
+const uint16_t* JuliaAtlas::getCounts (const int entry) const noexcept {
+    return m_counts.data() + static_cast<size_t> (entry) * static_cast<size_t> (m_layout.width * m_layout.height);
+}
+
+void JuliaAtlas::buildEntry (const int entry) {
+    FractalParams params;
+    params.type = FractalType::julia;
+    params.formula = m_layout.formula;
+    params.cRe = m_layout.cRe + (entry % m_layout.columns) * m_layout.cStep;
+    params.cIm = m_layout.cIm + (entry / m_layout.columns) * m_layout.cStep;
+    params.width = m_layout.width;
+    params.height = m_layout.height;
+    params.pixelSize = m_layout.pixelSize;
+    params.minIterations = m_layout.minIterations;
+    params.maxIterations = m_layout.maxIterations;
+    // Neighbouring constants can be closer than floats can tell apart
+    params.precision = Precision::float64;
+
+    std::vector<int> row (static_cast<size_t> (params.width));
+    auto* counts = const_cast<uint16_t*> (getCounts (entry));
+
+    // maxIterationLimit + 1 fits in 16 bits, so nothing is clipped
+    for (int ptY = 0; ptY < params.height; ptY++)
+    {
+        calcIterationsRow (params, ptY, 0, params.width, { row.data() });
+        for (int ptX = 0; ptX < params.width; ptX++)
+            *counts++ = static_cast<uint16_t> (row[static_cast<size_t> (ptX)]);
+    }
+
+    m_isDone[entry].store (true, std::memory_order_release);
+}
+
+bool JuliaAtlas::build (const int numThreads, const std::atomic<bool>& shouldStop) {
+    std::atomic<int> nextEntry {0};
+    const int numEntries = m_layout.getNumEntries();
+
+    auto buildEntries = [&]
+    {
+        for (int entry = nextEntry++; entry < numEntries && ! shouldStop; entry = nextEntry++)
+            if (! m_isDone[entry].load (std::memory_order_acquire))
+                buildEntry (entry);
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 1; i < std::clamp (numThreads, 1, numEntries); i++)
+        threads.emplace_back (buildEntries);
+
+    buildEntries();
+
+    for (auto& thread : threads)
+        thread.join();
+
+    return isComplete();
+}
+
+int JuliaAtlas::getNumEntriesDone() const noexcept {
+    int numDone = 0;
+    for (int entry = 0; entry < m_layout.getNumEntries(); entry++)
+        numDone += m_isDone[entry].load (std::memory_order_acquire) ? 1 : 0;
+    return numDone;
+}
+
+//==============================================================================
+bool JuliaAtlas::getPreview (const double cRe, const double cIm, const Palette& palette,
+                             uint32_t* pixels, const int lineStride) const {
+    const double gridX = (cRe - m_layout.cRe) / m_layout.cStep;
+    const double gridY = (cIm - m_layout.cIm) / m_layout.cStep;
+    if (! (gridX >= 0.0 && gridY >= 0.0 && gridX <= m_layout.columns - 1 && gridY <= m_layout.rows - 1))
+        return false;
+
+    // Bilinear weights of the four entries around c, leaving out any not done yet
+    const int column = std::min (static_cast<int> (gridX), m_layout.columns - 2);
+    const int row = std::min (static_cast<int> (gridY), m_layout.rows - 2);
+    const double fractionX = gridX - column;
+    const double fractionY = gridY - row;
+
+    const uint16_t* sources[4];
+    double rawWeights[4];
+    int numSources = 0;
+    double totalWeight = 0.0;
+
+    for (int corner = 0; corner < 4; corner++)
+    {
+        const int dx = corner & 1, dy = corner >> 1;
+        const int entry = (row + dy) * m_layout.columns + column + dx;
+        const double weight = (dx != 0 ? fractionX : 1.0 - fractionX) * (dy != 0 ? fractionY : 1.0 - fractionY);
+
+        if (weight > 0.0 && m_isDone[entry].load (std::memory_order_acquire))
+        {
+            sources[numSources] = getCounts (entry);
+            rawWeights[numSources++] = weight;
+            totalWeight += weight;
+        }
+    }
+
+    if (numSources == 0)
+        return false;
+
+    // 8.8 fixed point weights, rounded down so the last can make them add up to exactly 256
+    uint32_t weights[4];
+    uint32_t assigned = 0;
+    for (int i = 0; i < numSources; i++)
+    {
+        weights[i] = i + 1 < numSources ? static_cast<uint32_t> (256.0 * rawWeights[i] / totalWeight) : 256 - assigned;
+        assigned += weights[i];
+    }
+
+    for (int ptY = 0; ptY < m_layout.height; ptY++)
+    {
+        const int rowStart = ptY * m_layout.width;
+        uint32_t* line = pixels + static_cast<size_t> (ptY) * static_cast<size_t> (lineStride);
+
+        for (int ptX = 0; ptX < m_layout.width; ptX++)
+        {
+            uint32_t red = 0, green = 0, blue = 0;
+            for (int i = 0; i < numSources; i++)
+            {
+                const uint32_t colour = palette.getColour (sources[i][rowStart + ptX]);
+                red += ((colour >> 16) & 0xff) * weights[i];
+                green += ((colour >> 8) & 0xff) * weights[i];
+                blue += (colour & 0xff) * weights[i];
+            }
+            line[ptX] = 0xff000000u | ((red >> 8) << 16) | ((green >> 8) << 8) | (blue >> 8);
+        }
+    }
+    return true;
+}
+
+//==============================================================================
+static constexpr char magic[8] = { 'F', 'F', 'A', 'T', 'L', 'A', 'S', '\0' };
+static constexpr uint32_t formatVersion = 1;
+
+/*  The file: the magic, the version, the layout's fields, then every
+    entry's counts in order, all little-endian.
+*/
+bool JuliaAtlas::save (const std::string& path) const {
+    if (! isComplete())
+        return false;
+
+    std::FILE* file = std::fopen (path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    const auto fields = toFields (m_layout);
+    bool isWritten = std::fwrite (magic, sizeof (magic), 1, file) == 1
+                  && std::fwrite (&formatVersion, sizeof (formatVersion), 1, file) == 1
+                  && std::fwrite (&fields, sizeof (fields), 1, file) == 1
+                  && std::fwrite (m_counts.data(), sizeof (uint16_t), m_counts.size(), file) == m_counts.size();
+    isWritten = std::fclose (file) == 0 && isWritten;
+
+    if (! isWritten)
+        std::remove (path.c_str());
+    return isWritten;
+}
+
+bool JuliaAtlas::load (const std::string& path) {
+    std::FILE* file = std::fopen (path.c_str(), "rb");
+    if (file == nullptr)
+        return false;
+
+    char fileMagic[sizeof (magic)];
+    uint32_t version = 0;
+    LayoutFields fields;
+    const auto expected = toFields (m_layout);
+
+    bool isRead = std::fread (fileMagic, sizeof (fileMagic), 1, file) == 1
+               && std::memcmp (fileMagic, magic, sizeof (magic)) == 0
+               && std::fread (&version, sizeof (version), 1, file) == 1 && version == formatVersion
+               && std::fread (&fields, sizeof (fields), 1, file) == 1
+               && std::memcmp (&fields, &expected, sizeof (fields)) == 0
+               && std::fread (m_counts.data(), sizeof (uint16_t), m_counts.size(), file) == m_counts.size();
+    std::fclose (file);
+
+    for (int entry = 0; entry < m_layout.getNumEntries(); entry++)
+        m_isDone[entry].store (isRead, std::memory_order_release);
+    return isRead;
+}
@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    JuliaAtlas.h
+    Created: 24 Oct 2026 10:17:52am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "EscapeTime.h"
+
+class Palette;
+
+//==============================================================================
+/*
+    Small Julia renders for a grid of constants, so a drag through parameter
+    space can show something for every c at once: the entries around it,
+    blended by how close each one is, while the real render catches up.
+
+    Entries keep loop counts as 16 bits per pixel and are coloured when
+    shown, so the palette can change without a rebuild. A 32 x 32 grid of
+    64 pixel renders takes about 8 MB.
+
+    build() fills the entries on plain std::threads and can be stopped and
+    carried on. getPreview() can run on another thread meanwhile, blending
+    just the entries that are done.
+*/
+class JuliaAtlas
+{
+public:
+    struct Layout
+    {
+        // Entry (column, row) is the Julia set of c = (cRe + column * cStep, cIm + row * cStep)
+        double cRe { 0.0 }, cIm { 0.0 }, cStep { 0.0 };
+        int columns { 0 }, rows { 0 };
+
+        // Every entry is rendered centred on 0 at this size, with this formula and these limits
+        Formula formula;
+        int width { 0 }, height { 0 };
+        double pixelSize { 0.0 };
+        int minIterations { 1 }, maxIterations { 40 };
+
+        bool operator== (const Layout& other) const noexcept;
+        bool operator!= (const Layout& other) const noexcept  { return ! operator== (other); }
+
+        // The same for equal layouts, from one run to the next
+        uint64_t getHash() const noexcept;
+
+        int getNumEntries() const noexcept  { return columns * rows; }
+    };
+
+    /*  A grid of gridSize entries across the longer side of the area of
+        constants, each entry frame scaled down to thumbnailSize pixels on
+        its longer side.
+    */
+    static Layout makeLayout (const double cRe, const double cIm, const double cWidth, const double cHeight,
+                              const FractalParams& frame);
+
+    explicit JuliaAtlas (const Layout& layout);
+
+    const Layout& getLayout() const noexcept    { return m_layout; }
+
+    /*  Renders the entries that aren't done yet until they all are or
+        shouldStop is set; returns whether they all are.
+    */
+    bool build (const int numThreads, const std::atomic<bool>& shouldStop);
+
+    int getNumEntriesDone() const noexcept;
+    bool isComplete() const noexcept    { return getNumEntriesDone() == m_layout.getNumEntries(); }
+
+    /*  Colours the blend of the entries around c into width x height
+        0xAARRGGBB pixels of the layout, in rows lineStride pixels apart so
+        they can go straight into an image, returning false if c is off the
+        grid or none of the entries around it are done. The palette must be
+        built for the layout's iteration limits.
+    */
+    bool getPreview (const double cRe, const double cIm, const Palette& palette,
+                     uint32_t* pixels, const int lineStride) const;
+
+    // Only a complete atlas is saved; loading fails unless the file has this layout
+    bool save (const std::string& path) const;
+    bool load (const std::string& path);
+
+    static constexpr int gridSize = 32;
+    static constexpr int thumbnailSize = 64;
+
+    // Kept low so a build takes seconds whatever the limit of the frame
+    static constexpr int maxIterationLimit = 1000;
+
+private:
+    void buildEntry (const int entry);
+    const uint16_t* getCounts (const int entry) const noexcept;
+
+    Layout m_layout;
+    std::vector<uint16_t> m_counts;
+    std::unique_ptr<std::atomic<bool>[]> m_isDone;
+};
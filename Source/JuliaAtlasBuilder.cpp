@@ -0,0 +1,91 @@
+/*
+  ==============================================================================
+
+    JuliaAtlasBuilder.cpp
+    Created: 24 Oct 2026 11:40:26am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "JuliaAtlasBuilder.h"
+
+//==============================================================================
+JuliaAtlasBuilder::JuliaAtlasBuilder()
+    : juce::Thread ("Julia atlas") {}
+
+JuliaAtlasBuilder::~JuliaAtlasBuilder() {
+    stopTimer();
+    stop();
+}
+
+void JuliaAtlasBuilder::setLayout (const JuliaAtlas::Layout& layout) {
+    if (m_atlas != nullptr && m_atlas->getLayout() == layout && ! m_shouldStop) {
+        // Back where it was before it settled, so the current build carries on
+        m_hasPendingLayout = false;
+        stopTimer();
+        return;
+    }
+
+    m_pendingLayout = layout;
+    m_hasPendingLayout = true;
+    startTimer (settleDelayMs);
+}
+
+void JuliaAtlasBuilder::timerCallback() {
+    if (! m_hasPendingLayout) {
+        stopTimer();
+        return;
+    }
+
+    // The old build is left to notice the flag, and checked on until it has
+    if (isThreadRunning()) {
+        m_shouldStop = true;
+        startTimer (stopPollMs);
+        return;
+    }
+
+    stopTimer();
+
+    // The old atlas may still be drawn from, so it is dropped rather than reused
+    m_atlas = std::make_shared<JuliaAtlas> (m_pendingLayout);
+    m_hasPendingLayout = false;
+    m_shouldStop = false;
+    startThread();
+}
+
+void JuliaAtlasBuilder::stop() {
+    m_shouldStop = true;
+    stopThread (-1);
+}
+
+juce::File JuliaAtlasBuilder::getFolder() {
+    return juce::File::getSpecialLocation (juce::File::userApplicationDataDirectory)
+               .getChildFile ("FractalFactory").getChildFile ("Julia atlases");
+}
+
+void JuliaAtlasBuilder::run() {
+    const auto folder = getFolder();
+    const auto file = folder.getChildFile (juce::String::toHexString (static_cast<juce::int64> (m_atlas->getLayout().getHash()))
+                                           + ".atlas");
+
+    if (m_atlas->load (file.getFullPathName().toStdString())) {
+        // Marked as used, so it outlives atlases that weren't needed since
+        file.setLastModificationTime (juce::Time::getCurrentTime());
+        return;
+    }
+
+    // Half the cores, so the renders the atlas is standing in for aren't held up
+    if (! m_atlas->build (juce::jmax (1, juce::SystemStats::getNumCpus() / 2), m_shouldStop))
+        return;
+
+    if (folder.createDirectory().failed() || ! m_atlas->save (file.getFullPathName().toStdString()))
+        return;
+
+    auto saved = folder.findChildFiles (juce::File::findFiles, false, "*.atlas");
+    std::sort (saved.begin(), saved.end(), [] (const juce::File& a, const juce::File& b) {
+        return a.getLastModificationTime() > b.getLastModificationTime();
+    });
+    for (int i = maxSavedAtlases; i < saved.size(); i++)
+        saved.getReference (i).deleteFile();
+}
@@ -0,0 +1,61 @@
+/*
+  ==============================================================================
+
+    JuliaAtlasBuilder.h
+    Created: 24 Oct 2026 11:40:26am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "JuliaAtlas.h"
+
+//==============================================================================
+/*
+    Keeps a JuliaAtlas for the Mandelbrot box's view, built on a background
+    thread once the layout has settled.
+
+    Every pan and zoom step changes the layout, so a build only starts after
+    the layout has gone settleDelayMs without changing. A build that is still
+    going by then is signalled to stop, and the timer waits for it to finish
+    rather than blocking the message thread.
+
+    Finished atlases are saved to the application data folder under a name
+    taken from their layout, so a view seen in an earlier session, such as
+    the starting one, has its atlas loaded instead of built. Only the
+    maxSavedAtlases most recently used files are kept.
+*/
+class JuliaAtlasBuilder : private juce::Thread,
+                          private juce::Timer
+{
+public:
+    JuliaAtlasBuilder();
+    ~JuliaAtlasBuilder() override;
+
+    // Starts on the layout's atlas once it settles, unless it's the one there already
+    void setLayout (const JuliaAtlas::Layout& layout);
+
+    // The atlas of the latest settled layout, done or not; null before the first one
+    std::shared_ptr<const JuliaAtlas> getAtlas() const noexcept    { return m_atlas; }
+
+    static constexpr int maxSavedAtlases = 8;
+    static constexpr int settleDelayMs = 300;
+    static constexpr int stopPollMs = 20;
+
+private:
+    void run() override;
+    void timerCallback() override;
+    void stop();
+
+    static juce::File getFolder();
+
+    std::shared_ptr<JuliaAtlas> m_atlas;
+    JuliaAtlas::Layout m_pendingLayout;
+    bool m_hasPendingLayout {false};
+    std::atomic<bool> m_shouldStop {false};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JuliaAtlasBuilder)
+};
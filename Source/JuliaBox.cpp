@@ -11,67 +11,135 @@
 #include <JuceHeader.h>
 #include "JuliaBox.h"
 #include "FractalBox.h"
-#include <complex>
 
 //==============================================================================
 JuliaBox::JuliaBox() {
+    m_renderEngine.onTilesPublished = [this] (const juce::Rectangle<int>& area) {
+        const auto& params = m_renderEngine.getParams();
+        if (m_isShowingPreview && ! m_renderEngine.isRendering()
+            && params.cRe == m_previewPoint.getX() && params.cIm == m_previewPoint.getY()) {
+            m_isShowingPreview = false;
+            repaint();
+        }
+        repaint(DynamicResolution::toLogical(area, m_imageScale));
+        m_resolution.addFrame(m_renderEngine.getStats().getLatestFrame(), m_imageScale,
+                              static_cast<int>(m_width), static_cast<int>(m_height));
+        if (m_showStats) repaint(getStatsOverlayBounds());
+    };
+    m_resolution.onIdle = [this] {
+        // The same constant again, with every pixel now the drag has stopped
+        const auto& params = m_renderEngine.getParams();
+        if (params.type == FractalType::julia && m_imageScale != m_resolution.getScale()) {
+            const double scale = m_resolution.getScale();
+            setImageScale(scale);
+            m_renderScheduler.requestRender(getFractalParams({params.cRe, params.cIm}, scale));
+        }
+    };
+    setWantsKeyboardFocus(true);
 }
 
 JuliaBox::~JuliaBox() {}
 
 void JuliaBox::paint (juce::Graphics& g)
 {
+    const bool scaleChanged = m_resolution.setDisplayScale(getApproximateScaleFactorForComponent(this));
     if (hasSizeChanged(getWidth(), getHeight())) {
         initImage();
         drawFractal(juce::Point<double>{0.0,0.0});
+    } else if (scaleChanged) {
+        // Moved to a screen with another scale: the same constant at its pixels
+        const auto& params = m_renderEngine.getParams();
+        drawFractal({params.cRe, params.cIm});
     }
     auto bounds = getLocalBounds();
     g.setColour(juce::Colours::black);
     g.drawRect(bounds);
     
-    g.drawImageAt(m_image, 0, 0);
+    // Timed into the frame the image shows, so slow paints show up next to slow renders
+    const auto paintStarted = RenderStats::Clock::now();
+    if (m_isShowingPreview)
+        g.drawImage(m_preview, getLocalBounds().toFloat());
+    else
+        g.drawImage(m_image, getLocalBounds().toFloat());
+    m_renderEngine.getStats().addEvent(m_renderEngine.getCurrentFrame(), RenderStage::paint, -1,
+                                       paintStarted, RenderStats::Clock::now());
     
     g.drawLine(getWidth()/2, 0, getWidth()/2, getHeight());
     g.drawLine(0, getHeight()/2, getWidth(), getHeight()/2);
+
+    if (m_showStats)
+        drawStatsOverlay(g, m_renderEngine.getStats().getLatestFrame(), m_resolution.getDescription());
 }
 
 void JuliaBox::resized() {}
 
 void JuliaBox::drawFractal(juce::Point<double> zPoint) {
-    // Calculate Brot
-    int nIterations = 0;
-    
-    juce::Colour value;
-
-    for (double ptX = 0; ptX < getWidth(); ptX++)
-    {
-        for (double ptY = 0; ptY < getHeight(); ptY++)
-        {
-            nIterations = calcIterations(zPoint, juce::Point<double>{ptX, ptY});
-            if (nIterations == 0) value = juce::Colour(0,0,0);
-            else value = juce::Colour(255, 255-nIterations, 255-nIterations);
-            m_image.setPixelAt(ptX, ptY, value);
-        }
-    }
+    // Tiles are rendered on the engine's pool and copied into m_image as they finish.
+    // Going through the scheduler means a burst of drag events costs one render per frame.
+    const double scale = m_resolution.getScale();
+    setImageScale(scale);
+    m_renderScheduler.requestRender(getFractalParams(zPoint, scale));
+    showPreview(zPoint);
 }
 
-int JuliaBox::calcIterations (juce::Point<double> zPoint, juce::Point<double> cPoint) {
-    std::complex<double> complexZ(4*(cPoint.getX() / m_width) - 2,
-                                          4*(cPoint.getY() / m_height) - 2);
-    std::complex<double> complexPoint(zPoint.getX(), zPoint.getY());
+void JuliaBox::showPreview(juce::Point<double> zPoint) {
+    const auto atlas = m_atlasBuilder.getAtlas();
+    m_isShowingPreview = false;
+    if (atlas == nullptr)
+        return;
 
-    int nIterations = m_minIterations;
-    while ((abs(complexZ) < 2 ) && ( nIterations <= m_maxIterations ))
-    {
-        complexZ = complexZ * complexZ + complexPoint;
-        nIterations++;
+    // Counts only, so smooth colouring shows as classic until the render lands.
+    // Built once per atlas layout and colour change, not on every drag event
+    const auto& layout = atlas->getLayout();
+    if (! m_isPreviewPaletteBuilt || m_previewLayout != layout) {
+        m_previewPalette = m_renderEngine.getPalette();
+        m_previewPalette.build(layout.minIterations, layout.maxIterations);
+        m_previewLayout = layout;
+        m_isPreviewPaletteBuilt = true;
     }
 
-    if (nIterations < m_maxIterations) {
-        return ( 255 * nIterations ) / m_maxIterations;
-    } else {
-        return 0;
-    }
+    if (m_preview.getWidth() != layout.width || m_preview.getHeight() != layout.height)
+        m_preview = juce::Image(juce::Image::ARGB, layout.width, layout.height, false);
+
+    // An ARGB image's pixels are 0xAARRGGBB words, so the atlas writes its lines directly
+    const juce::Image::BitmapData bitmap(m_preview, juce::Image::BitmapData::writeOnly);
+    jassert(bitmap.pixelStride == sizeof(uint32_t));
+    if (! atlas->getPreview(zPoint.getX(), zPoint.getY(), m_previewPalette,
+                            reinterpret_cast<uint32_t*>(bitmap.getLinePointer(0)),
+                            bitmap.lineStride / static_cast<int>(sizeof(uint32_t))))
+        return;
+
+    m_previewPoint = zPoint;
+    m_isShowingPreview = true;
+    repaint();
+}
+
+void JuliaBox::setAtlasArea(const juce::Rectangle<double>& area) {
+    m_atlasArea = area;
+    updateAtlas();
+}
+
+void JuliaBox::updateAtlas() {
+    if (m_atlasArea.isEmpty() || m_width == 0 || m_height == 0)
+        return;
+
+    m_atlasBuilder.setLayout(JuliaAtlas::makeLayout(m_atlasArea.getX(), m_atlasArea.getY(), m_atlasArea.getWidth(),
+                                                    m_atlasArea.getHeight(), getFractalParams({})));
+}
+
+FractalParams JuliaBox::getFractalParams(juce::Point<double> zPoint, const double scale) const {
+    FractalParams params;
+    params.type = FractalType::julia;
+    params.formula = m_formula;
+    params.cRe = zPoint.getX();
+    params.cIm = zPoint.getY();
+    params.width = DynamicResolution::getScaledSize(static_cast<int>(m_width), scale);
+    params.height = DynamicResolution::getScaledSize(static_cast<int>(m_height), scale);
+    params.fitToSpan(m_fracSize);
+    params.minIterations = static_cast<int>(m_minIterations);
+    params.maxIterations = static_cast<int>(m_maxIterations);
+    params.precision = choosePrecision(params, false);
+    return params;
 }
 
 bool JuliaBox::hasSizeChanged(const int curWidth, const int curHeight) {
@@ -83,35 +151,33 @@ bool JuliaBox::hasSizeChanged(const int curWidth, const int curHeight) {
 void JuliaBox::initImage() {
     m_width = getWidth();
     m_height = getHeight();
-    m_imageRatio = static_cast<double>(getWidth())/static_cast<double>(getHeight());
-    if (m_imageRatio >= 1.f) {
-        m_widthMath = 4 * m_imageRatio;
-        m_heightMath = 4;
-    } else {
-        m_widthMath = 4;
-        m_heightMath = 4 / m_imageRatio;
-    }
-    m_image = juce::Image(juce::Image::RGB, m_width, m_height, true);
+    m_image = {};
+    setImageScale(m_resolution.getScale());
+    updateAtlas();
+}
+
+void JuliaBox::setImageScale(const double scale) {
+    // Stretched to the new size, to show until the frame at that size comes in
+    m_imageScale = scale;
+    const int width = DynamicResolution::getScaledSize(static_cast<int>(m_width), scale);
+    const int height = DynamicResolution::getScaledSize(static_cast<int>(m_height), scale);
+    if (m_image.getWidth() == width && m_image.getHeight() == height)
+        return;
+
+    m_renderEngine.setProgressive(true, RenderEngine::chooseCoarsestStep(width, height));
+    m_image = m_image.isValid() ? m_image.rescaled(width, height, juce::Graphics::lowResamplingQuality)
+                                : juce::Image(juce::Image::RGB, width, height, true);
 }
 
 juce::Point<double> JuliaBox::getMathCoord(const int x, const int y) {
-    juce::Point<double> pointOut;
-    if (m_imageRatio >= 1) {
-        pointOut = juce::Point<double>(
-               4*m_imageRatio*(static_cast<double>(x) / getWidth() - 0.5),  4*(static_cast<double>(y) / getHeight() - 0.5));
-    } else {
-        pointOut = juce::Point<double>(
-               4*(static_cast<double>(x) / getWidth() - 0.5),  4/m_imageRatio*(static_cast<double>(y) / getHeight() - 0.5));
-    }
-    return pointOut;
+    // The same mapping the renderer uses, so a click lands on the pixel it hit
+    const auto params = getFractalParams(juce::Point<double>());
+    return juce::Point<double>(params.mathX(x), params.mathY(y));
 }
 
 juce::Point<int> JuliaBox::getDispCoord(const double x, const double y) {
-    double xDisp = static_cast<double>(m_width) * (x + static_cast<double>(m_widthMath) / 2.f) / static_cast<double>(m_widthMath);
-    double yDisp = static_cast<double>(m_height) * (y + static_cast<double>(m_heightMath) / 2.f) / static_cast<double>(m_heightMath);
-    auto outPoint = juce::Point<int>(std::round(xDisp), std::round(yDisp));
-
-    return outPoint;
+    const auto params = getFractalParams(juce::Point<double>());
+    return juce::Point<int>(std::round(params.pixelX(x)), std::round(params.pixelY(y)));
 }
 
 void JuliaBox::mouseDown (const juce::MouseEvent& event) {
@@ -122,6 +188,7 @@ void JuliaBox::mouseDown (const juce::MouseEvent& event) {
 }
 
 void JuliaBox::mouseDrag (const juce::MouseEvent& event) {
+    m_resolution.interacted();
     juce::Point<int> point = event.getPosition();
     auto pointD = getMathCoord(point.getX(), point.getY());
     drawFractal(pointD);
@@ -134,12 +201,91 @@ void JuliaBox::mouseUp (const juce::MouseEvent& event) {
     repaint();
 }
 
-void JuliaBox::setNewFractal(const juce::Point<double> point) {
+bool JuliaBox::keyPressed (const juce::KeyPress& key) {
+    // Colour changes only recolour the stored iteration counts
+    auto& palette = m_renderEngine.getPalette();
+    auto character = key.getTextCharacter();
+
+    if (character == '+' || character == '=' || character == '-') {
+        // Raising the limit only continues the orbits that had not escaped yet
+        if (character == '-')
+            m_maxIterations = juce::jmax(m_minIterations + 1, m_maxIterations / 2);
+        else
+            m_maxIterations = juce::jmin(m_maxIterations * 2, maxIterationLimit);
+
+        if (! m_renderEngine.deepen(static_cast<int>(m_maxIterations))) {
+            auto params = m_renderEngine.getParams();
+            params.maxIterations = static_cast<int>(m_maxIterations);
+            m_renderScheduler.requestRender(params);
+        }
+        updateAtlas();
+        return true;
+    }
+
+    if (character == 'i') {
+        m_showStats = ! m_showStats;
+        repaint(getStatsOverlayBounds());
+        return true;
+    }
+
+    if (character == 't') {
+        // Both boxes go in one trace, so their frames can be lined up
+        const auto file = exportChromeTrace({&m_fractalBox->getRenderStats(), &m_renderEngine.getStats()});
+        juce::Logger::writeToLog(file.existsAsFile() ? "Render trace written to " + file.getFullPathName()
+                                                     : juce::String("Couldn't write the render trace"));
+        return true;
+    }
+
+    if (character == 'a') {
+        // Off, then 4 and 16 samples across each pixel on an edge
+        const int samples = m_renderEngine.getAntialiasing();
+        m_renderEngine.setAntialiasing(samples == 0 ? 4 : samples == 4 ? 16 : 0);
+        return true;
+    }
+
+    if (character == 's') {
+        m_renderEngine.setSubdivision(! m_renderEngine.isSubdividing());
+        m_renderScheduler.requestRender(m_renderEngine.getParams());
+        return true;
+    }
+
+    if (character == 'c') {
+        if (palette.getMode() == Palette::Mode::classic) palette.setMode(Palette::Mode::smooth);
+        else if (palette.getMode() == Palette::Mode::smooth) palette.setMode(Palette::Mode::histogram);
+        else palette.setMode(Palette::Mode::classic);
+    } else if (character == '[') {
+        palette.setCycleOffset(palette.getCycleOffset() - 8);
+    } else if (character == ']') {
+        palette.setCycleOffset(palette.getCycleOffset() + 8);
+    } else {
+        return false;
+    }
+
+    m_isPreviewPaletteBuilt = false;
+    m_renderEngine.recolour();
+    return true;
+}
+
+void JuliaBox::setNewFractal(const juce::Point<double> point, const bool isDragging) {
+    if (isDragging)
+        m_resolution.interacted();
     drawFractal(point);
     m_fractalBox->setNewOrbit(point);
     repaint();
 }
 
+void JuliaBox::setFormula(const Formula& formula) {
+    // Same constant, new formula; the first paint draws it if nothing has been yet
+    m_formula = formula;
+    updateAtlas();
+    auto params = m_renderEngine.getParams();
+    if (params.type != FractalType::julia)
+        return;
+    params.formula = formula;
+    params.precision = choosePrecision(params, false);
+    m_renderScheduler.requestRender(params);
+}
+
 void JuliaBox::setFractalBox(FractalBox& fractalBox) {
     m_fractalBox = std::shared_ptr<FractalBox>(&fractalBox);
 }
@@ -11,6 +11,11 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "DynamicResolution.h"
+#include "JuliaAtlasBuilder.h"
+#include "RenderEngine.h"
+#include "RenderScheduler.h"
+#include "StatsOverlay.h"
 
 
 class FractalBox;
@@ -25,31 +30,62 @@ public:
     void resized() override;
     
     void drawFractal(juce::Point<double> zPoint);
-    int calcIterations(juce::Point<double> zPoint, juce::Point<double> cPoint);
     bool hasSizeChanged(const int curWidth, const int curHeight);
     void initImage();
+    void setImageScale(const double scale);
     juce::Point<double> getMathCoord(const int x, const int y);
     juce::Point<int> getDispCoord(const double x, const double y);
     
     void mouseDown (const juce::MouseEvent& event) override;
     void mouseDrag (const juce::MouseEvent& event) override;
     void mouseUp (const juce::MouseEvent& event) override;
+    bool keyPressed (const juce::KeyPress& key) override;
 
-    void setNewFractal(const juce::Point<double> point);
+    // isDragging trades resolution for speed until the drag stops
+    void setNewFractal(const juce::Point<double> point, const bool isDragging = false);
     void setFractalBox(FractalBox& fractalBox);
+    void setFormula(const Formula& formula);
+    void setAtlasArea(const juce::Rectangle<double>& area);
+    const RenderStats& getRenderStats() const { return m_renderEngine.getStats(); }
+    const DynamicResolution& getResolution() const { return m_resolution; }
     
 private:
+    FractalParams getFractalParams(juce::Point<double> zPoint, const double scale = 1.0) const;
+    void updateAtlas();
+    void showPreview(juce::Point<double> zPoint);
+
     std::shared_ptr<FractalBox> m_fractalBox{nullptr};
     juce::Image m_image;
+    RenderEngine m_renderEngine{"Julia"};
+    RenderScheduler m_renderScheduler{m_renderEngine, m_image};
     
     uint m_minIterations {1};
     uint m_maxIterations {100};
+    static constexpr uint maxIterationLimit {1 << 16};
     uint m_width{0}, m_height{0};
     
-    double m_imageRatio {1.f};
+    // m_image has m_imageScale pixels per logical one, as the FractalBox's does
+    DynamicResolution m_resolution;
+    double m_imageScale {1.0};
+    
     double m_fracSize {4};
-    double m_widthMath {0.f}, m_heightMath {0.f};
+    Formula m_formula;
+    
+    // Julia sets for a grid of constants over the Mandelbrot box's view. While
+    // a render is on its way the blend for its constant is shown, scaled up
+    // from the atlas, and once the render finishes the real image replaces it
+    JuliaAtlasBuilder m_atlasBuilder;
+    juce::Rectangle<double> m_atlasArea;
+    juce::Image m_preview;
+    juce::Point<double> m_previewPoint;
+    bool m_isShowingPreview {false};
+
+    // The engine's palette built for m_previewLayout's limits, until the colours change
+    Palette m_previewPalette;
+    JuliaAtlas::Layout m_previewLayout;
+    bool m_isPreviewPaletteBuilt {false};
     
     bool m_mouseIsPressed {false};
+    bool m_showStats {false};
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (JuliaBox)
 };
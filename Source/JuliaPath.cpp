@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    JuliaPath.cpp
+    Created: 25 Oct 2026 9:42:16am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "JuliaPath.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+//==============================================================================
+bool readJuliaPath (const std::string& path, JuliaPath& points) {
+    std::ifstream file (path);
+    if (! file)
+        return false;
+
+    points.clear();
+    std::string line;
+    while (std::getline (file, line))
+    {
+        const auto first = line.find_first_not_of (" \t\r");
+        if (first == std::string::npos || line[first] == '#')
+            continue;
+
+        const char* text = line.c_str() + first;
+        char* end = nullptr;
+        const double re = std::strtod (text, &end);
+        if (end == text || *end != ',')
+            return false;
+
+        const char* rest = end + 1;
+        const double im = std::strtod (rest, &end);
+        if (end == rest || std::string (end).find_first_not_of (" \t\r") != std::string::npos)
+            return false;
+
+        points.emplace_back (re, im);
+    }
+    return ! file.bad();
+}
+
+bool writeJuliaPath (const std::string& path, const JuliaPath& points) {
+    std::FILE* file = std::fopen (path.c_str(), "w");
+    if (file == nullptr)
+        return false;
+
+    bool isWritten = std::fputs ("# Julia constants, one per frame, as re,im\n", file) >= 0;
+    for (const auto& point : points)
+        isWritten = isWritten && std::fprintf (file, "%.17g,%.17g\n", point.real(), point.imag()) > 0;
+    isWritten = std::fclose (file) == 0 && isWritten;
+
+    if (! isWritten)
+        std::remove (path.c_str());
+    return isWritten;
+}
+
+//==============================================================================
+JuliaPath resampleJuliaPath (const JuliaPath& points, const int numFrames) {
+    if (points.empty() || numFrames <= 0)
+        return {};
+
+    // Distance along the path to each point
+    std::vector<double> distances (points.size(), 0.0);
+    for (size_t i = 1; i < points.size(); i++)
+        distances[i] = distances[i - 1] + std::abs (points[i] - points[i - 1]);
+
+    const double length = distances.back();
+    if (numFrames == 1 || length == 0.0)
+        return JuliaPath (static_cast<size_t> (numFrames), points.front());
+
+    JuliaPath frames;
+    frames.reserve (static_cast<size_t> (numFrames));
+    size_t segment = 1;
+
+    for (int frame = 0; frame < numFrames; frame++)
+    {
+        const double distance = length * frame / (numFrames - 1);
+        while (segment + 1 < points.size() && distances[segment] < distance)
+            segment++;
+
+        // Repeated points make segments of no length, which the loop above steps over
+        const double segmentLength = distances[segment] - distances[segment - 1];
+        const double fraction = segmentLength > 0.0
+                              ? std::clamp ((distance - distances[segment - 1]) / segmentLength, 0.0, 1.0)
+                              : 1.0;
+        frames.push_back (points[segment - 1] + fraction * (points[segment] - points[segment - 1]));
+    }
+    return frames;
+}
+
+JuliaPath makeJuliaCircle (const std::complex<double> centre, const double radius, const int numFrames) {
+    constexpr double twoPi = 6.283185307179586;
+    JuliaPath frames;
+    for (int frame = 0; frame < numFrames; frame++)
+        frames.push_back (centre + std::polar (radius, twoPi * frame / numFrames));
+    return frames;
+}
@@ -0,0 +1,42 @@
+/*
+  ==============================================================================
+
+    JuliaPath.h
+    Created: 25 Oct 2026 9:42:16am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <complex>
+#include <string>
+#include <vector>
+
+//==============================================================================
+/*
+    Paths of Julia constants for animations: one c per frame, from a drag
+    recorded in the app or from a curve.
+
+    The file is text, one constant per line as "re,im" to the full precision
+    of a double. Blank lines and lines starting with '#' are skipped.
+*/
+using JuliaPath = std::vector<std::complex<double>>;
+
+bool readJuliaPath (const std::string& path, JuliaPath& points);
+
+// Returns false if the file couldn't be written
+bool writeJuliaPath (const std::string& path, const JuliaPath& points);
+
+/*  numFrames constants spaced evenly along the straight segments joining
+    the points, from the first to the last, so an animation moves at the
+    same speed however fast the drag that recorded it went.
+*/
+JuliaPath resampleJuliaPath (const JuliaPath& points, const int numFrames);
+
+/*  numFrames constants going once around the circle, anticlockwise from
+    centre + radius. The last stops a step short of the first, so the
+    animation loops without a repeated frame.
+*/
+JuliaPath makeJuliaCircle (const std::complex<double> centre, const double radius, const int numFrames);
@@ -0,0 +1,106 @@
+/*
+  ==============================================================================
+
+    Palette.cpp
+    Created: 17 Oct 2026 4:05:33pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "Palette.h"
+#include "EscapeTime.h"
+#include "IterationBuffer.h"
+#include <algorithm>
+#include <cmath>
+
+static uint32_t packColour (const uint32_t r, const uint32_t g, const uint32_t b) noexcept {
+    return 0xff000000u | (r << 16) | (g << 8) | b;
+}
+
+void Palette::setCycleOffset (const int offset) noexcept {
+    m_cycleOffset = ((offset % (gradientSize - 1)) + (gradientSize - 1)) % (gradientSize - 1);
+}
+
+int Palette::cycled (const int shade) const noexcept {
+    if (shade == 0) return 0;
+    return 1 + (shade - 1 + m_cycleOffset) % (gradientSize - 1);
+}
+
+void Palette::build (const int minIterations, const int maxIterations,
+                     const IterationBuffer* frame) {
+    if (frame != nullptr)
+        build (minIterations, maxIterations, frame->getAllCounts().data(), frame->getAllCounts().size());
+    else
+        build (minIterations, maxIterations, nullptr, 0);
+}
+
+void Palette::build (const int minIterations, const int maxIterations,
+                     const int* counts, const size_t numCounts) {
+    m_minIterations = minIterations;
+    m_maxIterations = maxIterations;
+
+    m_gradient.resize (gradientSize);
+    m_gradient[0] = packColour (0, 0, 0);
+    for (uint32_t shade = 1; shade < gradientSize; shade++)
+        m_gradient[shade] = packColour (255, 255 - shade, 255 - shade);
+
+    const auto numShades = static_cast<size_t> (maxIterations + 2 - minIterations);
+    std::vector<int> shades (numShades);
+
+    for (int nIterations = minIterations; nIterations <= maxIterations + 1; nIterations++)
+        shades[static_cast<size_t> (nIterations - minIterations)] = shadeFromIterations (nIterations, maxIterations);
+
+    if (m_mode == Mode::histogram && counts != nullptr)
+    {
+        // Spread the escaped pixels evenly over the gradient by their rank
+        std::vector<size_t> histogram (numShades, 0);
+        size_t numEscaped = 0;
+
+        for (const int* end = counts + numCounts; counts != end; counts++)
+        {
+            const int nIterations = *counts;
+            if (nIterations >= minIterations && nIterations < maxIterations)
+            {
+                histogram[static_cast<size_t> (nIterations - minIterations)]++;
+                numEscaped++;
+            }
+        }
+
+        size_t runningTotal = 0;
+        for (size_t i = 0; i < numShades; i++)
+        {
+            runningTotal += histogram[i];
+            if (shades[i] != 0 && numEscaped > 0)
+                shades[i] = 1 + static_cast<int> ((gradientSize - 2) * runningTotal / numEscaped);
+        }
+    }
+
+    m_colours.resize (numShades);
+    for (size_t i = 0; i < numShades; i++)
+        m_colours[i] = m_gradient[static_cast<size_t> (cycled (shades[i]))];
+}
+
+int Palette::getSmoothIndex (const int nIterations, const float magnitude) const noexcept {
+    if (nIterations >= m_maxIterations)
+        return 0;
+
+    // Continuous escape count: the fractional part comes from how far past the
+    // bailout radius the final z landed.
+    const double logMagnitude = std::log (std::max (static_cast<double> (magnitude), 1.000001));
+    const double nu = nIterations + 1 - std::log2 (std::max (logMagnitude / std::log (2.0), 1.0e-6));
+    const auto shade = static_cast<int> ((gradientSize - 1) * nu / m_maxIterations);
+
+    return cycled (std::clamp (shade, 1, gradientSize - 1));
+}
+
+void Palette::colourFrame (const IterationBuffer& frame, uint32_t* pixels) const noexcept {
+    for (int ptY = 0; ptY < frame.getHeight(); ptY++)
+    {
+        const int* counts = frame.getCounts (ptY);
+        const float* magnitudes = frame.getMagnitudes (ptY);
+
+        for (int ptX = 0; ptX < frame.getWidth(); ptX++)
+            *pixels++ = getColour (counts[ptX], magnitudes[ptX]);
+    }
+}
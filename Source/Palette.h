@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+
+    Palette.h
+    Created: 17 Oct 2026 4:05:33pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class IterationBuffer;
+
+//==============================================================================
+/*
+    Turns loop counts into 0xAARRGGBB colours.
+
+    Every mode works on a 256 entry gradient where entry 0 is the colour of
+    the set itself. Classic and histogram colouring depend only on the count,
+    so they are precomputed per count and the colour pass is one lookup per
+    pixel. Smooth colouring also needs the final |z| and picks the gradient
+    entry per pixel. The cycle offset rotates the gradient without touching
+    entry 0.
+*/
+class Palette
+{
+public:
+    enum class Mode
+    {
+        classic,
+        smooth,
+        histogram
+    };
+
+    static constexpr int gradientSize = 256;
+
+    void setMode (const Mode mode) noexcept             { m_mode = mode; }
+    Mode getMode() const noexcept                       { return m_mode; }
+    void setCycleOffset (const int offset) noexcept;
+    int getCycleOffset() const noexcept                 { return m_cycleOffset; }
+
+    bool usesMagnitude() const noexcept                 { return m_mode == Mode::smooth; }
+    bool needsWholeFrame() const noexcept               { return m_mode == Mode::histogram; }
+
+    /*  Rebuilds the tables for counts in [minIterations, maxIterations + 1].
+        Histogram mode equalizes over the counts in frame; without a frame it
+        falls back to the classic mapping.
+    */
+    void build (const int minIterations, const int maxIterations,
+                const IterationBuffer* frame = nullptr);
+
+    // The same, equalizing over numCounts counts that aren't in an IterationBuffer
+    void build (const int minIterations, const int maxIterations,
+                const int* counts, const size_t numCounts);
+
+    uint32_t getColour (const int nIterations) const noexcept
+    {
+        return m_colours[static_cast<size_t> (nIterations - m_minIterations)];
+    }
+
+    // Gradient entry for the smooth mode, 0 for points inside the set
+    int getSmoothIndex (const int nIterations, const float magnitude) const noexcept;
+
+    uint32_t getColour (const int nIterations, const float magnitude) const noexcept
+    {
+        return usesMagnitude() ? m_gradient[static_cast<size_t> (getSmoothIndex (nIterations, magnitude))]
+                               : getColour (nIterations);
+    }
+
+    // Colours a whole frame into 0xAARRGGBB pixels, row by row
+    void colourFrame (const IterationBuffer& frame, uint32_t* pixels) const noexcept;
+
+    const std::vector<uint32_t>& getColours() const noexcept   { return m_colours; }
+    const std::vector<uint32_t>& getGradient() const noexcept  { return m_gradient; }
+    int getMinIterations() const noexcept                      { return m_minIterations; }
+
+private:
+    int cycled (const int shade) const noexcept;
+
+    Mode m_mode {Mode::classic};
+    int m_cycleOffset {0};
+
+    std::vector<uint32_t> m_colours;
+    std::vector<uint32_t> m_gradient;
+    int m_minIterations {1};
+    int m_maxIterations {1};
+};
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    Perturbation.cpp
+    Created: 20 Oct 2026 3:05:19pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "Perturbation.h"
+#include <cmath>
+
+ReferenceOrbit::ReferenceOrbit (const FractalParams& params, const FixedPoint& centreX, const FixedPoint& centreY)
+    : m_maxIterations (params.maxIterations) {
+    const int numLimbs = FixedPoint::getLimbsFor (params.pixelSize);
+    const bool isJulia = params.type == FractalType::julia;
+
+    const FixedPoint pointX = centreX.withFractionLimbs (numLimbs);
+    const FixedPoint pointY = centreY.withFractionLimbs (numLimbs);
+
+    FixedPoint zRe = isJulia ? pointX : FixedPoint().withFractionLimbs (numLimbs);
+    FixedPoint zIm = isJulia ? pointY : FixedPoint().withFractionLimbs (numLimbs);
+    const FixedPoint cRe = isJulia ? FixedPoint (params.cRe).withFractionLimbs (numLimbs) : pointX;
+    const FixedPoint cIm = isJulia ? FixedPoint (params.cIm).withFractionLimbs (numLimbs) : pointY;
+
+    m_re.reserve (static_cast<size_t> (params.maxIterations) + 1);
+    m_im.reserve (static_cast<size_t> (params.maxIterations) + 1);
+    m_re.push_back (zRe.toDouble());
+    m_im.push_back (zIm.toDouble());
+
+    // Stops one step after escaping, so the orbit always has at least two
+    // points and the pixels near an escaping centre see it leave
+    for (int step = 0; step < params.maxIterations; step++)
+    {
+        const FixedPoint reSquared = zRe * zRe;
+        const FixedPoint imSquared = zIm * zIm;
+        const FixedPoint product = zRe * zIm;
+
+        zRe = reSquared - imSquared + cRe;
+        zIm = product + product + cIm;
+
+        const double re = zRe.toDouble(), im = zIm.toDouble();
+        m_re.push_back (re);
+        m_im.push_back (im);
+
+        if (re * re + im * im > 4.0)
+            break;
+    }
+}
+
+/*  Offsets this small square to below the smallest normal double, where
+    the result is too small to matter and the denormals are many times slower
+    to work with. Skipping the square keeps very deep views at full speed.
+*/
+static inline bool isNegligible (const double re, const double im) noexcept {
+    return std::abs (re) + std::abs (im) < 1.0e-154;
+}
+
+void calcIterationsPerturbed (const FractalParams& params, const int x, const int y,
+                              const OrbitResults& results) noexcept {
+    const auto& reference = *params.reference;
+    const bool isJulia = params.type == FractalType::julia;
+    const int last = reference.getLength() - 1;
+
+    // The same offsets mathX() and mathY() add to the centre
+    const double offsetX = (x - params.width * 0.5) * params.pixelSize;
+    const double offsetY = (y - params.height * 0.5) * params.pixelSize;
+
+    const double dcRe = isJulia ? 0.0 : offsetX;
+    const double dcIm = isJulia ? 0.0 : offsetY;
+    double dRe = isJulia ? offsetX : 0.0;
+    double dIm = isJulia ? offsetY : 0.0;
+
+    int step = 0;
+    double zRe = reference.getRe (0) + dRe;
+    double zIm = reference.getIm (0) + dIm;
+
+    int nIterations = params.minIterations;
+    while (zRe * zRe + zIm * zIm < 4.0 && nIterations <= params.maxIterations)
+    {
+        const double refRe = reference.getRe (step);
+        const double refIm = reference.getIm (step);
+
+        // d' = 2 Z d + d^2 + dc
+        double newRe = 2.0 * (refRe * dRe - refIm * dIm) + dcRe;
+        double newIm = 2.0 * (refRe * dIm + refIm * dRe) + dcIm;
+
+        if (! isNegligible (dRe, dIm))
+        {
+            newRe += dRe * dRe - dIm * dIm;
+            newIm += 2.0 * dRe * dIm;
+        }
+        dRe = newRe;
+        dIm = newIm;
+        step++;
+        nIterations++;
+
+        zRe = reference.getRe (step) + dRe;
+        zIm = reference.getIm (step) + dIm;
+
+        const bool isGlitching = ! isNegligible (dRe, dIm) && zRe * zRe + zIm * zIm < dRe * dRe + dIm * dIm;
+        if (isGlitching || step == last)
+        {
+            dRe = zRe - reference.getRe (0);
+            dIm = zIm - reference.getIm (0);
+            step = 0;
+        }
+    }
+
+    results.nIterations[0] = nIterations;
+    if (results.finalMagnitudes != nullptr) results.finalMagnitudes[0] = magnitudeOf (zRe, zIm);
+    if (results.finalRe != nullptr)         results.finalRe[0] = zRe;
+    if (results.finalIm != nullptr)         results.finalIm[0] = zIm;
+}
@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    Perturbation.h
+    Created: 20 Oct 2026 3:05:19pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include "EscapeTime.h"
+#include "FixedPoint.h"
+
+//==============================================================================
+/*
+    Deep zoom by perturbation. Once pixels are closer together than doubles
+    can resolve, only the orbit of the image centre is iterated at high
+    precision. Every pixel then follows that reference orbit Z as a small
+    offset d in plain doubles:
+
+        d' = 2 Z d + d^2 + (pixel offset from the centre, for Mandelbrot)
+
+    which costs about the same as the ordinary loop however deep the view.
+
+    An offset goes wrong ("glitches") when the pixel's z passes much closer
+    to 0 than Z does, because d then carries all of z's magnitude and the
+    small terms lose their precision against it. Whenever |Z + d| < |d|,
+    or the reference runs out because it escaped first, the pixel rebases:
+    it carries on from the start of the reference with d = z - Z0. That keeps
+    every pixel on one reference orbit, with no second pass over glitched
+    pixels.
+
+    Offsets are doubles, so views go down to pixels of about 1e-290.
+*/
+class ReferenceOrbit
+{
+public:
+    /*  Iterates the orbit of (centreX, centreY) for up to params.maxIterations
+        steps, with enough limbs to resolve params.pixelSize. The centre
+        replaces params.centreX/Y, which only hold it to double precision.
+    */
+    ReferenceOrbit (const FractalParams& params, const FixedPoint& centreX, const FixedPoint& centreY);
+
+    // Long enough for any limit up to this
+    int getMaxIterations() const noexcept   { return m_maxIterations; }
+    int getLength() const noexcept          { return static_cast<int> (m_re.size()); }
+
+    double getRe (const int step) const noexcept   { return m_re[static_cast<size_t> (step)]; }
+    double getIm (const int step) const noexcept   { return m_im[static_cast<size_t> (step)]; }
+
+private:
+    std::vector<double> m_re, m_im;
+    int m_maxIterations;
+};
+
+// The deepest pixels whose offsets still fit comfortably in a double
+static constexpr double smallestPixelSize = 1.0e-290;
+
+/*  Iterates pixel (x, y) of a frame with a reference orbit and stores the
+    result in the first entry of results. Counts follow calcIterations():
+    maxIterations + 1 means the point never escaped.
+*/
+void calcIterationsPerturbed (const FractalParams& params, const int x, const int y,
+                              const OrbitResults& results) noexcept;
@@ -0,0 +1,384 @@
+/*
+  ==============================================================================
+
+    PngWriter.cpp
+    Created: 19 Oct 2026 2:47:31pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "PngWriter.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+
+namespace
+{
+    uint32_t crc32 (const uint8_t* data, const size_t size, uint32_t crc = 0) noexcept
+    {
+        static const auto table = []
+        {
+            std::array<uint32_t, 256> entries {};
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t value = i;
+                for (int bit = 0; bit < 8; bit++)
+                    value = (value & 1) != 0 ? 0xedb88320u ^ (value >> 1) : value >> 1;
+                entries[i] = value;
+            }
+            return entries;
+        }();
+
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++)
+            crc = table[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    constexpr uint32_t adlerBase = 65521;
+
+    uint32_t adler32 (const uint8_t* data, size_t size, const uint32_t adler = 1) noexcept
+    {
+        uint32_t a = adler & 0xffff, b = adler >> 16;
+
+        // 5552 bytes is the most that can be summed before b could overflow
+        while (size > 0)
+        {
+            const size_t run = std::min (size, size_t {5552});
+            for (size_t i = 0; i < run; i++)
+            {
+                a += data[i];
+                b += a;
+            }
+            a %= adlerBase;
+            b %= adlerBase;
+            data += run;
+            size -= run;
+        }
+        return (b << 16) | a;
+    }
+
+    // The Adler-32 of two runs of bytes back to back, from each run's own
+    uint32_t combineAdler32 (const uint32_t first, const uint32_t second, const size_t secondSize) noexcept
+    {
+        const auto remainder = static_cast<uint32_t> (secondSize % adlerBase);
+        uint32_t a = first & 0xffff;
+        uint32_t b = static_cast<uint32_t> ((static_cast<uint64_t> (remainder) * a) % adlerBase);
+
+        a += (second & 0xffff) + adlerBase - 1;
+        b += (first >> 16) + (second >> 16) + adlerBase - remainder;
+        a %= adlerBase;
+        b %= adlerBase;
+        return (b << 16) | a;
+    }
+
+    class BitWriter
+    {
+    public:
+        explicit BitWriter (std::vector<uint8_t>& out) : m_out (out) {}
+
+        // Deflate packs values least significant bit first...
+        void write (const uint32_t value, const int numBits)
+        {
+            m_buffer |= static_cast<uint64_t> (value) << m_numBits;
+            m_numBits += numBits;
+            while (m_numBits >= 8)
+            {
+                m_out.push_back (static_cast<uint8_t> (m_buffer));
+                m_buffer >>= 8;
+                m_numBits -= 8;
+            }
+        }
+
+        // ...but Huffman codes most significant bit first
+        void writeCode (const uint32_t code, const int numBits)
+        {
+            uint32_t reversed = 0;
+            for (int bit = 0; bit < numBits; bit++)
+                reversed |= ((code >> bit) & 1) << (numBits - 1 - bit);
+            write (reversed, numBits);
+        }
+
+        void flush()
+        {
+            if (m_numBits > 0)
+                m_out.push_back (static_cast<uint8_t> (m_buffer));
+            m_buffer = 0;
+            m_numBits = 0;
+        }
+
+    private:
+        std::vector<uint8_t>& m_out;
+        uint64_t m_buffer {0};
+        int m_numBits {0};
+    };
+
+    void writeLiteralOrLength (BitWriter& bits, const int symbol)
+    {
+        if (symbol < 144)       bits.writeCode (0x30u + static_cast<uint32_t> (symbol), 8);
+        else if (symbol < 256)  bits.writeCode (0x190u + static_cast<uint32_t> (symbol - 144), 9);
+        else if (symbol < 280)  bits.writeCode (static_cast<uint32_t> (symbol - 256), 7);
+        else                    bits.writeCode (0xc0u + static_cast<uint32_t> (symbol - 280), 8);
+    }
+
+    void writeMatch (BitWriter& bits, const int length, const int distance)
+    {
+        static constexpr int lengthBase[] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                              35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        static constexpr int lengthExtra[] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                               3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        static constexpr int distanceBase[] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                                257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                                8193, 12289, 16385, 24577 };
+        static constexpr int distanceExtra[] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                                 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+        int lengthCode = 28;
+        while (lengthBase[lengthCode] > length)
+            lengthCode--;
+        writeLiteralOrLength (bits, 257 + lengthCode);
+        bits.write (static_cast<uint32_t> (length - lengthBase[lengthCode]), lengthExtra[lengthCode]);
+
+        int distanceCode = 29;
+        while (distanceBase[distanceCode] > distance)
+            distanceCode--;
+        bits.writeCode (static_cast<uint32_t> (distanceCode), 5);
+        bits.write (static_cast<uint32_t> (distance - distanceBase[distanceCode]), distanceExtra[distanceCode]);
+    }
+
+    /*  Appends data as one fixed-Huffman deflate block. A block that isn't
+        the last is followed by an empty stored block, which ends it on a byte
+        boundary, so runs of data deflated separately can be concatenated.
+    */
+    void deflate (const std::vector<uint8_t>& data, const bool isLast, std::vector<uint8_t>& out)
+    {
+        constexpr int windowSize = 32768;
+        constexpr int minMatch = 3, maxMatch = 258;
+        constexpr int hashBits = 15;
+        constexpr int maxChainLength = 32;
+
+        BitWriter bits (out);
+        bits.write (isLast ? 1 : 0, 1);
+        bits.write (1, 2);  // fixed Huffman codes
+
+        const int size = static_cast<int> (data.size());
+        std::vector<int> head (1 << hashBits, -1);
+        std::vector<int> previous (static_cast<size_t> (size), -1);
+
+        auto hashAt = [&data] (const int pos)
+        {
+            const uint32_t value = static_cast<uint32_t> (data[static_cast<size_t> (pos)]) << 16
+                                 | static_cast<uint32_t> (data[static_cast<size_t> (pos + 1)]) << 8
+                                 | data[static_cast<size_t> (pos + 2)];
+            return static_cast<size_t> ((value * 2654435761u) >> (32 - hashBits));
+        };
+
+        auto insert = [&] (const int pos)
+        {
+            if (pos + minMatch > size)
+                return;
+            const auto hash = hashAt (pos);
+            previous[static_cast<size_t> (pos)] = head[hash];
+            head[hash] = pos;
+        };
+
+        int pos = 0;
+        while (pos < size)
+        {
+            int bestLength = 0, bestDistance = 0;
+
+            if (pos + minMatch <= size)
+            {
+                const int longest = std::min (maxMatch, size - pos);
+                int candidate = head[hashAt (pos)];
+
+                for (int chain = 0; candidate >= 0 && pos - candidate <= windowSize && chain < maxChainLength; chain++)
+                {
+                    int length = 0;
+                    while (length < longest && data[static_cast<size_t> (candidate + length)] == data[static_cast<size_t> (pos + length)])
+                        length++;
+
+                    if (length > bestLength)
+                    {
+                        bestLength = length;
+                        bestDistance = pos - candidate;
+                        if (length == longest)
+                            break;
+                    }
+                    candidate = previous[static_cast<size_t> (candidate)];
+                }
+            }
+
+            if (bestLength >= minMatch)
+            {
+                writeMatch (bits, bestLength, bestDistance);
+                for (int i = 0; i < bestLength; i++)
+                    insert (pos + i);
+                pos += bestLength;
+            }
+            else
+            {
+                writeLiteralOrLength (bits, data[static_cast<size_t> (pos)]);
+                insert (pos);
+                pos++;
+            }
+        }
+
+        writeLiteralOrLength (bits, 256);
+
+        if (! isLast)
+        {
+            bits.write (0, 3);  // a stored block, not the last
+            bits.flush();
+            out.insert (out.end(), { 0x00, 0x00, 0xff, 0xff });
+        }
+        bits.flush();
+    }
+
+    // The raw image data of rows: a filter byte, 0 for none, then RGB
+    std::vector<uint8_t> toScanlines (const int width, const int numRows, const uint32_t* pixels)
+    {
+        std::vector<uint8_t> raw;
+        raw.reserve (static_cast<size_t> (numRows) * (static_cast<size_t> (width) * 3 + 1));
+        for (int ptY = 0; ptY < numRows; ptY++)
+        {
+            raw.push_back (0);
+            for (int ptX = 0; ptX < width; ptX++)
+            {
+                const uint32_t argb = *pixels++;
+                raw.push_back (static_cast<uint8_t> (argb >> 16));
+                raw.push_back (static_cast<uint8_t> (argb >> 8));
+                raw.push_back (static_cast<uint8_t> (argb));
+            }
+        }
+        return raw;
+    }
+
+    void appendBigEndian (std::vector<uint8_t>& out, const uint32_t value)
+    {
+        for (int shift = 24; shift >= 0; shift -= 8)
+            out.push_back (static_cast<uint8_t> (value >> shift));
+    }
+
+    void appendChunk (std::vector<uint8_t>& png, const char* type, const std::vector<uint8_t>& payload)
+    {
+        appendBigEndian (png, static_cast<uint32_t> (payload.size()));
+        const size_t typeStart = png.size();
+        png.insert (png.end(), type, type + 4);
+        png.insert (png.end(), payload.begin(), payload.end());
+        appendBigEndian (png, crc32 (png.data() + typeStart, png.size() - typeStart));
+    }
+
+    const uint8_t signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    const uint8_t zlibHeader[] = { 0x78, 0x01 };
+
+    std::vector<uint8_t> makeHeader (const int width, const int height)
+    {
+        std::vector<uint8_t> header;
+        appendBigEndian (header, static_cast<uint32_t> (width));
+        appendBigEndian (header, static_cast<uint32_t> (height));
+        header.insert (header.end(), { 8, 2, 0, 0, 0 });  // 8-bit RGB, no interlacing
+        return header;
+    }
+}
+
+//==============================================================================
+std::vector<uint8_t> encodePng (const int width, const int height, const uint32_t* pixels) {
+    const auto raw = toScanlines (width, height, pixels);
+
+    // A zlib stream holding one deflate block
+    std::vector<uint8_t> compressed (std::begin (zlibHeader), std::end (zlibHeader));
+    deflate (raw, true, compressed);
+    appendBigEndian (compressed, adler32 (raw.data(), raw.size()));
+
+    std::vector<uint8_t> png (std::begin (signature), std::end (signature));
+    appendChunk (png, "IHDR", makeHeader (width, height));
+    appendChunk (png, "IDAT", compressed);
+    appendChunk (png, "IEND", {});
+    return png;
+}
+
+bool writePng (const std::string& path, const int width, const int height, const uint32_t* pixels) {
+    const auto png = encodePng (width, height, pixels);
+
+    auto* file = std::fopen (path.c_str(), "wb");
+    if (file == nullptr)
+        return false;
+
+    const bool wroteAll = std::fwrite (png.data(), 1, png.size(), file) == png.size();
+    return std::fclose (file) == 0 && wroteAll;
+}
+
+//==============================================================================
+PngStreamWriter::Band PngStreamWriter::encodeBand (const int width, const int numRows,
+                                                   const uint32_t* pixels, const bool isLast) {
+    const auto raw = toScanlines (width, numRows, pixels);
+
+    Band band;
+    deflate (raw, isLast, band.deflated);
+    band.adler = adler32 (raw.data(), raw.size());
+    band.numRawBytes = raw.size();
+    return band;
+}
+
+PngStreamWriter::PngStreamWriter (const std::string& path, const int width, const int height)
+    : m_numRawBytes (static_cast<size_t> (height) * (static_cast<size_t> (width) * 3 + 1)) {
+    m_file = std::fopen (path.c_str(), "wb");
+    if (m_file == nullptr)
+        return;
+
+    const auto header = makeHeader (width, height);
+    m_hasFailed = std::fwrite (signature, 1, sizeof (signature), m_file) != sizeof (signature);
+    writeChunk ("IHDR", header.data(), header.size());
+
+    // The zlib header goes in an IDAT of its own, and the bands follow it
+    writeChunk ("IDAT", zlibHeader, sizeof (zlibHeader));
+}
+
+PngStreamWriter::~PngStreamWriter() {
+    if (m_file != nullptr)
+        std::fclose (m_file);
+}
+
+bool PngStreamWriter::writeChunk (const char* type, const uint8_t* data, const size_t size) {
+    auto toBigEndian = [] (uint8_t* bytes, const uint32_t value)
+    {
+        for (int i = 0; i < 4; i++)
+            bytes[i] = static_cast<uint8_t> (value >> (24 - 8 * i));
+    };
+
+    uint8_t prefix[8], checksum[4];
+    toBigEndian (prefix, static_cast<uint32_t> (size));
+    std::copy_n (type, 4, prefix + 4);
+    toBigEndian (checksum, crc32 (data, size, crc32 (prefix + 4, 4)));
+
+    m_hasFailed = m_hasFailed
+               || std::fwrite (prefix, 1, sizeof (prefix), m_file) != sizeof (prefix)
+               || (size > 0 && std::fwrite (data, 1, size, m_file) != size)
+               || std::fwrite (checksum, 1, sizeof (checksum), m_file) != sizeof (checksum);
+    return ! m_hasFailed;
+}
+
+bool PngStreamWriter::writeBand (const Band& band) {
+    if (m_file == nullptr)
+        return false;
+
+    m_adler = combineAdler32 (m_adler, band.adler, band.numRawBytes);
+    m_numBytesWritten += band.numRawBytes;
+    return writeChunk ("IDAT", band.deflated.data(), band.deflated.size());
+}
+
+bool PngStreamWriter::finish() {
+    if (m_file == nullptr)
+        return false;
+
+    const uint8_t checksum[] = { static_cast<uint8_t> (m_adler >> 24), static_cast<uint8_t> (m_adler >> 16),
+                                 static_cast<uint8_t> (m_adler >> 8), static_cast<uint8_t> (m_adler) };
+    writeChunk ("IDAT", checksum, sizeof (checksum));
+    writeChunk ("IEND", nullptr, 0);
+
+    const bool closed = std::fclose (m_file) == 0;
+    m_file = nullptr;
+    return closed && ! m_hasFailed && m_numBytesWritten == m_numRawBytes;
+}
@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    PngWriter.h
+    Created: 19 Oct 2026 2:47:31pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+//==============================================================================
+/*
+    A small PNG encoder so the headless tools need no image library. Pixels
+    are 0xAARRGGBB like the palette's colours and are written as 8-bit RGB.
+    The deflate stream uses the fixed Huffman codes with a greedy LZ77
+    match search, which does well on the large flat areas of a fractal.
+*/
+std::vector<uint8_t> encodePng (const int width, const int height, const uint32_t* pixels);
+
+/*  Returns false if the file could not be written. */
+bool writePng (const std::string& path, const int width, const int height, const uint32_t* pixels);
+
+//==============================================================================
+/*
+    Writes a PNG a band of rows at a time, for images too big to hold in
+    memory. Each band is deflated on its own by encodeBand(), which any
+    thread can call in any order; the writer only has to be given the bands
+    top to bottom. Splitting the stream costs a few bytes per band, plus the
+    matches that would have reached back into the band before.
+*/
+class PngStreamWriter
+{
+public:
+    struct Band
+    {
+        std::vector<uint8_t> deflated;
+        uint32_t adler { 1 };
+        size_t numRawBytes { 0 };
+    };
+
+    // Rows of 0xAARRGGBB pixels; the band that ends the image must say so
+    static Band encodeBand (const int width, const int numRows, const uint32_t* pixels, const bool isLast);
+
+    // Creates the file and writes the header; check isOpen()
+    PngStreamWriter (const std::string& path, const int width, const int height);
+    ~PngStreamWriter();
+
+    bool isOpen() const noexcept    { return m_file != nullptr; }
+
+    bool writeBand (const Band& band);
+
+    /*  Ends the image and closes the file. Returns false if anything failed
+        to write, or the bands didn't add up to the whole image.
+    */
+    bool finish();
+
+private:
+    bool writeChunk (const char* type, const uint8_t* data, const size_t size);
+
+    std::FILE* m_file { nullptr };
+    const size_t m_numRawBytes;
+    size_t m_numBytesWritten { 0 };
+    uint32_t m_adler { 1 };
+    bool m_hasFailed { false };
+};
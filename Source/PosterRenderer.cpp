@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+    PosterRenderer.cpp
+    Created: 23 Oct 2026 2:21:37pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "PosterRenderer.h"
+#include "FrameRenderer.h"
+#include "IterationBuffer.h"
+#include "PngWriter.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static constexpr int64_t pixelsPerStrip = int64_t {1} << 20;
+static constexpr int previewSize = 1024;
+
+/*  Histogram colours need the counts of the whole frame, so they come from
+    a copy of it small enough to render in memory.
+*/
+static void buildPalette (Palette& palette, const FractalParams& params, const PosterOptions& options) {
+    if (! palette.needsWholeFrame())
+    {
+        palette.build (params.minIterations, params.maxIterations);
+        return;
+    }
+
+    const double scale = std::min (1.0, previewSize / static_cast<double> (std::max (params.width, params.height)));
+    auto preview = params;
+    preview.width = std::max (1, static_cast<int> (params.width * scale));
+    preview.height = std::max (1, static_cast<int> (params.height * scale));
+    preview.pixelSize = params.pixelSize * params.width / preview.width;
+
+    FrameOptions frameOptions;
+    frameOptions.numThreads = options.numThreads;
+    frameOptions.simdLevel = options.simdLevel;
+
+    IterationBuffer iterations (preview.width, preview.height);
+    renderFrame (preview, iterations, frameOptions);
+    palette.build (params.minIterations, params.maxIterations, &iterations);
+}
+
+bool renderPoster (const FractalParams& params, Palette palette, const std::string& path,
+                   const PosterOptions& options) {
+    if (params.width <= 0 || params.height <= 0)
+        return false;
+
+    buildPalette (palette, params, options);
+
+    const int width = params.width;
+    const int stripHeight = options.stripHeight > 0
+                          ? std::min (options.stripHeight, params.height)
+                          : static_cast<int> (std::clamp<int64_t> (pixelsPerStrip / width, 1, params.height));
+    const int numStrips = (params.height + stripHeight - 1) / stripHeight;
+
+    int numThreads = options.numThreads > 0 ? options.numThreads
+                                            : static_cast<int> (std::thread::hardware_concurrency());
+    numThreads = std::clamp (numThreads, 1, numStrips);
+
+    // Enough that a slow strip doesn't leave the other threads idle
+    const int maxStripsAhead = 2 * numThreads + 2;
+
+    PngStreamWriter writer (path, width, params.height);
+    if (! writer.isOpen())
+        return false;
+
+    // Finished strips wait in a ring indexed by strip % maxStripsAhead
+    std::mutex lock;
+    std::condition_variable changed;
+    std::vector<PngStreamWriter::Band> bands (static_cast<size_t> (maxStripsAhead));
+    std::vector<bool> isReady (static_cast<size_t> (maxStripsAhead), false);
+    int nextStrip = 0, numWritten = 0;
+    std::atomic<bool> shouldStop { false };
+
+    auto renderStrips = [&]
+    {
+        std::vector<int> counts (static_cast<size_t> (width));
+        std::vector<float> magnitudes (static_cast<size_t> (width));
+        std::vector<uint32_t> pixels;
+
+        for (;;)
+        {
+            int strip = 0;
+            {
+                std::unique_lock<std::mutex> held (lock);
+                changed.wait (held, [&] { return shouldStop || nextStrip >= numStrips
+                                                 || nextStrip < numWritten + maxStripsAhead; });
+                if (shouldStop || nextStrip >= numStrips)
+                    return;
+                strip = nextStrip++;
+            }
+
+            const int firstRow = strip * stripHeight;
+            const int numRows = std::min (stripHeight, params.height - firstRow);
+            pixels.resize (static_cast<size_t> (width) * static_cast<size_t> (numRows));
+
+            for (int row = 0; row < numRows; row++)
+            {
+                if (shouldStop)
+                    return;
+
+                calcIterationsRow (params, firstRow + row, 0, width, { counts.data(), magnitudes.data() },
+                                   1, options.simdLevel);
+
+                auto* line = pixels.data() + static_cast<size_t> (row) * static_cast<size_t> (width);
+                for (size_t ptX = 0; ptX < counts.size(); ptX++)
+                    line[ptX] = palette.getColour (counts[ptX], magnitudes[ptX]);
+            }
+
+            auto band = PngStreamWriter::encodeBand (width, numRows, pixels.data(), strip == numStrips - 1);
+            {
+                const std::lock_guard<std::mutex> held (lock);
+                bands[static_cast<size_t> (strip % maxStripsAhead)] = std::move (band);
+                isReady[static_cast<size_t> (strip % maxStripsAhead)] = true;
+            }
+            changed.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < numThreads; i++)
+        threads.emplace_back (renderStrips);
+
+    // This thread only writes, in order, as the strips come in
+    bool isComplete = true;
+
+    for (int strip = 0; strip < numStrips && isComplete; strip++)
+    {
+        const auto slot = static_cast<size_t> (strip % maxStripsAhead);
+        PngStreamWriter::Band band;
+        {
+            std::unique_lock<std::mutex> held (lock);
+            changed.wait (held, [&] { return isReady[slot]; });
+            band = std::move (bands[slot]);
+            isReady[slot] = false;
+            numWritten = strip + 1;
+        }
+        changed.notify_all();
+
+        const int rowsWritten = std::min (params.height, (strip + 1) * stripHeight);
+        isComplete = writer.writeBand (band)
+                  && (options.onProgress == nullptr || options.onProgress (rowsWritten));
+    }
+
+    {
+        const std::lock_guard<std::mutex> held (lock);
+        shouldStop = true;
+    }
+    changed.notify_all();
+
+    for (auto& thread : threads)
+        thread.join();
+
+    isComplete = writer.finish() && isComplete;
+    if (! isComplete)
+        std::remove (path.c_str());
+    return isComplete;
+}
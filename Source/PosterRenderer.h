@@ -0,0 +1,52 @@
+/*
+  ==============================================================================
+
+    PosterRenderer.h
+    Created: 23 Oct 2026 2:21:37pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include "EscapeTime.h"
+#include "Palette.h"
+
+//==============================================================================
+/*
+    Renders a frame of any size straight to a PNG, for prints far bigger
+    than an image in memory could be.
+
+    The frame is split into strips of whole rows. Worker threads each take
+    the next strip, iterate and colour it a row at a time and deflate it, so
+    the one thread writing the file only copies finished bytes out in order.
+    Workers run at most two strips per thread past the one being written,
+    which bounds the memory at a few strips whatever the size of the frame.
+
+    Every pixel is iterated, as neither mirroring nor subdivision can work
+    across strips. Histogram colouring equalizes over a preview of the frame
+    about a thousand pixels across, since the full counts are never all in
+    memory at once.
+*/
+struct PosterOptions
+{
+    // 0 means one thread per hardware thread
+    int numThreads { 0 };
+
+    // Rows per strip; 0 picks about a million pixels' worth
+    int stripHeight { 0 };
+
+    SimdLevel simdLevel { getSimdLevel() };
+
+    // Called on the calling thread as strips are written; returning false stops the render
+    std::function<bool (int rowsWritten)> onProgress;
+};
+
+/*  Returns false if the file couldn't be written or onProgress stopped the
+    render, in which case the partial file is removed.
+*/
+bool renderPoster (const FractalParams& params, Palette palette, const std::string& path,
+                   const PosterOptions& options = {});
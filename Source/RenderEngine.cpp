@@ -0,0 +1,1098 @@
+/*
+  ==============================================================================
+
+    RenderEngine.cpp
+    Created: 17 Oct 2026 9:20:41am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "RenderEngine.h"
+
+//==============================================================================
+/*
+    The palette converted to the pixel layouts a juce::Image can have, so the
+    colour pass can copy entries straight into the bitmap rows.
+*/
+struct PixelLut
+{
+    explicit PixelLut (const Palette& palette)
+        : colours (palette), argb (convert<juce::PixelARGB> (palette.getColours())),
+          rgb (convert<juce::PixelRGB> (palette.getColours())),
+          gradientArgb (convert<juce::PixelARGB> (palette.getGradient())),
+          gradientRgb (convert<juce::PixelRGB> (palette.getGradient())) {}
+
+    template <typename PixelType>
+    static std::vector<PixelType> convert (const std::vector<uint32_t>& colours)
+    {
+        std::vector<PixelType> pixels (colours.size());
+        for (size_t i = 0; i < colours.size(); i++)
+            pixels[i].set (juce::Colour (colours[i]).getPixelARGB());
+        return pixels;
+    }
+
+    const std::vector<juce::PixelARGB>& table (juce::PixelARGB*) const noexcept     { return argb; }
+    const std::vector<juce::PixelRGB>& table (juce::PixelRGB*) const noexcept       { return rgb; }
+    const std::vector<juce::PixelARGB>& gradient (juce::PixelARGB*) const noexcept  { return gradientArgb; }
+    const std::vector<juce::PixelRGB>& gradient (juce::PixelRGB*) const noexcept    { return gradientRgb; }
+
+    const Palette colours;
+    const std::vector<juce::PixelARGB> argb;
+    const std::vector<juce::PixelRGB> rgb;
+    const std::vector<juce::PixelARGB> gradientArgb;
+    const std::vector<juce::PixelRGB> gradientRgb;
+};
+
+/*  The colour pass: one linear walk over the iteration buffer for the given
+    area, writing into a bitmap whose origin is the area's top-left corner.
+*/
+template <typename PixelType>
+static void colourArea (const IterationBuffer& iterations, const PixelLut& lut,
+                        const juce::Image::BitmapData& bitmap, const juce::Rectangle<int>& area) {
+    jassert (bitmap.pixelStride == sizeof (PixelType));
+
+    const auto& table = lut.table (static_cast<PixelType*> (nullptr));
+    const auto& gradient = lut.gradient (static_cast<PixelType*> (nullptr));
+    const int minIterations = lut.colours.getMinIterations();
+    const bool isSmooth = lut.colours.usesMagnitude();
+
+    for (int ptY = 0; ptY < area.getHeight(); ptY++)
+    {
+        auto* line = reinterpret_cast<PixelType*> (bitmap.getLinePointer (ptY));
+        const int* counts = iterations.getCounts (area.getY() + ptY) + area.getX();
+        const float* magnitudes = iterations.getMagnitudes (area.getY() + ptY) + area.getX();
+
+        if (isSmooth)
+        {
+            for (int ptX = 0; ptX < area.getWidth(); ptX++)
+                line[ptX] = gradient[static_cast<size_t> (lut.colours.getSmoothIndex (counts[ptX], magnitudes[ptX]))];
+        }
+        else
+        {
+            for (int ptX = 0; ptX < area.getWidth(); ptX++)
+                line[ptX] = table[static_cast<size_t> (counts[ptX] - minIterations)];
+        }
+    }
+}
+
+static void colourArea (const IterationBuffer& iterations, const PixelLut& lut,
+                        const juce::Image::BitmapData& bitmap, const juce::Rectangle<int>& area) {
+    if (bitmap.pixelFormat == juce::Image::ARGB)
+        colourArea<juce::PixelARGB> (iterations, lut, bitmap, area);
+    else
+        colourArea<juce::PixelRGB> (iterations, lut, bitmap, area);
+}
+
+/*  Colours the part of a tile that is inside the image, which may be all of
+    it, and returns that part.
+*/
+static juce::Rectangle<int> colourTile (const IterationBuffer& iterations, const PixelLut& lut,
+                                        juce::Image& image, const juce::Rectangle<int>& tile) {
+    const auto area = tile.getIntersection (image.getBounds());
+    if (area.isEmpty())
+        return area;
+
+    juce::Image::BitmapData bitmap (image, area.getX(), area.getY(), area.getWidth(), area.getHeight(),
+                                    juce::Image::BitmapData::writeOnly);
+    colourArea (iterations, lut, bitmap, area);
+    return area;
+}
+
+/*  Colours a region's edge pixels inside area with the average of their
+    samples, over whatever colourArea() gave them.
+*/
+static void colourEdges (const EdgeSamples& samples, const int region, const PixelLut& lut,
+                         juce::Image& image, const juce::Rectangle<int>& area) {
+    const auto& pixels = samples.getPixels (region);
+    const auto clipped = area.getIntersection (image.getBounds());
+    if (pixels.empty() || clipped.isEmpty())
+        return;
+
+    juce::Image::BitmapData bitmap (image, clipped.getX(), clipped.getY(), clipped.getWidth(), clipped.getHeight(),
+                                    juce::Image::BitmapData::writeOnly);
+
+    for (size_t index = 0; index < pixels.size(); index++)
+        if (clipped.contains (pixels[index].x, pixels[index].y))
+            bitmap.setPixelColour (pixels[index].x - clipped.getX(), pixels[index].y - clipped.getY(),
+                                   juce::Colour (samples.getColour (lut.colours, region, index)));
+}
+
+// Copies area of one image into another of the same size and format
+static void copyPixels (const juce::Image& source, juce::Image& target, const juce::Rectangle<int>& area) {
+    const juce::Image::BitmapData src (source, juce::Image::BitmapData::readOnly);
+    juce::Image::BitmapData dst (target, juce::Image::BitmapData::writeOnly);
+
+    for (int ptY = area.getY(); ptY < area.getBottom(); ptY++)
+        memcpy (dst.getPixelPointer (area.getX(), ptY),
+                src.getPixelPointer (area.getX(), ptY),
+                static_cast<size_t> (area.getWidth() * src.pixelStride));
+}
+
+static PixelArea toPixelArea (const juce::Rectangle<int>& area) noexcept {
+    return { area.getX(), area.getY(), area.getWidth(), area.getHeight() };
+}
+
+static juce::Rectangle<int> toRectangle (const PixelArea& area) noexcept {
+    return { area.x, area.y, area.width, area.height };
+}
+
+/*  Copies the parts of a frame a job iterated to the pixels that mirror
+    them, then colours both and returns every area of the image that changed.
+*/
+static juce::RectangleList<int> mirrorAndColour (const SymmetryPlan& symmetry, IterationBuffer& iterations,
+                                                 const PixelLut& lut, juce::Image& image,
+                                                 const std::vector<juce::Rectangle<int>>& parts) {
+    juce::RectangleList<int> changed;
+
+    for (const auto& part : parts)
+    {
+        const auto mirror = mirrorArea (symmetry, iterations, toPixelArea (part));
+        changed.add (colourTile (iterations, lut, image, part));
+
+        if (! mirror.isEmpty())
+            changed.add (colourTile (iterations, lut, image, toRectangle (mirror)));
+    }
+    return changed;
+}
+
+/*  The parts of a tile that aren't copies of other pixels. */
+static std::vector<juce::Rectangle<int>> getUniqueParts (const SymmetryPlan& symmetry, const juce::Rectangle<int>& area) {
+    std::vector<juce::Rectangle<int>> parts;
+    for (const auto& part : symmetry.getUniqueParts (toPixelArea (area)))
+        parts.push_back (toRectangle (part));
+    return parts;
+}
+
+/*  Records the pixels a tile's job produced and the iterations they took,
+    leaving out the mirror images it copied them to.
+*/
+static void addTileStats (RenderStats& stats, const int frame, const int tile, const IterationBuffer& iterations,
+                          const std::vector<juce::Rectangle<int>>& parts, const int maxIterations) {
+    int64_t numPixels = 0, numIterations = 0;
+
+    for (const auto& part : parts)
+    {
+        numPixels += static_cast<int64_t> (part.getWidth()) * part.getHeight();
+        numIterations += countIterations (iterations, toPixelArea (part), maxIterations);
+    }
+    stats.addTile (frame, tile, numPixels, numIterations);
+}
+
+/*  Copies a block of counts and magnitudes between buffers, each addressed
+    in its own coordinates.
+*/
+static void copyBlock (const IterationBuffer& source, const juce::Point<int> sourcePosition,
+                       IterationBuffer& destination, const juce::Point<int> destinationPosition,
+                       const int width, const int height) {
+    const auto numPixels = static_cast<size_t> (width);
+
+    for (int row = 0; row < height; row++)
+    {
+        const int sourceY = sourcePosition.getY() + row;
+        const int destinationY = destinationPosition.getY() + row;
+        std::copy_n (source.getCounts (sourceY) + sourcePosition.getX(), numPixels,
+                     destination.getCounts (destinationY) + destinationPosition.getX());
+        std::copy_n (source.getMagnitudes (sourceY) + sourcePosition.getX(), numPixels,
+                     destination.getMagnitudes (destinationY) + destinationPosition.getX());
+    }
+}
+
+/*  A frame's tile as the cache keeps it: a buffer of its own, with the
+    tile's pending orbits moved to its coordinates.
+*/
+static std::shared_ptr<const IterationBuffer> copyTile (const IterationBuffer& frame, const int region,
+                                                        const juce::Rectangle<int>& area) {
+    auto tile = std::make_shared<IterationBuffer> (area.getWidth(), area.getHeight());
+    copyBlock (frame, area.getPosition(), *tile, {}, area.getWidth(), area.getHeight());
+
+    auto& pending = tile->getPendingOrbits (0);
+    pending = frame.getPendingOrbits (region);
+    for (auto& orbit : pending)
+    {
+        orbit.x -= area.getX();
+        orbit.y -= area.getY();
+    }
+    return tile;
+}
+
+/*  The inverse of copyTile(). */
+static void pasteTile (const IterationBuffer& tile, IterationBuffer& frame, const int region,
+                       const juce::Rectangle<int>& area) {
+    copyBlock (tile, {}, frame, area.getPosition(), area.getWidth(), area.getHeight());
+
+    auto& pending = frame.getPendingOrbits (region);
+    pending = tile.getPendingOrbits (0);
+    for (auto& orbit : pending)
+    {
+        orbit.x += area.getX();
+        orbit.y += area.getY();
+    }
+}
+
+/*  Only the batch kernels leave a final z to carry on from. A double-double
+    orbit would need its low parts too, and a perturbed one its offset and
+    a longer reference.
+*/
+static bool canResume (const FractalParams& params) noexcept {
+    return params.precision == Precision::float32 || params.precision == Precision::float64;
+}
+
+//==============================================================================
+class RenderEngine::TileJob : public juce::ThreadPoolJob
+{
+public:
+    TileJob (RenderEngine& owner, const FractalParams& params,
+             std::shared_ptr<IterationBuffer> iterations,
+             std::shared_ptr<const PixelLut> lut, juce::Image image,
+             const int tile, juce::Rectangle<int> area, std::vector<juce::Rectangle<int>> parts,
+             const SymmetryPlan& symmetry, const int generation, const int frame, const int coarsestStep,
+             TileCache* cache, const TileCache::Key& cacheKey)
+        : juce::ThreadPoolJob ("Fractal tile"),
+          m_owner (owner), m_params (params), m_iterations (std::move (iterations)),
+          m_lut (std::move (lut)), m_image (image), m_tile (tile),
+          m_area (area), m_parts (std::move (parts)), m_symmetry (symmetry),
+          m_generation (generation), m_frame (frame), m_coarsestStep (coarsestStep), m_step (coarsestStep),
+          m_cache (cache), m_cacheKey (cacheKey) {}
+
+    /*  Each call renders one pass of the tile. A pass with step s computes the
+        pixels on the s-grid that no earlier pass has computed and fills the
+        s x s block below and to the right of each one. Returning
+        jobNeedsRunningAgain sends the tile to the back of the pool's queue, so
+        every tile gets its coarse pass before any tile is refined.
+
+        Only the parts of the tile that mirror nothing are iterated; each pass
+        copies them to their mirror images as well.
+    */
+    JobStatus runJob() override
+    {
+        auto& stats = m_owner.m_stats;
+        const auto started = RenderStats::Clock::now();
+
+        for (const auto& part : m_parts)
+        {
+            if (! iteratePass (part))
+            {
+                stats.addEvent (m_frame, RenderStage::iterate, m_tile, started, RenderStats::Clock::now());
+                return jobHasFinished;
+            }
+        }
+
+        const bool isFinalPass = m_step == 1;
+
+        if (isFinalPass && m_cache != nullptr)
+            m_cache->store (m_cacheKey, copyTile (*m_iterations, m_tile, m_area));
+
+        const auto iterated = RenderStats::Clock::now();
+        stats.addEvent (m_frame, RenderStage::iterate, m_tile, started, iterated);
+
+        auto changed = mirrorAndColour (m_symmetry, *m_iterations, *m_lut, m_image, m_parts);
+        stats.addEvent (m_frame, RenderStage::colour, m_tile, iterated, RenderStats::Clock::now());
+
+        if (isFinalPass)
+            addTileStats (stats, m_frame, m_tile, *m_iterations, m_parts, m_params.maxIterations);
+
+        m_owner.tileFinished (changed, m_generation, isFinalPass);
+
+        if (isFinalPass)
+            return jobHasFinished;
+
+        m_step /= 2;
+        return jobNeedsRunningAgain;
+    }
+
+private:
+    bool iteratePass (const juce::Rectangle<int>& area)
+    {
+        auto& iterations = *m_iterations;
+
+        for (int ptY = area.getY(); ptY < area.getBottom(); ptY += m_step)
+        {
+            if (shouldExit() || ! m_owner.isCurrent (m_generation))
+                return false;
+
+            // Rows on the previous pass's grid already have every other sample
+            const bool rowHasSamples = m_step < m_coarsestStep && (ptY - area.getY()) % (m_step * 2) == 0;
+            const int firstX = area.getX() + (rowHasSamples ? m_step : 0);
+            const int xStep = rowHasSamples ? m_step * 2 : m_step;
+
+            if (firstX >= area.getRight())
+                continue;
+
+            const int numPixels = (area.getRight() - firstX + xStep - 1) / xStep;
+
+            m_rowRe.resize (static_cast<size_t> (numPixels));
+            m_rowIm.resize (static_cast<size_t> (numPixels));
+
+            if (xStep == 1)
+            {
+                calcIterationsRow (m_params, ptY, firstX, numPixels,
+                                   { iterations.getCounts (ptY) + firstX,
+                                     iterations.getMagnitudes (ptY) + firstX,
+                                     m_rowRe.data(), m_rowIm.data() });
+                keepPendingOrbits (ptY, firstX, xStep, numPixels);
+                continue;
+            }
+
+            m_rowCounts.resize (static_cast<size_t> (numPixels));
+            m_rowMagnitudes.resize (static_cast<size_t> (numPixels));
+            calcIterationsRow (m_params, ptY, firstX, numPixels,
+                               { m_rowCounts.data(), m_rowMagnitudes.data(),
+                                 m_rowRe.data(), m_rowIm.data() }, xStep);
+
+            const int blockHeight = juce::jmin (m_step, area.getBottom() - ptY);
+
+            for (int i = 0; i < numPixels; i++)
+            {
+                const int ptX = firstX + i * xStep;
+                iterations.getCounts (ptY)[ptX] = m_rowCounts[static_cast<size_t> (i)];
+                iterations.getMagnitudes (ptY)[ptX] = m_rowMagnitudes[static_cast<size_t> (i)];
+                iterations.fillBlock (ptX, ptY, juce::jmin (m_step, area.getRight() - ptX), blockHeight);
+            }
+            keepPendingOrbits (ptY, firstX, xStep, numPixels);
+        }
+        return true;
+    }
+
+    // Every pixel is computed by exactly one pass, which is the one that
+    // remembers where its orbit stopped if it never escaped
+    void keepPendingOrbits (const int ptY, const int firstX, const int xStep, const int numPixels)
+    {
+        // deepen() can't resume the deep tiers, see RenderEngine::deepen()
+        if (! canResume (m_params))
+            return;
+
+        const int* counts = m_iterations->getCounts (ptY);
+        auto& pending = m_iterations->getPendingOrbits (m_tile);
+
+        for (int i = 0; i < numPixels; i++)
+        {
+            const int ptX = firstX + i * xStep;
+            if (counts[ptX] > m_params.maxIterations)
+                pending.push_back ({ ptX, ptY, m_rowRe[static_cast<size_t> (i)], m_rowIm[static_cast<size_t> (i)] });
+        }
+    }
+
+    RenderEngine& m_owner;
+    const FractalParams m_params;
+    const std::shared_ptr<IterationBuffer> m_iterations;
+    const std::shared_ptr<const PixelLut> m_lut;
+    juce::Image m_image;
+    const int m_tile;
+    const juce::Rectangle<int> m_area;
+    const std::vector<juce::Rectangle<int>> m_parts;
+    const SymmetryPlan m_symmetry;
+    const int m_generation;
+    const int m_frame;
+    const int m_coarsestStep;
+    int m_step;
+    TileCache* const m_cache;
+    const TileCache::Key m_cacheKey;
+    std::vector<int> m_rowCounts;
+    std::vector<float> m_rowMagnitudes;
+    std::vector<double> m_rowRe, m_rowIm;
+};
+
+//==============================================================================
+/*
+    Continues a finished tile's undecided orbits from the old iteration limit
+    to a higher one, then recolours the tile. Resuming at n = old limit + 1
+    from the stored z takes exactly the steps a fresh render would, so the
+    counts come out the same; only the pixels that were still undecided cost
+    anything.
+*/
+class RenderEngine::DeepenJob : public juce::ThreadPoolJob
+{
+public:
+    DeepenJob (RenderEngine& owner, const FractalParams& params,
+               std::shared_ptr<IterationBuffer> iterations,
+               std::shared_ptr<const PixelLut> lut, juce::Image image,
+               const int tile, juce::Rectangle<int> area, const int generation, const int frame,
+               const int previousMaxIterations, TileCache* cache, const TileCache::Key& cacheKey)
+        : juce::ThreadPoolJob ("Fractal deepen"),
+          m_owner (owner), m_params (params), m_iterations (std::move (iterations)),
+          m_lut (std::move (lut)), m_image (image), m_tile (tile),
+          m_area (area), m_generation (generation), m_frame (frame),
+          m_previousMaxIterations (previousMaxIterations),
+          m_cache (cache), m_cacheKey (cacheKey) {}
+
+    JobStatus runJob() override
+    {
+        auto& stats = m_owner.m_stats;
+        const auto started = RenderStats::Clock::now();
+
+        auto& iterations = *m_iterations;
+        auto& pending = iterations.getPendingOrbits (m_tile);
+        const bool isJulia = m_params.type == FractalType::julia;
+        const auto numPending = static_cast<int64_t> (pending.size());
+        int64_t numIterations = 0;
+
+        constexpr int chunkSize = 64;
+        double zRe[chunkSize], zIm[chunkSize], cRe[chunkSize], cIm[chunkSize];
+        double finalRe[chunkSize], finalIm[chunkSize];
+        int counts[chunkSize];
+        float magnitudes[chunkSize];
+
+        size_t numKept = 0;
+
+        for (size_t start = 0; start < pending.size(); start += chunkSize)
+        {
+            if (shouldExit() || ! m_owner.isCurrent (m_generation))
+            {
+                stats.addEvent (m_frame, RenderStage::iterate, m_tile, started, RenderStats::Clock::now());
+                return jobHasFinished;
+            }
+
+            const int numOrbits = static_cast<int> (juce::jmin (pending.size() - start, static_cast<size_t> (chunkSize)));
+
+            for (int i = 0; i < numOrbits; i++)
+            {
+                const auto& orbit = pending[start + static_cast<size_t> (i)];
+                zRe[i] = orbit.re;
+                zIm[i] = orbit.im;
+                cRe[i] = isJulia ? m_params.cRe : m_params.mathX (orbit.x);
+                cIm[i] = isJulia ? m_params.cIm : m_params.mathY (orbit.y);
+            }
+
+            OrbitBatch batch;
+            batch.numOrbits = numOrbits;
+            batch.firstIteration = m_previousMaxIterations + 1;
+            batch.formula = m_params.formula;
+            batch.isMandelbrot = ! isJulia;
+            batch.useFloats = m_params.precision == Precision::float32;
+            batch.zRe = zRe;
+            batch.zIm = zIm;
+            batch.cRe = cRe;
+            batch.cIm = cIm;
+            batch.results = { counts, magnitudes, finalRe, finalIm };
+            iterateOrbits (batch, m_params.maxIterations);
+
+            for (int i = 0; i < numOrbits; i++)
+            {
+                auto orbit = pending[start + static_cast<size_t> (i)];
+                iterations.getCounts (orbit.y)[orbit.x] = counts[i];
+                iterations.getMagnitudes (orbit.y)[orbit.x] = magnitudes[i];
+                numIterations += juce::jmin (counts[i], m_params.maxIterations) - m_previousMaxIterations;
+
+                if (counts[i] > m_params.maxIterations)
+                {
+                    orbit.re = finalRe[i];
+                    orbit.im = finalIm[i];
+                    pending[numKept++] = orbit;
+                }
+            }
+        }
+        pending.resize (numKept);
+
+        if (m_cache != nullptr)
+            m_cache->store (m_cacheKey, copyTile (iterations, m_tile, m_area));
+
+        const auto iterated = RenderStats::Clock::now();
+        stats.addEvent (m_frame, RenderStage::iterate, m_tile, started, iterated);
+
+        const juce::RectangleList<int> changed (colourTile (iterations, *m_lut, m_image, m_area));
+        stats.addEvent (m_frame, RenderStage::colour, m_tile, iterated, RenderStats::Clock::now());
+
+        // Only the orbits that were still undecided did any work
+        stats.addTile (m_frame, m_tile, numPending, numIterations);
+
+        m_owner.tileFinished (changed, m_generation, true);
+        return jobHasFinished;
+    }
+
+private:
+    RenderEngine& m_owner;
+    const FractalParams m_params;
+    const std::shared_ptr<IterationBuffer> m_iterations;
+    const std::shared_ptr<const PixelLut> m_lut;
+    juce::Image m_image;
+    const int m_tile;
+    const juce::Rectangle<int> m_area;
+    const int m_generation;
+    const int m_frame;
+    const int m_previousMaxIterations;
+    TileCache* const m_cache;
+    const TileCache::Key m_cacheKey;
+};
+
+//==============================================================================
+/*  Renders the unmirrored parts of one tile with subdivideArea() and
+    colours them and their mirror images in a single pass.
+*/
+class RenderEngine::SubdivisionJob : public juce::ThreadPoolJob
+{
+public:
+    SubdivisionJob (RenderEngine& owner, const FractalParams& params,
+                    std::shared_ptr<IterationBuffer> iterations,
+                    std::shared_ptr<const PixelLut> lut, juce::Image image,
+                    const int tile, std::vector<juce::Rectangle<int>> parts, const SymmetryPlan& symmetry,
+                    const int generation, const int frame, const int fillableBelow)
+        : juce::ThreadPoolJob ("Fractal subdivision"),
+          m_owner (owner), m_params (params), m_iterations (std::move (iterations)),
+          m_lut (std::move (lut)), m_image (image), m_tile (tile),
+          m_parts (std::move (parts)), m_symmetry (symmetry),
+          m_generation (generation), m_frame (frame), m_fillableBelow (fillableBelow) {}
+
+    JobStatus runJob() override
+    {
+        auto& stats = m_owner.m_stats;
+        const auto started = RenderStats::Clock::now();
+        auto shouldStop = [this] { return shouldExit() || ! m_owner.isCurrent (m_generation); };
+
+        for (const auto& part : m_parts)
+        {
+            if (! subdivideArea (m_params, *m_iterations, part.getX(), part.getY(),
+                                 part.getWidth(), part.getHeight(), m_fillableBelow, shouldStop))
+            {
+                stats.addEvent (m_frame, RenderStage::iterate, m_tile, started, RenderStats::Clock::now());
+                return jobHasFinished;
+            }
+        }
+
+        const auto iterated = RenderStats::Clock::now();
+        stats.addEvent (m_frame, RenderStage::iterate, m_tile, started, iterated);
+
+        auto changed = mirrorAndColour (m_symmetry, *m_iterations, *m_lut, m_image, m_parts);
+        stats.addEvent (m_frame, RenderStage::colour, m_tile, iterated, RenderStats::Clock::now());
+
+        // Filled pixels count as if they had been iterated
+        addTileStats (stats, m_frame, m_tile, *m_iterations, m_parts, m_params.maxIterations);
+
+        m_owner.tileFinished (changed, m_generation, true);
+        return jobHasFinished;
+    }
+
+private:
+    RenderEngine& m_owner;
+    const FractalParams m_params;
+    const std::shared_ptr<IterationBuffer> m_iterations;
+    const std::shared_ptr<const PixelLut> m_lut;
+    juce::Image m_image;
+    const int m_tile;
+    const std::vector<juce::Rectangle<int>> m_parts;
+    const SymmetryPlan m_symmetry;
+    const int m_generation;
+    const int m_frame;
+    const int m_fillableBelow;
+};
+
+//==============================================================================
+/*  Samples the edge pixels of one tile of a finished frame and colours them.
+    The tile's neighbours are done too, so edges along its border are found
+    like any other.
+*/
+class RenderEngine::AntialiasJob : public juce::ThreadPoolJob
+{
+public:
+    AntialiasJob (RenderEngine& owner, const FractalParams& params,
+                  std::shared_ptr<const IterationBuffer> iterations, std::shared_ptr<EdgeSamples> samples,
+                  std::shared_ptr<const PixelLut> lut, juce::Image image,
+                  const int tile, juce::Rectangle<int> area, const int generation, const int frame)
+        : juce::ThreadPoolJob ("Fractal antialias"),
+          m_owner (owner), m_params (params), m_iterations (std::move (iterations)),
+          m_samples (std::move (samples)), m_lut (std::move (lut)), m_image (image), m_tile (tile),
+          m_area (area), m_generation (generation), m_frame (frame) {}
+
+    JobStatus runJob() override
+    {
+        auto& stats = m_owner.m_stats;
+        const auto started = RenderStats::Clock::now();
+        auto shouldStop = [this] { return shouldExit() || ! m_owner.isCurrent (m_generation); };
+
+        const bool isSampled = m_samples->sampleArea (m_params, *m_iterations, toPixelArea (m_area), m_tile, shouldStop);
+
+        const auto sampled = RenderStats::Clock::now();
+        stats.addEvent (m_frame, RenderStage::antialias, m_tile, started, sampled);
+        if (! isSampled)
+            return jobHasFinished;
+
+        colourEdges (*m_samples, m_tile, *m_lut, m_image, m_area);
+        stats.addEvent (m_frame, RenderStage::colour, m_tile, sampled, RenderStats::Clock::now());
+
+        m_owner.tileFinished (juce::RectangleList<int> (m_area), m_generation, true);
+        return jobHasFinished;
+    }
+
+private:
+    RenderEngine& m_owner;
+    const FractalParams m_params;
+    const std::shared_ptr<const IterationBuffer> m_iterations;
+    const std::shared_ptr<EdgeSamples> m_samples;
+    const std::shared_ptr<const PixelLut> m_lut;
+    juce::Image m_image;
+    const int m_tile;
+    const juce::Rectangle<int> m_area;
+    const int m_generation;
+    const int m_frame;
+};
+
+//==============================================================================
+RenderEngine::RenderEngine (const std::string& name)
+    : m_pool (juce::SystemStats::getNumCpus()), m_stats (name) {}
+
+RenderEngine::~RenderEngine() {
+    cancel();
+    m_pool.removeAllJobs (true, -1);
+}
+
+void RenderEngine::render (const FractalParams& params, juce::Image& target,
+                           const LatticePosition& position) {
+    cancel();
+
+    if (params.width <= 0 || params.height <= 0)
+        return;
+
+    m_frame = m_stats.beginFrame ("render", m_pool.getNumThreads());
+    m_position = position;
+    m_frameIsCached = position.anchor >= 0 && ! m_subdivide && m_tileCache.isEnabled();
+    m_gridOffset = {};
+
+    if (m_frameIsCached)
+        m_gridOffset = { static_cast<int> (juce::negativeAwareModulo<int64_t> (position.x, tileSize)),
+                         static_cast<int> (juce::negativeAwareModulo<int64_t> (position.y, tileSize)) };
+
+    // Stale jobs may still be writing into the old buffers for a moment,
+    // so every render gets fresh ones. A cached frame's buffer covers its
+    // edge tiles whole.
+    m_backBuffer = juce::Image (target.getFormat(), params.width, params.height, false);
+    m_target = &target;
+    m_params = params;
+
+    const int tilesAcross = (m_gridOffset.getX() + params.width + tileSize - 1) / tileSize;
+    const int tilesDown = (m_gridOffset.getY() + params.height + tileSize - 1) / tileSize;
+    m_iterations = m_frameIsCached
+                 ? std::make_shared<IterationBuffer> (tilesAcross * tileSize, tilesDown * tileSize, getNumTiles(),
+                                                      -m_gridOffset.getX(), -m_gridOffset.getY())
+                 : std::make_shared<IterationBuffer> (params.width, params.height, getNumTiles());
+    m_needsRecolour = false;
+    m_edgeSamples = nullptr;
+    m_needsAntialiasing = m_samplesPerEdgePixel > 0;
+
+    const int generation = m_generation.load();
+
+    m_palette.build (params.minIterations, params.maxIterations);
+    auto lut = std::make_shared<const PixelLut> (m_palette);
+
+    m_frameIsSubdivided = m_subdivide;
+    m_symmetry = planSymmetry (params);
+    m_needsMirroring = m_symmetry.isSymmetric();
+
+    // Every job is counted before any is started, so none can see the frame
+    // finish while the rest are still being added
+    std::vector<juce::ThreadPoolJob*> jobs;
+    bool hasCachedTiles = false;
+
+    if (m_subdivide)
+    {
+        // Smooth colours vary inside a band of equal counts, so only the
+        // interior can be filled for them
+        const int fillableBelow = m_palette.usesMagnitude() ? 0 : getFillableBelow (params);
+        m_frameHasFilledBands = fillableBelow > params.minIterations;
+
+        for (int tile = 0; tile < getNumTiles(); tile++)
+        {
+            auto parts = getUniqueParts (m_symmetry, getTileArea (tile));
+            if (! parts.empty())
+                jobs.push_back (new SubdivisionJob (*this, params, m_iterations, lut, m_backBuffer, tile,
+                                                    std::move (parts), m_symmetry, generation, m_frame, fillableBelow));
+        }
+    }
+    else
+    {
+        m_frameHasFilledBands = false;
+
+        // Tiles from the cache are ready now. They are pasted before any
+        // job could write next to them, then mirrored, so every mirrored
+        // pixel ends up a copy of its source even where both were cached.
+        // They go out with the first update rather than through the pool.
+        std::vector<bool> isCached (static_cast<size_t> (getNumTiles()), false);
+
+        for (int tile = 0; tile < getNumTiles(); tile++)
+        {
+            TileCache::Key key {};
+            auto* cache = getCacheFor (tile, key);
+
+            if (auto cached = cache != nullptr ? cache->find (key) : nullptr)
+            {
+                pasteTile (*cached, *m_iterations, tile, getTileArea (tile));
+                isCached[static_cast<size_t> (tile)] = true;
+                hasCachedTiles = true;
+            }
+        }
+
+        const auto colouringCached = RenderStats::Clock::now();
+        int numCached = 0;
+
+        for (int tile = 0; tile < getNumTiles(); tile++)
+        {
+            if (! isCached[static_cast<size_t> (tile)])
+                continue;
+
+            const auto changed = mirrorAndColour (m_symmetry, *m_iterations, *lut, m_backBuffer, { getTileArea (tile) });
+            numCached++;
+
+            const juce::ScopedLock sl (m_lock);
+            if (m_finishedTiles.isEmpty())
+                m_publishRequested = RenderStats::Clock::now();
+            m_finishedTiles.add (changed);
+        }
+
+        if (hasCachedTiles)
+        {
+            m_stats.addCachedTiles (m_frame, numCached);
+            m_stats.addEvent (m_frame, RenderStage::colour, -1, colouringCached, RenderStats::Clock::now());
+        }
+
+        for (int tile = 0; tile < getNumTiles(); tile++)
+        {
+            auto parts = getUniqueParts (m_symmetry, getTileArea (tile));
+            if (isCached[static_cast<size_t> (tile)] || parts.empty())
+                continue;
+
+            // A tile that gets mirrored pixels from others is only complete
+            // once the frame is, see finishMirroring()
+            TileCache::Key key {};
+            auto* cache = getCacheFor (tile, key);
+            if (! toPixelArea (getTileArea (tile)).getIntersection (m_symmetry.mirrored).isEmpty())
+                cache = nullptr;
+
+            jobs.push_back (new TileJob (*this, params, m_iterations, lut, m_backBuffer,
+                                         tile, getTileArea (tile), std::move (parts), m_symmetry,
+                                         generation, m_frame, m_coarsestStep, cache, key));
+        }
+    }
+
+    m_tilesPending = static_cast<int> (jobs.size());
+    for (auto* job : jobs)
+        m_pool.addJob (job, true);
+
+    if (jobs.empty())
+    {
+        const juce::ScopedLock sl (m_lock);
+        if (m_needsMirroring)
+            finishMirroring();
+        m_isResumable = true;
+    }
+
+    if (hasCachedTiles)
+        triggerAsyncUpdate();
+}
+
+bool RenderEngine::deepen (const int maxIterations) {
+    {
+        const juce::ScopedLock sl (m_lock);
+        if (! m_isResumable)
+            return false;
+    }
+
+    // Subdivision fills leave no orbits to continue
+    if (m_frameIsSubdivided || ! canResume (m_params))
+        return false;
+
+    if (maxIterations <= m_params.maxIterations || m_target == nullptr
+        || m_target->getBounds() != m_backBuffer.getBounds())
+        return false;
+
+    cancel();
+
+    // An antialias pass may still be colouring edges into the back buffer
+    // the deepen jobs reuse; cancelled jobs stop at their next check
+    m_pool.removeAllJobs (true, -1);
+
+    m_frame = m_stats.beginFrame ("deepen", m_pool.getNumThreads());
+    const int previousMaxIterations = m_params.maxIterations;
+    m_params.maxIterations = maxIterations;
+    m_needsRecolour = false;
+
+    // Edges move as the undecided pixels escape
+    m_edgeSamples = nullptr;
+    m_needsAntialiasing = m_samplesPerEdgePixel > 0;
+
+    const int generation = m_generation.load();
+
+    m_palette.build (m_params.minIterations, m_params.maxIterations);
+    auto lut = std::make_shared<const PixelLut> (m_palette);
+
+    m_tilesPending = getNumTiles();
+
+    for (int tile = 0; tile < getNumTiles(); tile++)
+    {
+        TileCache::Key key {};
+        auto* cache = getCacheFor (tile, key);
+
+        m_pool.addJob (new DeepenJob (*this, m_params, m_iterations, lut, m_backBuffer,
+                                      tile, getTileArea (tile), generation, m_frame,
+                                      previousMaxIterations, cache, key), true);
+    }
+    return true;
+}
+
+void RenderEngine::cancel() {
+    int numAbandoned = 0;
+    {
+        const juce::ScopedLock sl (m_lock);
+        m_generation++;
+        numAbandoned = m_tilesPending.exchange (0);
+        m_isResumable = false;
+        m_finishedTiles.clear();
+    }
+    m_pool.removeAllJobs (true, 0);
+
+    // Jobs still queued or running, whose work is thrown away
+    if (numAbandoned > 0)
+        m_stats.cancelFrame (m_frame, numAbandoned);
+}
+
+void RenderEngine::setSubdivision (const bool shouldSubdivide) {
+    m_subdivide = shouldSubdivide;
+}
+
+void RenderEngine::setAntialiasing (const int samplesPerEdgePixel) {
+    if (samplesPerEdgePixel == m_samplesPerEdgePixel)
+        return;
+
+    m_samplesPerEdgePixel = samplesPerEdgePixel;
+    m_edgeSamples = nullptr;
+    m_needsAntialiasing = samplesPerEdgePixel > 0;
+
+    // A pass in flight still colours its edges, so the frame is coloured
+    // again once it is done; a finished frame starts its pass now
+    if (isRendering())
+        m_needsRecolour = true;
+    else if (m_needsAntialiasing)
+        startAntialiasing();
+    else
+        recolour();
+}
+
+void RenderEngine::setProgressive (const bool shouldBeProgressive, const int coarsestStep) {
+    jassert (juce::isPowerOfTwo (coarsestStep) && coarsestStep <= tileSize);
+    m_coarsestStep = shouldBeProgressive ? juce::jlimit (1, tileSize, coarsestStep) : 1;
+}
+
+int RenderEngine::chooseCoarsestStep (const int width, const int height) noexcept {
+    return static_cast<int64_t> (width) * height > largeImagePixels ? 8 : 4;
+}
+
+void RenderEngine::recolour() {
+    if (m_iterations == nullptr || m_target == nullptr
+        || m_target->getBounds() != m_backBuffer.getBounds())
+        return;
+
+    // Tiles in flight still colour with the palette they started with, so
+    // wait for them rather than race them for the pixels.
+    if (isRendering()) {
+        m_needsRecolour = true;
+        return;
+    }
+
+    m_needsRecolour = false;
+
+    // Bands filled by subdivision have no magnitudes to shade smoothly from
+    if (m_frameHasFilledBands && m_palette.usesMagnitude()) {
+        render (m_params, *m_target);
+        return;
+    }
+
+    // The end of a histogram-coloured render belongs to that render
+    if (m_stats.isFinished (m_frame))
+        m_frame = m_stats.beginFrame ("recolour");
+
+    const auto started = RenderStats::Clock::now();
+
+    m_palette.build (m_params.minIterations, m_params.maxIterations, m_iterations.get());
+    const PixelLut lut (m_palette);
+
+    // The back buffer is coloured too, as an antialias pass publishes
+    // whole tiles from it. Nothing is pending, but a cancelled job may
+    // still be finishing a write into it.
+    m_pool.removeAllJobs (true, -1);
+    {
+        juce::Image::BitmapData bitmap (m_backBuffer, juce::Image::BitmapData::writeOnly);
+        colourArea (*m_iterations, lut, bitmap, m_backBuffer.getBounds());
+    }
+
+    if (m_edgeSamples != nullptr)
+        for (int tile = 0; tile < m_edgeSamples->getNumRegions(); tile++)
+            colourEdges (*m_edgeSamples, tile, lut, m_backBuffer, m_backBuffer.getBounds());
+
+    copyPixels (m_backBuffer, *m_target, m_target->getBounds());
+
+    m_stats.addEvent (m_frame, RenderStage::colour, -1, started, RenderStats::Clock::now());
+    m_stats.finishFrame (m_frame);
+
+    if (onTilesPublished != nullptr)
+        onTilesPublished (m_target->getBounds());
+}
+
+bool RenderEngine::isRendering() const noexcept {
+    return m_tilesPending > 0;
+}
+
+int RenderEngine::getNumTiles() const noexcept {
+    const int tilesAcross = (m_gridOffset.getX() + m_params.width + tileSize - 1) / tileSize;
+    const int tilesDown = (m_gridOffset.getY() + m_params.height + tileSize - 1) / tileSize;
+    return tilesAcross * tilesDown;
+}
+
+// Where the tile is in the image, clipped to the iteration buffer
+juce::Rectangle<int> RenderEngine::getTileArea (const int tile) const noexcept {
+    const int tilesAcross = (m_gridOffset.getX() + m_params.width + tileSize - 1) / tileSize;
+    const int tileX = (tile % tilesAcross) * tileSize - m_gridOffset.getX();
+    const int tileY = (tile / tilesAcross) * tileSize - m_gridOffset.getY();
+
+    return juce::Rectangle<int> (tileX, tileY, tileSize, tileSize)
+               .getIntersection ({ m_iterations->getX(), m_iterations->getY(),
+                                   m_iterations->getWidth(), m_iterations->getHeight() });
+}
+
+int RenderEngine::getTileAt (const int x, const int y) const noexcept {
+    const int tilesAcross = (m_gridOffset.getX() + m_params.width + tileSize - 1) / tileSize;
+    return ((y + m_gridOffset.getY()) / tileSize) * tilesAcross + (x + m_gridOffset.getX()) / tileSize;
+}
+
+// Null unless the frame is cached, otherwise fills in the tile's key
+TileCache* RenderEngine::getCacheFor (const int tile, TileCache::Key& key) noexcept {
+    if (! m_frameIsCached)
+        return nullptr;
+
+    // Cached tiles start on a multiple of tileSize of the lattice
+    const auto area = getTileArea (tile);
+    key = TileCache::makeKey (m_params, m_position, (m_position.x + area.getX()) / tileSize,
+                              (m_position.y + area.getY()) / tileSize);
+    return &m_tileCache;
+}
+
+bool RenderEngine::isCurrent (const int generation) const noexcept {
+    return generation == m_generation.load();
+}
+
+void RenderEngine::tileFinished (const juce::RectangleList<int>& areas, const int generation,
+                                 const bool isFinalPass) {
+    {
+        const juce::ScopedLock sl (m_lock);
+        if (! isCurrent (generation))
+            return;
+
+        if (m_finishedTiles.isEmpty())
+            m_publishRequested = RenderStats::Clock::now();
+
+        m_finishedTiles.add (areas);
+        if (isFinalPass && --m_tilesPending == 0)
+        {
+            if (m_needsMirroring)
+                finishMirroring();
+            m_isResumable = true;
+        }
+    }
+    triggerAsyncUpdate();
+}
+
+// Called with m_lock held, once every tile of a symmetric frame is done
+void RenderEngine::finishMirroring() {
+    m_needsMirroring = false;
+
+    // Mirrored counts were copied as their sources finished, but their
+    // pending orbits are rebuilt from the sources' here. That replaces any
+    // that came with cached tiles, so deepen() continues each pixel once.
+    const auto& mirrored = m_symmetry.mirrored;
+    std::vector<IterationBuffer::PendingOrbit> images;
+
+    for (int tile = 0; tile < getNumTiles(); tile++)
+    {
+        auto& pending = m_iterations->getPendingOrbits (tile);
+        pending.erase (std::remove_if (pending.begin(), pending.end(),
+                                       [&mirrored] (const auto& orbit) { return mirrored.contains (orbit.x, orbit.y); }),
+                       pending.end());
+
+        for (const auto& orbit : pending)
+        {
+            const auto image = m_symmetry.mirrorOrbit (orbit);
+            if (mirrored.contains (image.x, image.y))
+                images.push_back (image);
+        }
+    }
+
+    for (const auto& orbit : images)
+        m_iterations->getPendingOrbits (getTileAt (orbit.x, orbit.y)).push_back (orbit);
+
+    // Tiles with mirrored pixels weren't complete when their own job was
+    for (int tile = 0; tile < getNumTiles(); tile++)
+    {
+        TileCache::Key key {};
+        auto* cache = getCacheFor (tile, key);
+
+        if (cache != nullptr && ! toPixelArea (getTileArea (tile)).getIntersection (mirrored).isEmpty())
+            cache->store (key, copyTile (*m_iterations, tile, getTileArea (tile)));
+    }
+}
+
+void RenderEngine::startAntialiasing() {
+    {
+        const juce::ScopedLock sl (m_lock);
+        if (! m_isResumable)
+            return;
+    }
+
+    if (m_iterations == nullptr || m_target == nullptr || m_target->getBounds() != m_backBuffer.getBounds())
+        return;
+
+    m_needsAntialiasing = false;
+
+    // A frame that is already shown gets a frame of its own, like a recolour
+    if (m_stats.isFinished (m_frame))
+        m_frame = m_stats.beginFrame ("antialias", m_pool.getNumThreads());
+
+    m_edgeSamples = std::make_shared<EdgeSamples> (m_samplesPerEdgePixel, EdgeSamples::defaultThreshold, getNumTiles());
+    auto lut = std::make_shared<const PixelLut> (m_palette);
+    const int generation = m_generation.load();
+
+    // Edge tiles of a cached frame reach past the image, which needs no samples
+    std::vector<juce::ThreadPoolJob*> jobs;
+    for (int tile = 0; tile < getNumTiles(); tile++)
+    {
+        const auto area = getTileArea (tile).getIntersection (m_backBuffer.getBounds());
+        if (! area.isEmpty())
+            jobs.push_back (new AntialiasJob (*this, m_params, m_iterations, m_edgeSamples, lut, m_backBuffer,
+                                              tile, area, generation, m_frame));
+    }
+
+    m_tilesPending = static_cast<int> (jobs.size());
+    for (auto* job : jobs)
+        m_pool.addJob (job, true);
+}
+
+void RenderEngine::handleAsyncUpdate() {
+    const auto started = RenderStats::Clock::now();
+    juce::RectangleList<int> finished;
+    RenderStats::Clock::time_point requested;
+    {
+        const juce::ScopedLock sl (m_lock);
+        finished.swapWith (m_finishedTiles);
+        requested = m_publishRequested;
+    }
+
+    if (finished.isEmpty() || m_target == nullptr
+        || m_target->getBounds() != m_backBuffer.getBounds())
+        return;
+
+    m_stats.addEvent (m_frame, RenderStage::wait, -1, requested, started);
+
+    for (auto& area : finished)
+        copyPixels (m_backBuffer, *m_target, area);
+
+    m_stats.addEvent (m_frame, RenderStage::publish, -1, started, RenderStats::Clock::now());
+
+    if (onTilesPublished != nullptr)
+        onTilesPublished (finished.getBounds());
+
+    // Histogram colouring can only be right once every count is known
+    if (! isRendering() && (m_needsRecolour || m_palette.needsWholeFrame()))
+        recolour();
+
+    if (! isRendering() && m_needsAntialiasing)
+        startAntialiasing();
+
+    if (! isRendering())
+        m_stats.finishFrame (m_frame);
+}
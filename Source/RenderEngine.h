@@ -0,0 +1,174 @@
+/*
+  ==============================================================================
+
+    RenderEngine.h
+    Created: 17 Oct 2026 9:20:41am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "Antialiasing.h"
+#include "EscapeTime.h"
+#include "IterationBuffer.h"
+#include "Palette.h"
+#include "RenderStats.h"
+#include "Subdivision.h"
+#include "Symmetry.h"
+#include "TileCache.h"
+
+//==============================================================================
+/*
+    Renders a frame on a thread pool by splitting it into square tiles.
+
+    Workers iterate into an IterationBuffer and colour from it into a private
+    back buffer. Each finished tile is copied into
+    the owner's image on the message thread, after which onTilesPublished is
+    called with the area that changed so the owner can repaint just that part.
+    Starting a new render abandons whatever is still in flight.
+
+    In progressive mode every tile is first rendered at 1/coarsestStep of the
+    resolution and then refined in passes that halve the step, so something
+    appears within milliseconds and the full frame costs no more than a
+    direct render: each pass only computes the pixels earlier passes skipped.
+    The boxes pick the step for their image size with chooseCoarsestStep().
+
+    The iteration buffer outlives the render, so changing the palette and
+    calling recolour() is one linear pass over it with no iterating at all.
+    It also remembers where every undecided orbit stopped, so deepen() can
+    raise the iteration limit of a finished frame by continuing just those.
+
+    With subdivision on, tiles are rendered Mariani-Silver style instead:
+    rectangles whose border has a single count are filled without iterating
+    the inside. The counts match a per-pixel render unless a feature thinner
+    than a pixel slips between two border samples.
+
+    Frames rendered with a LatticePosition, while the tile cache has a
+    budget, align their tiles to the lattice instead of the image. Edge tiles
+    are iterated whole, past the image's edges, and every finished tile goes
+    into the cache, so a later frame on the same lattice copies the tiles it
+    shares with this one instead of iterating them. Subdivided frames are
+    neither cached nor served from the cache, as their fills are estimates.
+
+    When a frame mirrors itself (see Symmetry.h), tiles only iterate the
+    pixels that mirror nothing and copy them to their mirror images as they
+    go, so the default views cost about half as much.
+
+    With antialiasing on, a finished frame gets one more pass over its tiles
+    that samples just the pixels on edges several times over (see
+    Antialiasing.h) and colours them with the average. It runs once every
+    count is known, since edges are found by comparing neighbours, and again
+    after deepen(). The samples are kept as counts, so recolour() covers them.
+
+    Every frame, deepen and recolour is timed into getStats(), tile by tile
+    and stage by stage, including how long finished tiles wait for the
+    message thread; the owner adds how long it takes to paint.
+*/
+class RenderEngine : private juce::AsyncUpdater
+{
+public:
+    explicit RenderEngine (const std::string& name = "Renderer");
+    ~RenderEngine() override;
+
+    void render (const FractalParams& params, juce::Image& target,
+                 const LatticePosition& position = {});
+    void cancel();
+
+    /*  Raises the iteration limit of the finished frame without starting it
+        again. Returns false if there is nothing to resume from, in which
+        case the caller should render from scratch.
+    */
+    bool deepen (const int maxIterations);
+
+    void recolour();
+    void setProgressive (const bool shouldBeProgressive, const int coarsestStep = 8);
+
+    // 1/8 for images big enough that a 1/4 first pass would keep the user waiting, 1/4 below that
+    static int chooseCoarsestStep (const int width, const int height) noexcept;
+    static constexpr int largeImagePixels = 1 << 20;
+    void setSubdivision (const bool shouldSubdivide);
+
+    // Samples per edge pixel, 0 for none; applies to the frame shown as well
+    void setAntialiasing (const int samplesPerEdgePixel);
+    int getAntialiasing() const noexcept    { return m_samplesPerEdgePixel; }
+    void setTileCacheBudget (const size_t budgetBytes)   { m_tileCache.setBudget (budgetBytes); }
+    bool isSubdividing() const noexcept     { return m_subdivide; }
+    bool isRendering() const noexcept;
+
+    Palette& getPalette() noexcept              { return m_palette; }
+    const FractalParams& getParams() const noexcept { return m_params; }
+
+    RenderStats& getStats() noexcept                { return m_stats; }
+    const RenderStats& getStats() const noexcept    { return m_stats; }
+
+    // The frame of getStats() that the image shows or is being rendered into
+    int getCurrentFrame() const noexcept            { return m_frame; }
+
+    std::function<void (const juce::Rectangle<int>&)> onTilesPublished;
+
+    static constexpr int tileSize = 64;
+
+private:
+    class TileJob;
+    class DeepenJob;
+    class SubdivisionJob;
+    class AntialiasJob;
+
+    int getNumTiles() const noexcept;
+    juce::Rectangle<int> getTileArea (const int tile) const noexcept;
+    int getTileAt (const int x, const int y) const noexcept;
+    TileCache* getCacheFor (const int tile, TileCache::Key& key) noexcept;
+    bool isCurrent (const int generation) const noexcept;
+    void tileFinished (const juce::RectangleList<int>& areas, const int generation,
+                       const bool isFinalPass);
+    void finishMirroring();
+    void startAntialiasing();
+    void handleAsyncUpdate() override;
+
+    juce::ThreadPool m_pool;
+
+    Palette m_palette;
+    FractalParams m_params;
+    std::shared_ptr<IterationBuffer> m_iterations;
+    juce::Image m_backBuffer;
+    juce::Image* m_target {nullptr};
+
+    TileCache m_tileCache;
+    LatticePosition m_position;
+    bool m_frameIsCached {false};
+
+    SymmetryPlan m_symmetry;
+    bool m_needsMirroring {false};
+
+    // Where image pixel (0, 0) is in its tile; 0 unless the frame is cached
+    juce::Point<int> m_gridOffset;
+
+    int m_coarsestStep {8};
+    bool m_needsRecolour {false};
+    bool m_isResumable {false};
+    bool m_subdivide {false};
+    bool m_frameIsSubdivided {false};
+    bool m_frameHasFilledBands {false};
+
+    // The edges of the frame shown, once its antialiasing pass has started
+    int m_samplesPerEdgePixel {0};
+    std::shared_ptr<EdgeSamples> m_edgeSamples;
+    bool m_needsAntialiasing {false};
+
+    std::atomic<int> m_generation {0};
+    std::atomic<int> m_tilesPending {0};
+
+    juce::CriticalSection m_lock;
+    juce::RectangleList<int> m_finishedTiles;
+
+    RenderStats m_stats;
+    int m_frame {-1};
+
+    // When m_finishedTiles last went from empty to waiting for the message thread
+    RenderStats::Clock::time_point m_publishRequested;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderEngine)
+};
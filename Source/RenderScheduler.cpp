@@ -0,0 +1,60 @@
+/*
+  ==============================================================================
+
+    RenderScheduler.cpp
+    Created: 17 Oct 2026 1:46:52pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "RenderScheduler.h"
+
+//==============================================================================
+RenderScheduler::RenderScheduler(RenderEngine& engine, juce::Image& target)
+    : m_engine(engine), m_target(target) {}
+
+RenderScheduler::~RenderScheduler() {
+    stopTimer();
+}
+
+void RenderScheduler::requestRender(const FractalParams& params, const LatticePosition& position) {
+    if (m_hasPending) {
+        m_numCoalesced++;
+        m_engine.getStats().requestDropped();
+    }
+
+    m_pending = params;
+    m_pendingPosition = position;
+    m_hasPending = true;
+
+    // Nothing rendered during the last frame, so there's no reason to wait
+    if (! isTimerRunning()) {
+        startPending();
+        startTimerHz(m_framesPerSecond);
+    }
+}
+
+void RenderScheduler::cancel() {
+    m_hasPending = false;
+    stopTimer();
+    m_engine.cancel();
+}
+
+void RenderScheduler::setTargetFrameRate(const int framesPerSecond) {
+    m_framesPerSecond = juce::jmax(1, framesPerSecond);
+    if (isTimerRunning()) startTimerHz(m_framesPerSecond);
+}
+
+void RenderScheduler::timerCallback() {
+    if (m_hasPending) {
+        startPending();
+    } else {
+        stopTimer();
+    }
+}
+
+void RenderScheduler::startPending() {
+    m_hasPending = false;
+    m_engine.render(m_pending, m_target, m_pendingPosition);
+}
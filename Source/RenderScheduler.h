@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    RenderScheduler.h
+    Created: 17 Oct 2026 1:46:52pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RenderEngine.h"
+
+//==============================================================================
+/*
+    Sits between the mouse handlers and a RenderEngine so that a fast drag
+    doesn't turn into a backlog of full renders.
+
+    Only the newest requested frame is kept. The first request after a quiet
+    spell starts straight away; anything arriving after that is held until the
+    next frame tick, where it replaces (and cancels) whatever is still in
+    flight. The time between a mouse event and the render that reflects it is
+    therefore at most one frame interval.
+*/
+class RenderScheduler : private juce::Timer
+{
+public:
+    RenderScheduler(RenderEngine& engine, juce::Image& target);
+    ~RenderScheduler() override;
+
+    void requestRender(const FractalParams& params, const LatticePosition& position = {});
+
+    // Drops any held request and stops the engine, for when the image is drawn some other way
+    void cancel();
+    void setTargetFrameRate(const int framesPerSecond);
+
+    // Requests that were replaced by a newer one before they were started; the
+    // engine's stats also count them against the frame that replaced them
+    int getNumCoalescedRequests() const noexcept { return m_numCoalesced; }
+
+private:
+    void timerCallback() override;
+    void startPending();
+
+    RenderEngine& m_engine;
+    juce::Image& m_target;
+
+    FractalParams m_pending;
+    LatticePosition m_pendingPosition;
+    bool m_hasPending {false};
+    int m_framesPerSecond {60};
+    int m_numCoalesced {0};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RenderScheduler)
+};
@@ -0,0 +1,309 @@
+/*
+  ==============================================================================
+
+    RenderStats.cpp
+    Created: 23 Oct 2026 9:12:46am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "RenderStats.h"
+
+#include <algorithm>
+#include <cstdio>
+
+//==============================================================================
+const char* getStageName (const RenderStage stage) noexcept {
+    switch (stage)
+    {
+        case RenderStage::iterate:    return "iterate";
+        case RenderStage::colour:     return "colour";
+        case RenderStage::publish:    return "publish";
+        case RenderStage::wait:       return "wait";
+        case RenderStage::paint:      return "paint";
+        case RenderStage::antialias:  return "antialias";
+    }
+    return "";
+}
+
+double FrameStats::getIterationsPerPixel() const noexcept {
+    return numPixels > 0 ? static_cast<double> (numIterations) / static_cast<double> (numPixels) : 0.0;
+}
+
+double FrameStats::getUtilisation() const noexcept {
+    const double available = durationMs * numThreads;
+    return available > 0.0 ? std::min (busyMs / available, 1.0) : 0.0;
+}
+
+//==============================================================================
+// Rows 0 and 1 of every process are the frames and the publish queue
+static constexpr int frameRow = 0;
+static constexpr int queueRow = 1;
+static constexpr int firstThreadRow = 2;
+
+// Every renderer's times count from the same moment, so their traces line up
+static const auto traceOrigin = RenderStats::Clock::now();
+
+RenderStats::RenderStats (std::string name)
+    : m_name (std::move (name)) {
+    // Whoever makes the renderer is its main thread, the one that publishes and paints
+    m_threadRows[std::this_thread::get_id()] = firstThreadRow;
+}
+
+double RenderStats::toMs (const Clock::time_point time) noexcept {
+    return std::chrono::duration<double, std::milli> (time - traceOrigin).count();
+}
+
+int RenderStats::beginFrame (const char* kind, const int numThreads) {
+    const std::lock_guard<std::mutex> lock (m_lock);
+
+    if (m_frames.size() >= static_cast<size_t> (maxFrames))
+        m_frames.pop_front();
+
+    Frame frame;
+    frame.stats.frame = m_nextFrame++;
+    frame.stats.kind = kind;
+    frame.stats.startMs = toMs (Clock::now());
+    frame.stats.numThreads = std::max (numThreads, 1);
+    frame.stats.numDroppedRequests = m_droppedRequests;
+    m_droppedRequests = 0;
+
+    m_frames.push_back (std::move (frame));
+    return m_frames.back().stats.frame;
+}
+
+RenderStats::Frame* RenderStats::findFrame (const int frame) {
+    // Frames are numbered in order, so the newest ones are at the back
+    for (auto it = m_frames.rbegin(); it != m_frames.rend(); ++it)
+        if (it->stats.frame == frame)
+            return &*it;
+    return nullptr;
+}
+
+const RenderStats::Frame* RenderStats::findFrame (const int frame) const {
+    return const_cast<RenderStats*> (this)->findFrame (frame);
+}
+
+// Called with m_lock held
+int RenderStats::getThreadRow() {
+    const auto found = m_threadRows.find (std::this_thread::get_id());
+    if (found != m_threadRows.end())
+        return found->second;
+
+    const int row = firstThreadRow + static_cast<int> (m_threadRows.size());
+    m_threadRows[std::this_thread::get_id()] = row;
+    return row;
+}
+
+// Called with m_lock held; a full frame keeps its totals but stops keeping events
+void RenderStats::addToFrame (Frame& frame, const Event& event) {
+    if (frame.events.size() < maxEventsPerFrame)
+        frame.events.push_back (event);
+}
+
+void RenderStats::addEvent (const int frame, const RenderStage stage, const int tile,
+                            const Clock::time_point start, const Clock::time_point end) {
+    const std::lock_guard<std::mutex> lock (m_lock);
+
+    auto* target = findFrame (frame);
+    if (target == nullptr)
+        return;
+
+    const double startMs = toMs (start);
+    const double durationMs = std::max (toMs (end) - startMs, 0.0);
+
+    auto& stats = target->stats;
+    stats.stageMs[static_cast<int> (stage)] += durationMs;
+    if (tile >= 0)
+        stats.busyMs += durationMs;
+
+    // Waiting isn't any thread's work, so it gets a row of its own
+    const int row = stage == RenderStage::wait ? queueRow : getThreadRow();
+    addToFrame (*target, { stage, tile, row, startMs * 1000.0, durationMs * 1000.0 });
+}
+
+void RenderStats::addTile (const int frame, const int tile, const int64_t numPixels, const int64_t numIterations) {
+    const std::lock_guard<std::mutex> lock (m_lock);
+
+    auto* target = findFrame (frame);
+    if (target == nullptr)
+        return;
+
+    target->stats.numTiles++;
+    target->stats.numPixels += numPixels;
+    target->stats.numIterations += numIterations;
+
+    Event marker { RenderStage::iterate, tile, getThreadRow(), toMs (Clock::now()) * 1000.0, 0.0 };
+    marker.numPixels = numPixels;
+    marker.numIterations = numIterations;
+    addToFrame (*target, marker);
+}
+
+void RenderStats::addCachedTiles (const int frame, const int numTiles) {
+    const std::lock_guard<std::mutex> lock (m_lock);
+
+    if (auto* target = findFrame (frame))
+        target->stats.numCachedTiles += numTiles;
+}
+
+void RenderStats::finishFrame (const int frame) {
+    const std::lock_guard<std::mutex> lock (m_lock);
+
+    auto* target = findFrame (frame);
+    if (target == nullptr || target->stats.isFinished)
+        return;
+
+    target->stats.isFinished = true;
+    target->stats.durationMs = toMs (Clock::now()) - target->stats.startMs;
+}
+
+void RenderStats::cancelFrame (const int frame, const int numCancelledJobs) {
+    finishFrame (frame);
+
+    const std::lock_guard<std::mutex> lock (m_lock);
+
+    if (auto* target = findFrame (frame))
+    {
+        target->stats.wasCancelled = true;
+        target->stats.numCancelledJobs += numCancelledJobs;
+    }
+}
+
+bool RenderStats::isFinished (const int frame) const {
+    const std::lock_guard<std::mutex> lock (m_lock);
+
+    const auto* target = findFrame (frame);
+    return target == nullptr || target->stats.isFinished;
+}
+
+void RenderStats::requestDropped() {
+    const std::lock_guard<std::mutex> lock (m_lock);
+    m_droppedRequests++;
+}
+
+FrameStats RenderStats::getLatestFrame() const {
+    const std::lock_guard<std::mutex> lock (m_lock);
+
+    if (m_frames.empty())
+        return {};
+
+    // A frame still in flight has lasted until now
+    auto stats = m_frames.back().stats;
+    if (! stats.isFinished)
+        stats.durationMs = toMs (Clock::now()) - stats.startMs;
+    return stats;
+}
+
+//==============================================================================
+static std::string quote (const std::string& text) {
+    std::string quoted = "\"";
+    for (const char character : text)
+    {
+        if (character == '"' || character == '\\')
+            quoted += '\\';
+        if (static_cast<unsigned char> (character) >= 0x20)
+            quoted += character;
+    }
+    return quoted + "\"";
+}
+
+template <typename... Args>
+static void append (std::string& json, const char* format, Args... args) {
+    char line[512];
+    const int length = std::snprintf (line, sizeof (line), format, args...);
+    json.append (line, static_cast<size_t> (std::clamp (length, 0, static_cast<int> (sizeof (line)) - 1)));
+}
+
+// Called with m_lock held
+void RenderStats::writeEvents (std::string& json, const int pid) const {
+    append (json, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":0,\"args\":{\"name\":%s}},\n",
+            pid, quote (m_name).c_str());
+    append (json, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"frames\"}},\n",
+            pid, frameRow);
+    append (json, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":\"publish queue\"}},\n",
+            pid, queueRow);
+
+    for (const auto& thread : m_threadRows)
+    {
+        const int row = thread.second;
+        const auto name = row == firstThreadRow ? std::string ("main thread")
+                                                : "worker " + std::to_string (row - firstThreadRow);
+        append (json, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":%s}},\n",
+                pid, row, quote (name).c_str());
+    }
+
+    const double nowMs = toMs (Clock::now());
+
+    for (const auto& frame : m_frames)
+    {
+        // A frame still in flight has lasted until now
+        auto stats = frame.stats;
+        if (! stats.isFinished)
+            stats.durationMs = nowMs - stats.startMs;
+
+        append (json, "{\"name\":\"%s %d\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,"
+                      "\"ts\":%.3f,\"dur\":%.3f,\"args\":{",
+                stats.kind, stats.frame, pid, frameRow, stats.startMs * 1000.0, stats.durationMs * 1000.0);
+
+        for (int stage = 0; stage < numRenderStages; stage++)
+            append (json, "\"%sMs\":%.3f,", getStageName (static_cast<RenderStage> (stage)), stats.stageMs[stage]);
+
+        append (json, "\"tiles\":%d,\"cachedTiles\":%d,\"pixels\":%lld,\"iterationsPerPixel\":%.2f,",
+                stats.numTiles, stats.numCachedTiles, static_cast<long long> (stats.numPixels),
+                stats.getIterationsPerPixel());
+        append (json, "\"threads\":%d,\"utilisation\":%.3f,\"cancelledJobs\":%d,\"droppedRequests\":%d,"
+                      "\"cancelled\":%s,\"finished\":%s}},\n",
+                stats.numThreads, stats.getUtilisation(), stats.numCancelledJobs, stats.numDroppedRequests,
+                stats.wasCancelled ? "true" : "false", stats.isFinished ? "true" : "false");
+
+        for (const auto& event : frame.events)
+        {
+            if (event.numPixels >= 0)
+            {
+                const double perPixel = event.numPixels > 0 ? static_cast<double> (event.numIterations)
+                                                              / static_cast<double> (event.numPixels) : 0.0;
+                append (json, "{\"name\":\"tile done\",\"cat\":\"tile\",\"ph\":\"i\",\"s\":\"t\",\"pid\":%d,\"tid\":%d,"
+                              "\"ts\":%.3f,\"args\":{\"frame\":%d,\"tile\":%d,\"pixels\":%lld,\"iterationsPerPixel\":%.2f}},\n",
+                        pid, event.thread, event.startUs, stats.frame, event.tile,
+                        static_cast<long long> (event.numPixels), perPixel);
+                continue;
+            }
+
+            append (json, "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,"
+                          "\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%d,\"tile\":%d}},\n",
+                    getStageName (event.stage), event.tile >= 0 ? "tile" : "frame", pid, event.thread,
+                    event.startUs, event.durationUs, stats.frame, event.tile);
+        }
+    }
+}
+
+std::string RenderStats::toChromeTrace (const std::vector<const RenderStats*>& renderers) {
+    std::string json = "{\"traceEvents\":[\n";
+
+    for (size_t i = 0; i < renderers.size(); i++)
+    {
+        const std::lock_guard<std::mutex> lock (renderers[i]->m_lock);
+        renderers[i]->writeEvents (json, static_cast<int> (i) + 1);
+    }
+
+    // Every event ends in a comma, which JSON doesn't allow after the last
+    if (json.size() >= 2 && json[json.size() - 2] == ',')
+        json.erase (json.size() - 2, 1);
+
+    return json + "],\"displayTimeUnit\":\"ms\"}\n";
+}
+
+//==============================================================================
+int64_t countIterations (const IterationBuffer& iterations, const PixelArea& area,
+                         const int maxIterations) noexcept {
+    int64_t total = 0;
+
+    for (int ptY = area.y; ptY < area.getBottom(); ptY++)
+    {
+        const int* counts = iterations.getCounts (ptY);
+        for (int ptX = area.x; ptX < area.getRight(); ptX++)
+            total += std::min (counts[ptX], maxIterations);
+    }
+    return total;
+}
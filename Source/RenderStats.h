@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+    RenderStats.h
+    Created: 23 Oct 2026 9:12:46am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "IterationBuffer.h"
+#include "Symmetry.h"
+
+//==============================================================================
+/*
+    Where a frame's time goes:
+
+    - iterate:    workers running the escape-time loops, tile by tile
+    - colour:     turning iteration counts into pixels
+    - publish:    copying finished pixels to where they are shown, or written
+    - wait:       finished tiles queued for the message thread to publish them
+    - paint:      the component drawing the image
+    - antialias:  extra samples across the pixels on edges, see Antialiasing.h
+*/
+enum class RenderStage
+{
+    iterate,
+    colour,
+    publish,
+    wait,
+    paint,
+    antialias
+};
+
+constexpr int numRenderStages = 6;
+
+const char* getStageName (const RenderStage stage) noexcept;
+
+/*  What one frame cost. Stage times are summed over every thread, so with
+    several workers iterate can be longer than the frame itself.
+*/
+struct FrameStats
+{
+    int frame { -1 };
+
+    // "render", "deepen", "recolour" or "antialias"
+    const char* kind { "" };
+
+    double startMs { 0.0 };
+    double durationMs { 0.0 };
+    double stageMs[numRenderStages] {};
+
+    // Time tile jobs were busy, which is what the threads could have given
+    double busyMs { 0.0 };
+    int numThreads { 1 };
+
+    int numTiles { 0 }, numCachedTiles { 0 };
+    int64_t numPixels { 0 }, numIterations { 0 };
+
+    // Jobs abandoned when the frame was replaced, and requests for it that a newer one replaced
+    int numCancelledJobs { 0 };
+    int numDroppedRequests { 0 };
+
+    bool isFinished { false };
+    bool wasCancelled { false };
+
+    double getStageMs (const RenderStage stage) const noexcept  { return stageMs[static_cast<int> (stage)]; }
+    double getIterationsPerPixel() const noexcept;
+
+    // Busy time over what numThreads could have done while the frame lasted, 0 to 1
+    double getUtilisation() const noexcept;
+};
+
+//==============================================================================
+/*
+    Timings of the last few frames a renderer drew, per stage and per tile,
+    for an on-screen summary or a Chrome trace (chrome://tracing, or
+    ui.perfetto.dev) of what every thread was doing.
+
+    Frames are numbered by beginFrame(), and every event names its frame, so
+    a job that outlives its frame still lands in the right place, or nowhere
+    once the frame has been dropped from the history. Every call is thread
+    safe and cheap next to the tile it times: one lock and a push_back.
+*/
+class RenderStats
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // The name is what the trace calls this renderer's process
+    explicit RenderStats (std::string name);
+
+    int beginFrame (const char* kind, const int numThreads = 1);
+
+    // Adds an event; tile is -1 for anything that isn't a tile's work
+    void addEvent (const int frame, const RenderStage stage, const int tile,
+                   const Clock::time_point start, const Clock::time_point end);
+
+    // A finished tile's pixels and the iterations they took
+    void addTile (const int frame, const int tile, const int64_t numPixels, const int64_t numIterations);
+    void addCachedTiles (const int frame, const int numTiles);
+
+    // Ends the frame now; later calls and events don't move its end
+    void finishFrame (const int frame);
+    void cancelFrame (const int frame, const int numCancelledJobs);
+    bool isFinished (const int frame) const;
+
+    // A request that was replaced before it started, counted against the next frame
+    void requestDropped();
+
+    // The newest frame, finished or not; frame is -1 if there hasn't been one
+    FrameStats getLatestFrame() const;
+
+    // Trace-event JSON covering every renderer given, one process each
+    static std::string toChromeTrace (const std::vector<const RenderStats*>& renderers);
+
+    static constexpr int maxFrames = 16;
+    static constexpr size_t maxEventsPerFrame = size_t {1} << 16;
+
+private:
+    struct Event
+    {
+        RenderStage stage;
+        int tile;
+        int thread;
+        double startUs, durationUs;
+
+        // Set on the marker addTile() leaves when a tile is done
+        int64_t numPixels { -1 }, numIterations { 0 };
+    };
+
+    struct Frame
+    {
+        FrameStats stats;
+        std::vector<Event> events;
+    };
+
+    Frame* findFrame (const int frame);
+    const Frame* findFrame (const int frame) const;
+    int getThreadRow();
+    void addToFrame (Frame& frame, const Event& event);
+    void writeEvents (std::string& json, const int pid) const;
+
+    static double toMs (const Clock::time_point time) noexcept;
+
+    const std::string m_name;
+
+    mutable std::mutex m_lock;
+    std::deque<Frame> m_frames;
+    int m_nextFrame { 0 };
+    int m_droppedRequests { 0 };
+
+    // Trace rows: frames, the publish queue, then one per thread seen
+    std::unordered_map<std::thread::id, int> m_threadRows;
+};
+
+// Sums the counts of an area, undecided pixels counting as the limit
+int64_t countIterations (const IterationBuffer& iterations, const PixelArea& area,
+                         const int maxIterations) noexcept;
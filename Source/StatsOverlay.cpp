@@ -0,0 +1,66 @@
+/*
+  ==============================================================================
+
+    StatsOverlay.cpp
+    Created: 23 Oct 2026 11:05:19am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "StatsOverlay.h"
+
+//==============================================================================
+static constexpr int lineHeight = 14;
+static constexpr int numLines = 7;
+
+juce::Rectangle<int> getStatsOverlayBounds() {
+    return { 4, 4, 290, numLines * lineHeight + 8 };
+}
+
+static juce::String toMs (const double milliseconds) {
+    return juce::String (milliseconds, milliseconds < 10.0 ? 2 : 1);
+}
+
+void drawStatsOverlay (juce::Graphics& g, const FrameStats& stats, const juce::String& resolution) {
+    const auto bounds = getStatsOverlayBounds();
+    g.setColour (juce::Colours::black.withAlpha (0.7f));
+    g.fillRect (bounds);
+
+    if (stats.frame < 0)
+        return;
+
+    auto stageMs = [&stats] (const RenderStage stage) { return toMs (stats.getStageMs (stage)); };
+
+    const juce::String state = stats.wasCancelled ? " (cancelled)" : stats.isFinished ? "" : " ...";
+    const juce::String lines[numLines] = {
+        juce::String (stats.kind) + " " + juce::String (stats.frame) + ": " + toMs (stats.durationMs) + " ms" + state,
+        "iterate " + stageMs (RenderStage::iterate) + "  colour " + stageMs (RenderStage::colour)
+            + "  antialias " + stageMs (RenderStage::antialias) + " ms",
+        "publish " + stageMs (RenderStage::publish) + "  wait " + stageMs (RenderStage::wait)
+            + "  paint " + stageMs (RenderStage::paint) + " ms",
+        juce::String (stats.numTiles) + " tiles, " + juce::String (stats.numCachedTiles) + " cached, "
+            + juce::String (stats.getIterationsPerPixel(), 1) + " iterations/pixel",
+        juce::String (stats.numThreads) + " threads, "
+            + juce::String (juce::roundToInt (stats.getUtilisation() * 100.0)) + "% busy",
+        juce::String (stats.numCancelledJobs) + " jobs cancelled, "
+            + juce::String (stats.numDroppedRequests) + " requests dropped",
+        resolution
+    };
+
+    g.setColour (juce::Colours::white);
+    g.setFont (12.0f);
+
+    auto area = bounds.reduced (6, 4);
+    for (const auto& line : lines)
+        g.drawText (line, area.removeFromTop (lineHeight), juce::Justification::centredLeft, true);
+}
+
+juce::File exportChromeTrace (const std::vector<const RenderStats*>& renderers) {
+    const auto file = juce::File::getSpecialLocation (juce::File::userDocumentsDirectory)
+                          .getNonexistentChildFile ("FractalFactory trace", ".json", false);
+
+    if (! file.replaceWithText (RenderStats::toChromeTrace (renderers)))
+        return {};
+    return file;
+}
@@ -0,0 +1,32 @@
+/*
+  ==============================================================================
+
+    StatsOverlay.h
+    Created: 23 Oct 2026 11:05:19am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "RenderStats.h"
+
+//==============================================================================
+/*
+    The on-screen side of RenderStats: a box in the top-left corner of a
+    component summing up its latest frame, and writing a Chrome trace of
+    every renderer to a file.
+*/
+
+// Where drawStatsOverlay() draws, so the owner can repaint just that
+juce::Rectangle<int> getStatsOverlayBounds();
+
+// resolution is a line of the owner's own, for the scale it renders at
+void drawStatsOverlay (juce::Graphics& g, const FrameStats& stats, const juce::String& resolution);
+
+/*  Writes the trace to a new file in the documents folder and returns it,
+    or a default File if it couldn't be written.
+*/
+juce::File exportChromeTrace (const std::vector<const RenderStats*>& renderers);
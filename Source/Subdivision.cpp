@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+    Subdivision.cpp
+    Created: 19 Oct 2026 10:14:52am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "Subdivision.h"
+#include <limits>
+#include <vector>
+
+namespace
+{
+    struct Area
+    {
+        int x, y, width, height;
+
+        int getRight() const noexcept   { return x + width; }
+        int getBottom() const noexcept  { return y + height; }
+    };
+
+    class Subdivider
+    {
+    public:
+        Subdivider (const FractalParams& params, IterationBuffer& iterations, const Area& area,
+                    const int fillableBelow, const std::function<bool()>& shouldStop)
+            : m_params (params), m_iterations (iterations), m_area (area),
+              m_fillableBelow (fillableBelow), m_shouldStop (shouldStop),
+              m_known (static_cast<size_t> (area.width * area.height), false) {}
+
+        bool subdivide (const Area& rect)
+        {
+            if (m_shouldStop != nullptr && m_shouldStop())
+                return false;
+
+            // Thin rectangles are all ring
+            if (rect.width <= smallestSplit || rect.height <= smallestSplit)
+            {
+                for (int ptY = rect.y; ptY < rect.getBottom(); ptY++)
+                    for (int ptX = rect.x; ptX < rect.getRight(); ptX++)
+                        add (ptX, ptY);
+                flush();
+                return true;
+            }
+
+            // One edge at a time, so neighbouring pixels share a vector
+            for (int ptX = rect.x; ptX < rect.getRight(); ptX++)
+                add (ptX, rect.y);
+            for (int ptX = rect.x; ptX < rect.getRight(); ptX++)
+                add (ptX, rect.getBottom() - 1);
+            for (int ptY = rect.y + 1; ptY < rect.getBottom() - 1; ptY++)
+                add (rect.x, ptY);
+            for (int ptY = rect.y + 1; ptY < rect.getBottom() - 1; ptY++)
+                add (rect.getRight() - 1, ptY);
+            flush();
+
+            if (ringIsUniform (rect))
+            {
+                m_iterations.fill (rect.x + 1, rect.y + 1, rect.width - 2, rect.height - 2,
+                                   m_iterations.getCounts (rect.y)[rect.x],
+                                   m_iterations.getMagnitudes (rect.y)[rect.x]);
+                return true;
+            }
+
+            const int halfWidth = rect.width / 2;
+            const int halfHeight = rect.height / 2;
+
+            return subdivide ({ rect.x, rect.y, halfWidth, halfHeight })
+                && subdivide ({ rect.x + halfWidth, rect.y, rect.width - halfWidth, halfHeight })
+                && subdivide ({ rect.x, rect.y + halfHeight, halfWidth, rect.height - halfHeight })
+                && subdivide ({ rect.x + halfWidth, rect.y + halfHeight, rect.width - halfWidth, rect.height - halfHeight });
+        }
+
+    private:
+        static constexpr int batchSize = 64;
+        static constexpr int smallestSplit = 8;
+
+        bool ringIsUniform (const Area& rect) const noexcept
+        {
+            const int count = m_iterations.getCounts (rect.y)[rect.x];
+
+            if (count <= m_params.maxIterations && count >= m_fillableBelow)
+                return false;
+
+            for (int ptY = rect.y; ptY < rect.getBottom(); ptY++)
+            {
+                const int* counts = m_iterations.getCounts (ptY);
+                const bool isEdgeRow = ptY == rect.y || ptY == rect.getBottom() - 1;
+                const int step = isEdgeRow ? 1 : rect.width - 1;
+
+                for (int ptX = rect.x; ptX < rect.getRight(); ptX += step)
+                    if (counts[ptX] != count)
+                        return false;
+            }
+            return true;
+        }
+
+        // Queues pixel (x, y) unless an earlier ring already iterated it
+        void add (const int x, const int y)
+        {
+            const auto index = static_cast<size_t> ((y - m_area.y) * m_area.width + x - m_area.x);
+            if (m_known[index])
+                return;
+
+            m_known[index] = true;
+            m_x[m_numQueued] = x;
+            m_y[m_numQueued] = y;
+            m_numQueued++;
+
+            if (m_numQueued == batchSize)
+                flush();
+        }
+
+        void flush()
+        {
+            if (m_numQueued == 0)
+                return;
+
+            // The deep tiers have no batch kernels to share
+            if (m_params.precision == Precision::doubleDouble || m_params.precision == Precision::perturbation)
+            {
+                for (int i = 0; i < m_numQueued; i++)
+                {
+                    calcIterationsRow (m_params, m_y[i], m_x[i], 1,
+                                       { m_iterations.getCounts (m_y[i]) + m_x[i],
+                                         m_iterations.getMagnitudes (m_y[i]) + m_x[i] });
+                }
+                m_numQueued = 0;
+                return;
+            }
+
+            const bool isJulia = m_params.type == FractalType::julia;
+            double pointX[batchSize], pointY[batchSize], zero[batchSize] {}, cRe[batchSize], cIm[batchSize];
+            int counts[batchSize];
+            float magnitudes[batchSize];
+
+            for (int i = 0; i < m_numQueued; i++)
+            {
+                pointX[i] = m_params.mathX (m_x[i]);
+                pointY[i] = m_params.mathY (m_y[i]);
+                cRe[i] = m_params.cRe;
+                cIm[i] = m_params.cIm;
+            }
+
+            OrbitBatch batch;
+            batch.numOrbits = m_numQueued;
+            batch.firstIteration = m_params.minIterations;
+            batch.formula = m_params.formula;
+            batch.isMandelbrot = ! isJulia;
+            batch.useFloats = m_params.precision == Precision::float32;
+            batch.zRe = isJulia ? pointX : zero;
+            batch.zIm = isJulia ? pointY : zero;
+            batch.cRe = isJulia ? cRe : pointX;
+            batch.cIm = isJulia ? cIm : pointY;
+            batch.results = { counts, magnitudes };
+            iterateOrbits (batch, m_params.maxIterations);
+
+            for (int i = 0; i < m_numQueued; i++)
+            {
+                m_iterations.getCounts (m_y[i])[m_x[i]] = counts[i];
+                m_iterations.getMagnitudes (m_y[i])[m_x[i]] = magnitudes[i];
+            }
+            m_numQueued = 0;
+        }
+
+        const FractalParams& m_params;
+        IterationBuffer& m_iterations;
+        const Area m_area;
+        const int m_fillableBelow;
+        const std::function<bool()>& m_shouldStop;
+        std::vector<bool> m_known;
+        int m_x[batchSize], m_y[batchSize];
+        int m_numQueued {0};
+    };
+}
+
+//==============================================================================
+bool subdivideArea (const FractalParams& params, IterationBuffer& iterations,
+                    const int x, const int y, const int width, const int height,
+                    const int fillableBelow, const std::function<bool()>& shouldStop) {
+    const Area area { x, y, width, height };
+    Subdivider subdivider (params, iterations, area, fillableBelow, shouldStop);
+    return subdivider.subdivide (area);
+}
+
+int getFillableBelow (const FractalParams& params) noexcept {
+    if (params.formula.variant == FormulaVariant::burningShip)
+        return 0;
+
+    if (params.type != FractalType::julia)
+        return std::numeric_limits<int>::max();
+
+    // A Julia set's lemniscates stay connected until the critical point escapes
+    const double zero = 0.0;
+    int criticalCount = 0;
+
+    OrbitBatch batch;
+    batch.numOrbits = 1;
+    batch.firstIteration = params.minIterations;
+    batch.formula = params.formula;
+    batch.isMandelbrot = true;
+    batch.zRe = &zero;
+    batch.zIm = &zero;
+    batch.cRe = &params.cRe;
+    batch.cIm = &params.cIm;
+    batch.results.nIterations = &criticalCount;
+    iterateOrbits (batch, params.maxIterations);
+
+    return criticalCount > params.maxIterations ? std::numeric_limits<int>::max() : criticalCount;
+}
@@ -0,0 +1,42 @@
+/*
+  ==============================================================================
+
+    Subdivision.h
+    Created: 19 Oct 2026 10:14:52am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <functional>
+#include "EscapeTime.h"
+#include "IterationBuffer.h"
+
+//==============================================================================
+/*
+    Mariani-Silver subdivision of one area of a frame. A rectangle's outer
+    ring of pixels is iterated first; if every ring pixel has the same count
+    the inside is filled with it, otherwise the rectangle is split into four
+    that are iterated the same way. Areas never share a pixel, so several can
+    be subdivided in parallel.
+
+    A fill is only exact where the region above that count cannot have an
+    island inside the ring. That always holds for points that never escape,
+    and for every count of the Mandelbrot set, whose lemniscates are
+    connected. A Julia set's are only connected below the count its critical
+    orbit escapes at, which getFillableBelow() works out. The same goes for
+    the other powers and the tricorn, whose only critical point is 0 too, but
+    not for the Burning Ship's folds. Pass 0 to fill only the interior, which
+    keeps every escaped pixel's magnitude.
+
+    Returns false if shouldStop asked it to give up part way.
+*/
+bool subdivideArea (const FractalParams& params, IterationBuffer& iterations,
+                    const int x, const int y, const int width, const int height,
+                    const int fillableBelow,
+                    const std::function<bool()>& shouldStop = nullptr);
+
+/*  The count below which escaped bands can be filled for these params. */
+int getFillableBelow (const FractalParams& params) noexcept;
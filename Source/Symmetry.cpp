@@ -0,0 +1,130 @@
+/*
+  ==============================================================================
+
+    Symmetry.cpp
+    Created: 21 Oct 2026 4:48:15pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "Symmetry.h"
+#include <algorithm>
+#include <cmath>
+
+//==============================================================================
+PixelArea PixelArea::getIntersection (const PixelArea& other) const noexcept {
+    const int left = std::max (x, other.x);
+    const int top = std::max (y, other.y);
+    const int right = std::min (getRight(), other.getRight());
+    const int bottom = std::min (getBottom(), other.getBottom());
+
+    if (right <= left || bottom <= top)
+        return {};
+
+    return { left, top, right - left, bottom - top };
+}
+
+//==============================================================================
+PixelArea SymmetryPlan::getMirrorOf (const PixelArea& area) const noexcept {
+    if (area.isEmpty())
+        return {};
+
+    const int x = mirrorsColumns ? columnSum - (area.getRight() - 1) : area.x;
+    const int y = rowSum - (area.getBottom() - 1);
+    return PixelArea { x, y, area.width, area.height }.getIntersection (mirrored);
+}
+
+std::vector<PixelArea> SymmetryPlan::getUniqueParts (const PixelArea& area) const {
+    const auto overlap = area.getIntersection (mirrored);
+    if (overlap.isEmpty())
+        return { area };
+
+    const PixelArea parts[] = {
+        { area.x, area.y, area.width, overlap.y - area.y },
+        { area.x, overlap.getBottom(), area.width, area.getBottom() - overlap.getBottom() },
+        { area.x, overlap.y, overlap.x - area.x, overlap.height },
+        { overlap.getRight(), overlap.y, area.getRight() - overlap.getRight(), overlap.height }
+    };
+
+    std::vector<PixelArea> unique;
+    for (const auto& part : parts)
+        if (! part.isEmpty())
+            unique.push_back (part);
+    return unique;
+}
+
+IterationBuffer::PendingOrbit SymmetryPlan::mirrorOrbit (const IterationBuffer::PendingOrbit& orbit) const noexcept {
+    if (mirrorsColumns)
+        return { columnSum - orbit.x, rowSum - orbit.y, -orbit.re, -orbit.im };
+
+    return { orbit.x, rowSum - orbit.y, orbit.re, -orbit.im };
+}
+
+//==============================================================================
+/*  Twice the pixel coordinate of the axis, if partners across it get
+    coordinates that are exact negatives of each other. Pixel p sits at
+    centre + (p - size / 2) * pixelSize, and (p - size / 2) is exact, so
+    that holds when the centre is exactly 0 and the axis is at p = size / 2.
+*/
+static bool getAxisSum (const double centre, const double centreLow, const int size, int& sum) noexcept {
+    if (centre != 0.0 || centreLow != 0.0)
+        return false;
+
+    sum = size;
+    return true;
+}
+
+SymmetryPlan planSymmetry (const FractalParams& params) noexcept {
+    SymmetryPlan plan;
+
+    if (params.width <= 0 || params.height <= 0 || ! (params.pixelSize > 0.0))
+        return plan;
+
+    plan.mirrorsColumns = params.type == FractalType::julia;
+
+    if (plan.mirrorsColumns ? ! params.formula.hasPointSymmetry() : ! params.formula.hasConjugateSymmetry())
+        return plan;
+
+    if (! getAxisSum (params.centreY, params.centreYLow, params.height, plan.rowSum))
+        return plan;
+
+    if (plan.mirrorsColumns && ! getAxisSum (params.centreX, params.centreXLow, params.width, plan.columnSum))
+        return plan;
+
+    // Rows past the axis whose partner is inside the frame. Taking the ones
+    // below it always picks the smaller side, as the rest have no partner.
+    const int firstRow = static_cast<int> (std::floor (plan.rowSum / 2.0)) + 1;
+    const int endRow = std::min (plan.rowSum, params.height - 1) + 1;
+
+    int firstColumn = 0, endColumn = params.width;
+    if (plan.mirrorsColumns)
+    {
+        firstColumn = std::max (0, plan.columnSum - (params.width - 1));
+        endColumn = std::min (params.width - 1, plan.columnSum) + 1;
+    }
+
+    plan.mirrored = PixelArea { firstColumn, firstRow, endColumn - firstColumn, endRow - firstRow }
+                        .getIntersection ({ 0, 0, params.width, params.height });
+    return plan;
+}
+
+PixelArea mirrorArea (const SymmetryPlan& plan, IterationBuffer& iterations, const PixelArea& source) noexcept {
+    const auto target = plan.getMirrorOf (source);
+
+    for (int ptY = target.y; ptY < target.getBottom(); ptY++)
+    {
+        const int* sourceCounts = iterations.getCounts (plan.rowSum - ptY);
+        const float* sourceMagnitudes = iterations.getMagnitudes (plan.rowSum - ptY);
+        int* counts = iterations.getCounts (ptY);
+        float* magnitudes = iterations.getMagnitudes (ptY);
+
+        for (int ptX = target.x; ptX < target.getRight(); ptX++)
+        {
+            const int sourceX = plan.mirrorsColumns ? plan.columnSum - ptX : ptX;
+            counts[ptX] = sourceCounts[sourceX];
+            magnitudes[ptX] = sourceMagnitudes[sourceX];
+        }
+    }
+    return target;
+}
@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    Symmetry.h
+    Created: 21 Oct 2026 4:48:15pm
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <vector>
+#include "EscapeTime.h"
+#include "IterationBuffer.h"
+
+//==============================================================================
+struct PixelArea
+{
+    int x { 0 }, y { 0 }, width { 0 }, height { 0 };
+
+    int getRight() const noexcept   { return x + width; }
+    int getBottom() const noexcept  { return y + height; }
+    bool isEmpty() const noexcept   { return width <= 0 || height <= 0; }
+
+    bool contains (const int px, const int py) const noexcept
+    {
+        return px >= x && px < getRight() && py >= y && py < getBottom();
+    }
+
+    PixelArea getIntersection (const PixelArea& other) const noexcept;
+};
+
+//==============================================================================
+/*
+    The part of a frame that is a mirror image of another part. The Mandelbrot
+    set is symmetric about the real axis, c -> conj (c), and every Julia set
+    about the origin, z -> -z, because the loop runs the same sums with the
+    signs flipped. Rounding is symmetric too, so a mirrored pixel gets exactly
+    the count and magnitude of its source. Other formulas keep whichever of
+    the two their Formula says they have; the Burning Ship's Mandelbrot-style
+    frame has neither.
+
+    Pixel p sits at centre + (p - size / 2) * pixelSize, which only comes
+    out as the exact negative of its partner's when the centre is exactly
+    0. An axis that lands on the grid anywhere else, as after a pan by whole
+    pixels, gives partners that differ in the last bit and, now and then,
+    in their counts, so those frames aren't mirrored. The mirrored area is
+    the smaller side of the axis, so the frame iterates the larger side and
+    whatever has no partner inside the frame.
+*/
+struct SymmetryPlan
+{
+    // Pixels that copy another; empty when the frame has no symmetry to use
+    PixelArea mirrored;
+
+    // Pixel (x, y) of the mirrored area copies (columnSum - x, rowSum - y) of
+    // a Julia frame and (x, rowSum - y) of a Mandelbrot one
+    int rowSum { 0 }, columnSum { 0 };
+    bool mirrorsColumns { false };
+
+    bool isSymmetric() const noexcept   { return ! mirrored.isEmpty(); }
+
+    /*  The pixels whose source is in the given area; part of the mirrored
+        area, which can be empty.
+    */
+    PixelArea getMirrorOf (const PixelArea& area) const noexcept;
+
+    /*  What is left of an area once the mirrored pixels are taken out, as up
+        to four rectangles. These are the pixels a renderer has to iterate.
+    */
+    std::vector<PixelArea> getUniqueParts (const PixelArea& area) const;
+
+    // Pending orbits continue as mirror images of their source
+    IterationBuffer::PendingOrbit mirrorOrbit (const IterationBuffer::PendingOrbit& orbit) const noexcept;
+};
+
+// Works out which part of the frame, if any, mirrors another
+SymmetryPlan planSymmetry (const FractalParams& params) noexcept;
+
+/*  Copies the counts and magnitudes of the source area to the pixels that
+    mirror it, and returns the area that was written.
+*/
+PixelArea mirrorArea (const SymmetryPlan& plan, IterationBuffer& iterations, const PixelArea& source) noexcept;
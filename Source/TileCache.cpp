@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    TileCache.cpp
+    Created: 21 Oct 2026 10:02:37am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#include "TileCache.h"
+
+#include <functional>
+
+//==============================================================================
+bool TileCache::Key::operator== (const Key& other) const noexcept {
+    return type == other.type && formula == other.formula && cRe == other.cRe && cIm == other.cIm
+        && pixelSize == other.pixelSize && precision == other.precision
+        && anchor == other.anchor && minIterations == other.minIterations
+        && maxIterations == other.maxIterations && tileX == other.tileX && tileY == other.tileY;
+}
+
+size_t TileCache::KeyHash::operator() (const Key& key) const noexcept {
+    size_t hash = std::hash<int64_t>() (key.tileX);
+
+    auto combine = [&hash] (const size_t value) {
+        hash ^= value + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    };
+    combine (std::hash<int64_t>() (key.tileY));
+    combine (std::hash<double>() (key.pixelSize));
+    combine (std::hash<double>() (key.cRe));
+    combine (std::hash<double>() (key.cIm));
+    combine (static_cast<size_t> (key.formula.power) * 3 + static_cast<size_t> (key.formula.variant));
+    combine (static_cast<size_t> (key.anchor));
+    combine (static_cast<size_t> (key.maxIterations));
+    return hash;
+}
+
+TileCache::Key TileCache::makeKey (const FractalParams& params, const LatticePosition& position,
+                                   const int64_t tileX, const int64_t tileY) noexcept {
+    // The Mandelbrot set ignores c, so it mustn't split the cache
+    const bool isJulia = params.type == FractalType::julia;
+
+    return { params.type, params.formula, isJulia ? params.cRe : 0.0, isJulia ? params.cIm : 0.0,
+             params.pixelSize, params.precision, position.anchor,
+             params.minIterations, params.maxIterations, tileX, tileY };
+}
+
+void TileCache::setBudget (const size_t budgetBytes) {
+    const std::lock_guard<std::mutex> lock (m_lock);
+    m_budget = budgetBytes;
+    evict();
+}
+
+size_t TileCache::getBudget() const noexcept {
+    const std::lock_guard<std::mutex> lock (m_lock);
+    return m_budget;
+}
+
+std::shared_ptr<const IterationBuffer> TileCache::find (const Key& key) {
+    const std::lock_guard<std::mutex> lock (m_lock);
+
+    const auto found = m_index.find (key);
+    if (found == m_index.end())
+        return nullptr;
+
+    m_entries.splice (m_entries.begin(), m_entries, found->second);
+    return found->second->second;
+}
+
+void TileCache::store (const Key& key, std::shared_ptr<const IterationBuffer> tile) {
+    const std::lock_guard<std::mutex> lock (m_lock);
+
+    if (tile == nullptr || tile->getNumBytes() > m_budget)
+        return;
+
+    const auto found = m_index.find (key);
+    if (found != m_index.end())
+    {
+        m_numBytes -= found->second->second->getNumBytes();
+        m_entries.erase (found->second);
+        m_index.erase (found);
+    }
+
+    m_numBytes += tile->getNumBytes();
+    m_entries.emplace_front (key, std::move (tile));
+    m_index[key] = m_entries.begin();
+    evict();
+}
+
+void TileCache::clear() {
+    const std::lock_guard<std::mutex> lock (m_lock);
+    m_entries.clear();
+    m_index.clear();
+    m_numBytes = 0;
+}
+
+size_t TileCache::getNumBytes() const noexcept {
+    const std::lock_guard<std::mutex> lock (m_lock);
+    return m_numBytes;
+}
+
+int TileCache::getNumTiles() const noexcept {
+    const std::lock_guard<std::mutex> lock (m_lock);
+    return static_cast<int> (m_entries.size());
+}
+
+// Called with the lock held
+void TileCache::evict() {
+    while (m_numBytes > m_budget && ! m_entries.empty())
+    {
+        const auto& oldest = m_entries.back();
+        m_numBytes -= oldest.second->getNumBytes();
+        m_index.erase (oldest.first);
+        m_entries.pop_back();
+    }
+}
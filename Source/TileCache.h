@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    TileCache.h
+    Created: 21 Oct 2026 10:02:37am
+    Author:  Thomas Boggs
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "EscapeTime.h"
+#include "IterationBuffer.h"
+
+//==============================================================================
+/*
+    Where image pixel (0, 0) of a frame sits on its owner's pixel lattice.
+    Frames with the same anchor and pixel size put the same maths point at the
+    same lattice pixel, so tiles aligned to the lattice can be shared between
+    them. A negative anchor means the frame isn't on a lattice.
+*/
+struct LatticePosition
+{
+    int anchor { -1 };
+    int64_t x { 0 }, y { 0 };
+};
+
+//==============================================================================
+/*
+    Finished tiles kept by where they are in the fractal rather than in a
+    frame, so panning only iterates the tiles that come into view and going
+    back to an earlier zoom level costs nothing at all.
+
+    Each tile is an IterationBuffer of its own, in coordinates relative to
+    the tile's top-left pixel and with its pending orbits, so a frame that
+    reuses it can still be deepened. Once the tiles take more than the
+    budget, the least recently used ones go. Every call is thread safe.
+*/
+class TileCache
+{
+public:
+    struct Key
+    {
+        FractalType type;
+        Formula formula;
+        double cRe, cIm;
+        double pixelSize;
+        Precision precision;
+        int anchor;
+        int minIterations, maxIterations;
+        int64_t tileX, tileY;
+
+        bool operator== (const Key& other) const noexcept;
+    };
+
+    // Identifies the tile at (tileX, tileY) of the lattice params and position are on
+    static Key makeKey (const FractalParams& params, const LatticePosition& position,
+                        const int64_t tileX, const int64_t tileY) noexcept;
+
+    explicit TileCache (const size_t budgetBytes = 0) : m_budget (budgetBytes) {}
+
+    // 0 turns the cache off
+    void setBudget (const size_t budgetBytes);
+    size_t getBudget() const noexcept;
+    bool isEnabled() const noexcept     { return getBudget() > 0; }
+
+    // Null if the tile isn't cached; a hit counts as a use
+    std::shared_ptr<const IterationBuffer> find (const Key& key);
+    void store (const Key& key, std::shared_ptr<const IterationBuffer> tile);
+    void clear();
+
+    size_t getNumBytes() const noexcept;
+    int getNumTiles() const noexcept;
+
+private:
+    struct KeyHash
+    {
+        size_t operator() (const Key& key) const noexcept;
+    };
+
+    using Entry = std::pair<Key, std::shared_ptr<const IterationBuffer>>;
+
+    void evict();
+
+    mutable std::mutex m_lock;
+    size_t m_budget;
+    size_t m_numBytes { 0 };
+
+    // Most recently used first
+    std::list<Entry> m_entries;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> m_index;
+};